@@ -0,0 +1,245 @@
+#include "./benchmark.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string_view>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+auto time_batch(void* op,
+                auto (*batch)(void*, std::size_t)->void,
+                std::size_t iterations) -> std::chrono::nanoseconds
+{
+    auto const start = Clock::now();
+    batch(op, iterations);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now()
+                                                                - start);
+}
+
+auto usage(char const* program) -> void
+{
+    std::cerr << "Usage: " << program
+              << " [--filter <substring>] [--repetitions <n>]"
+                 " [--warmup <n>] [--min-time-ms <n>] [--json <path>]\n";
+}
+
+auto parse_count(std::string_view value, std::size_t& out) -> bool
+{
+    std::size_t n = 0;
+    if (value.empty())
+        return false;
+
+    for (auto c : value) {
+        if (c < '0' || c > '9')
+            return false;
+
+        n = n * 10 + static_cast<std::size_t>(c - '0');
+    }
+
+    out = n;
+    return true;
+}
+
+auto json_string(std::ostream& os, std::string const& value) -> void
+{
+    os << '"';
+    for (auto c : value) {
+        if (c == '"' || c == '\\')
+            os << '\\';
+        os << c;
+    }
+    os << '"';
+}
+
+} // namespace
+
+namespace rgbctl::benchmarking
+{
+
+Runner::Runner(Options options)
+    : options_ { std::move(options) }
+{ }
+
+auto Runner::results() const noexcept -> std::span<Result const>
+{
+    return results_;
+}
+
+auto Runner::selected(std::string const& name) const noexcept -> bool
+{
+    return name.find(options_.filter) != std::string::npos;
+}
+
+auto Runner::measure(std::string const& name, void* op, Batch batch) -> void
+{
+    /* Grow the batch until a single one takes at least `min_time`...
+     */
+    std::size_t iterations = 1;
+    while (true) {
+        auto const elapsed = time_batch(op, batch, iterations);
+        if (elapsed >= options_.min_time || iterations >= (1u << 30))
+            break;
+
+        auto const scale
+            = elapsed.count() > 0
+                  ? static_cast<double>(options_.min_time.count())
+                        / static_cast<double>(elapsed.count()) * 1.2
+                  : 10.0;
+        iterations = static_cast<std::size_t>(
+            static_cast<double>(iterations) * std::clamp(scale, 2.0, 10.0));
+    }
+
+    for (std::size_t n = 0; n < options_.warmup; ++n)
+        time_batch(op, batch, iterations);
+
+    auto const repetitions = std::max(options_.repetitions, std::size_t { 1 });
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+    for (std::size_t n = 0; n < repetitions; ++n)
+        samples.push_back(
+            static_cast<double>(time_batch(op, batch, iterations).count())
+            / static_cast<double>(iterations));
+
+    std::sort(samples.begin(), samples.end());
+
+    auto const count = static_cast<double>(samples.size());
+    auto const mean
+        = std::accumulate(samples.begin(), samples.end(), 0.0) / count;
+    auto const variance = std::accumulate(samples.begin(),
+                                          samples.end(),
+                                          0.0,
+                                          [&](auto acc, auto sample) {
+                                              return acc
+                                                     + (sample - mean)
+                                                           * (sample - mean);
+                                          })
+                          / count;
+
+    auto const middle = samples.size() / 2;
+    auto const median = samples.size() % 2
+                            ? samples[middle]
+                            : (samples[middle - 1] + samples[middle]) / 2;
+
+    results_.push_back({ .name = name,
+                         .iterations = iterations,
+                         .repetitions = repetitions,
+                         .min = samples.front(),
+                         .median = median,
+                         .mean = mean,
+                         .stddev = std::sqrt(variance),
+                         .max = samples.back() });
+
+    write_table(std::cerr, std::span { results_ }.last(1));
+}
+
+auto write_table(std::ostream& os, std::span<Result const> results) -> void
+{
+    auto const flags = os.flags();
+    auto const precision = os.precision();
+    auto const fill = os.fill(' ');
+
+    os << std::fixed << std::setprecision(1);
+    for (auto const& result : results)
+        os << std::left << std::setw(40) << result.name << std::right
+           << " median " << std::setw(12) << result.median << " ns"
+           << "  min " << std::setw(12) << result.min << " ns"
+           << "  stddev " << std::setw(10) << result.stddev << " ns\n";
+
+    os.flags(flags);
+    os.precision(precision);
+    os.fill(fill);
+}
+
+auto write_json(std::ostream& os, std::span<Result const> results) -> void
+{
+    auto const flags = os.flags();
+    auto const precision = os.precision();
+
+    os << std::fixed << std::setprecision(3) << "{\"benchmarks\":[";
+
+    auto first = true;
+    for (auto const& result : results) {
+        os << (first ? "\n" : ",\n") << "{\"name\":";
+        json_string(os, result.name);
+        os << ",\"iterations\":" << result.iterations
+           << ",\"repetitions\":" << result.repetitions
+           << ",\"unit\":\"ns\",\"min\":" << result.min
+           << ",\"median\":" << result.median << ",\"mean\":" << result.mean
+           << ",\"stddev\":" << result.stddev << ",\"max\":" << result.max
+           << '}';
+        first = false;
+    }
+
+    os << "\n]}\n";
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+auto run(int argc,
+         char const** argv,
+         std::initializer_list<Benchmark> benchmarks) -> int
+{
+    Options options;
+    char const* json_path = nullptr;
+
+    for (auto n = 1; n < argc; ++n) {
+        std::string_view const arg = argv[n];
+        if (n + 1 == argc) {
+            usage(argv[0]);
+            return 1;
+        }
+
+        std::string_view const value = argv[++n];
+        std::size_t min_time_ms = 0;
+        if (arg == "--filter")
+            options.filter = value;
+        else if (arg == "--json")
+            json_path = value.data();
+        else if (arg == "--repetitions"
+                 && parse_count(value, options.repetitions))
+            ;
+        else if (arg == "--warmup" && parse_count(value, options.warmup))
+            ;
+        else if (arg == "--min-time-ms" && parse_count(value, min_time_ms))
+            options.min_time = std::chrono::milliseconds { min_time_ms };
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    Runner runner { std::move(options) };
+    for (auto const& benchmark : benchmarks) {
+        try {
+            std::get<1>(benchmark)(runner);
+        }
+        catch (std::exception const& e) {
+            std::cerr << std::get<0>(benchmark) << " failed: " << e.what()
+                      << '\n';
+            return 1;
+        }
+    }
+
+    if (!json_path) {
+        write_json(std::cout, runner.results());
+        return 0;
+    }
+
+    std::ofstream json { json_path };
+    write_json(json, runner.results());
+    if (!json) {
+        std::cerr << "Couldn't write " << json_path << '\n';
+        return 1;
+    }
+
+    return 0;
+}
+
+} // namespace rgbctl::benchmarking
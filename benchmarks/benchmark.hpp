@@ -0,0 +1,107 @@
+#ifndef RGBCTL_BENCHMARK_HPP_INCLUDED
+#define RGBCTL_BENCHMARK_HPP_INCLUDED
+
+#include <chrono>
+#include <cstddef>
+#include <initializer_list>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#define BENCHMARK_STRINGIFY_IMPL(x) #x
+#define BENCHMARK_STRINGIFY(x)      BENCHMARK_STRINGIFY_IMPL(x)
+#define BENCHMARK(fn)               std::make_pair(BENCHMARK_STRINGIFY(fn), fn)
+
+namespace rgbctl::benchmarking
+{
+
+/* Keeps the compiler from discarding a computation whose result is
+ * otherwise unused...
+ */
+template <typename T>
+inline auto do_not_optimize(T const& value) noexcept -> void
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Options
+{
+    /* Only benchmarks whose names contain this are run...
+     */
+    std::string filter;
+    std::size_t warmup = 2;
+    std::size_t repetitions = 10;
+
+    /* How long each repetition should take. An operation is repeated
+     * as many times as it takes to fill this, so that the clock's
+     * resolution doesn't swamp fast operations...
+     */
+    std::chrono::nanoseconds min_time = std::chrono::milliseconds { 10 };
+};
+
+/* Times are nanoseconds per operation, over the repetitions.
+ */
+struct Result
+{
+    std::string name;
+    std::size_t iterations;
+    std::size_t repetitions;
+    double min;
+    double median;
+    double mean;
+    double stddev;
+    double max;
+};
+
+struct Runner
+{
+    explicit Runner(Options options);
+
+    /* Times `op`, which should perform one operation and be cheap to
+     * call repeatedly. Any per-operation setup it does is timed too...
+     */
+    template <typename Op>
+    auto run(std::string const& name, Op&& op) -> void
+    {
+        if (selected(name))
+            measure(name, &op, &run_batch<std::remove_reference_t<Op>>);
+    }
+
+    auto results() const noexcept -> std::span<Result const>;
+
+private:
+    using Batch = auto (*)(void*, std::size_t) -> void;
+
+    template <typename Op>
+    static auto run_batch(void* op, std::size_t iterations) -> void
+    {
+        for (std::size_t n = 0; n < iterations; ++n)
+            (*reinterpret_cast<Op*>(op))();
+    }
+
+    auto selected(std::string const& name) const noexcept -> bool;
+    auto measure(std::string const& name, void* op, Batch batch) -> void;
+
+    Options options_;
+    std::vector<Result> results_;
+};
+
+using BenchmarkFunction = auto (*)(Runner&) -> void;
+using Benchmark = std::pair<char const*, BenchmarkFunction>;
+
+auto write_table(std::ostream&, std::span<Result const>) -> void;
+auto write_json(std::ostream&, std::span<Result const>) -> void;
+
+/* Runs each benchmark, printing a table of the results to stderr and
+ * the results as JSON to stdout, or to the file named by `--json`. See
+ * `usage()` in benchmark.cpp for the other arguments...
+ */
+auto run(int argc, char const** argv, std::initializer_list<Benchmark>)
+    -> int;
+
+} // namespace rgbctl::benchmarking
+
+#endif // RGBCTL_BENCHMARK_HPP_INCLUDED
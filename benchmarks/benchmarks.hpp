@@ -0,0 +1,22 @@
+#ifndef RGBCTL_BENCHMARKS_HPP_INCLUDED
+#define RGBCTL_BENCHMARKS_HPP_INCLUDED
+
+#include "./benchmark.hpp"
+
+namespace rgbctl::benchmarks
+{
+
+auto texture_sampling(benchmarking::Runner&) -> void;
+auto effect_ticks(benchmarking::Runner&) -> void;
+auto hex_parsing(benchmarking::Runner&) -> void;
+auto checksums(benchmarking::Runner&) -> void;
+auto output_stages(benchmarking::Runner&) -> void;
+auto colour_spaces(benchmarking::Runner&) -> void;
+auto resamplers(benchmarking::Runner&) -> void;
+auto driver_reports(benchmarking::Runner&) -> void;
+auto controller_ticks(benchmarking::Runner&) -> void;
+auto device_farm(benchmarking::Runner&) -> void;
+
+} // namespace rgbctl::benchmarks
+
+#endif // RGBCTL_BENCHMARKS_HPP_INCLUDED
@@ -0,0 +1,207 @@
+#include "../src/builtin_modules.hpp"
+#include "../src/builtins/builtins.hpp"
+#include "../tests/mock_read_write_stream.hpp"
+#include "../tests/silence_stderr.hpp"
+#include "./benchmarks.hpp"
+#include "rgbctl/rgbctl.hpp"
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace rgbctl::modules::builtin;
+using rgbctl::benchmarking::do_not_optimize;
+
+/* Every Corsair report is answered with a response, which these stand
+ * in for. Their contents don't matter...
+ */
+std::array<unsigned char, 3 * sizeof(corsair::Response)> const
+    kCorsairResponses {};
+
+auto asus_acquisition_responses() -> std::vector<unsigned char>
+{
+    asus::ConfigData config {};
+    config.channel_count = 1;
+    config.led_count = 4;
+    config.rgb_header_count = 1;
+
+    asus::FirmwareData firmware {};
+    std::strcpy(firmware.firmware_string.data(), "AULA3-AR32-0207");
+
+    auto const config_report
+        = asus::make_report(asus::kAsusAuraConfigReportId, config);
+    auto const firmware_report
+        = asus::make_report(asus::kAsusAuraFirmwareReportId, firmware);
+
+    std::vector<unsigned char> responses(sizeof(config_report)
+                                         + sizeof(firmware_report));
+    std::memcpy(responses.data(), &config_report, sizeof(config_report));
+    std::memcpy(responses.data() + sizeof(config_report),
+                &firmware_report,
+                sizeof(firmware_report));
+
+    return responses;
+}
+
+auto rgbs(std::size_t count) -> std::vector<rgbctl_rgb_value>
+{
+    std::vector<rgbctl_rgb_value> values(count);
+    for (std::size_t n = 0; n < count; ++n)
+        values[n] = { static_cast<std::uint8_t>(n * 16),
+                      static_cast<std::uint8_t>(255 - n * 16),
+                      0x80 };
+
+    return values;
+}
+
+auto constexpr kPalette = std::to_array<rgbctl::RgbFloat>(
+    { rgbctl::hex_string_to_rgb_float("070050"),
+      rgbctl::hex_string_to_rgb_float("3f00ff") });
+
+template <typename Driver>
+auto acquire(Driver& driver, std::span<unsigned char const> responses) -> void
+{
+    std::vector<unsigned char> requests(4 * asus::kAsusAuraReportSize);
+    rgbctl::DeviceContext ctx { MockReadWriteStream { responses, requests } };
+
+    SilenceStderr silence;
+    if (driver.on_acquire(&ctx) != RGBCTL_SUCCESS)
+        throw std::runtime_error { "acquire" };
+}
+
+template <typename ReadWriteStream>
+auto acquire_module(rgbctl::DeviceContext<ReadWriteStream>& ctx,
+                    rgbctl_product_id id) -> rgbctl::Module
+{
+    rgbctl_module_registration registration {};
+    rgbctl::modules::init(&registration);
+
+    SilenceStderr silence;
+    return rgbctl::acquire_module(ctx, id, registration.acquire_callback);
+}
+
+/* Ticks a controller as the main loop would. Each frame is written to
+ * a fresh mock stream, which otherwise fills up...
+ */
+auto controller_tick(rgbctl::benchmarking::Runner& runner,
+                     std::string const& name,
+                     rgbctl_product_id id,
+                     std::uint32_t zone_index,
+                     std::span<unsigned char const> acquisition_responses,
+                     std::span<unsigned char const> frame_responses) -> void
+{
+    std::vector<unsigned char> requests(4 * asus::kAsusAuraReportSize);
+    rgbctl::DeviceContext ctx { MockReadWriteStream { acquisition_responses,
+                                                      requests } };
+    auto mod = acquire_module(ctx, id);
+
+    rgbctl::Controller<MockReadWriteStream, rgbctl::AnyEffect> controller {
+        std::move(mod),
+        std::move(ctx),
+        rgbctl::AnyEffect { rgbctl::effects::Rotate { zone_index,
+                                                      5000,
+                                                      kPalette } }
+    };
+
+    runner.run(name, [&] {
+        controller.device_context().stream()
+            = MockReadWriteStream { frame_responses, requests };
+        controller.tick(33);
+        do_not_optimize(requests.data());
+    });
+}
+
+/* Half Corsair and half Asus, as fast as the CPU allows...
+ */
+auto simulated_controllers(std::size_t count)
+    -> std::vector<rgbctl::AnyController>
+{
+    std::vector<rgbctl::AnyController> controllers;
+    for (std::size_t n = 0; n < count; ++n) {
+        auto const corsair = n % 2 == 0;
+        rgbctl::DeviceContext ctx { rgbctl::SimulatedDeviceStream {
+            corsair ? rgbctl::SimulatedProtocol::CorsairH100iProXt
+                    : rgbctl::SimulatedProtocol::AsusX570 } };
+
+        auto const id = corsair ? corsair::CorsairH100iProXt::product_id
+                                : asus::AsusX570::product_id;
+        auto mod = acquire_module(ctx, id);
+        rgbctl::effects::Rotate effect { corsair ? 1u : 0u, 5000, kPalette };
+
+        controllers.emplace_back(
+            rgbctl::Controller<rgbctl::SimulatedDeviceStream,
+                               rgbctl::effects::Rotate> {
+                std::move(mod), std::move(ctx), std::move(effect) });
+    }
+
+    return controllers;
+}
+
+} // namespace
+
+namespace rgbctl::benchmarks
+{
+
+auto driver_reports(benchmarking::Runner& runner) -> void
+{
+    std::array<unsigned char, asus::kAsusAuraReportSize> request;
+    auto const values = rgbs(12);
+
+    corsair::CorsairH100iProXt corsair;
+    acquire(corsair, kCorsairResponses);
+
+    runner.run("corsair.on_rgb_data/ring", [&] {
+        DeviceContext ctx { MockReadWriteStream {
+            std::span { kCorsairResponses }.first(sizeof(corsair::Response)),
+            request } };
+        do_not_optimize(corsair.on_rgb_data(&ctx, 1, values.data(), 12));
+        do_not_optimize(request.data());
+    });
+
+    auto const asus_responses = asus_acquisition_responses();
+    asus::AsusX570 asus;
+    acquire(asus, asus_responses);
+
+    runner.run("asus.on_rgb_data/mainboard", [&] {
+        DeviceContext ctx { MockReadWriteStream { {}, request } };
+        do_not_optimize(asus.on_rgb_data(&ctx, 0, values.data(), 4));
+        do_not_optimize(request.data());
+    });
+}
+
+auto controller_ticks(benchmarking::Runner& runner) -> void
+{
+    controller_tick(runner,
+                    "controller.tick/corsair",
+                    corsair::CorsairH100iProXt::product_id,
+                    1,
+                    kCorsairResponses,
+                    std::span { kCorsairResponses }.first(
+                        sizeof(corsair::Response)));
+
+    controller_tick(runner,
+                    "controller.tick/asus",
+                    asus::AsusX570::product_id,
+                    0,
+                    asus_acquisition_responses(),
+                    {});
+}
+
+/* A frame of the whole pipeline, over a farm of simulated devices...
+ */
+auto device_farm(benchmarking::Runner& runner) -> void
+{
+    for (auto count : { 1u, 16u, 256u }) {
+        auto controllers = simulated_controllers(count);
+        runner.run("farm.frame/" + std::to_string(count), [&] {
+            for (auto& controller : controllers)
+                controller.tick(33);
+        });
+    }
+}
+
+} // namespace rgbctl::benchmarks
@@ -0,0 +1,69 @@
+#include "./benchmarks.hpp"
+#include "rgbctl/rgbctl.hpp"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using rgbctl::benchmarking::do_not_optimize;
+
+auto constexpr kPalette = std::to_array<rgbctl::RgbFloat>(
+    { rgbctl::hex_string_to_rgb_float("000000"),
+      rgbctl::hex_string_to_rgb_float("070050"),
+      rgbctl::hex_string_to_rgb_float("3f00ff"),
+      rgbctl::hex_string_to_rgb_float("ff8000") });
+
+template <typename Effect>
+auto tick(rgbctl::benchmarking::Runner& runner,
+          std::string const& name,
+          Effect effect,
+          std::size_t led_count) -> void
+{
+    std::vector<rgbctl::RgbFloat> frame(led_count);
+    runner.run(name + "/" + std::to_string(led_count), [&] {
+        do_not_optimize(effect.tick(33, frame));
+        do_not_optimize(frame.data());
+    });
+}
+
+} // namespace
+
+namespace rgbctl::benchmarks
+{
+
+auto effect_ticks(benchmarking::Runner& runner) -> void
+{
+    /* `Linear` steps through the rows of its texture, one frame of
+     * `rgb_count` LEDs per row...
+     */
+    std::vector<RgbFloat> frames;
+    for (std::size_t n = 0; n < 64; ++n)
+        frames.push_back(kPalette[n % kPalette.size()]);
+
+    for (auto led_count : { 4u, 16u, 64u, 256u }) {
+        tick(runner,
+             "effect.rotate",
+             effects::Rotate { 0, 5000, kPalette },
+             led_count);
+        tick(runner,
+             "effect.linear",
+             effects::Linear { 0, kPalette.size(), 5000, frames },
+             led_count);
+        tick(runner,
+             "effect.rotate_fixed",
+             effects::Rotate { 0, 5000, kPalette, TexturePrecision::Fixed },
+             led_count);
+        tick(runner,
+             "effect.rotate_oklab",
+             effects::Rotate { 0,
+                               5000,
+                               kPalette,
+                               TexturePrecision::Float,
+                               ColourSpace::Oklab },
+             led_count);
+    }
+}
+
+} // namespace rgbctl::benchmarks
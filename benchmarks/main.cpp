@@ -0,0 +1,21 @@
+#include "./benchmarks.hpp"
+
+auto main(int argc, char const** argv) -> int
+{
+    using namespace rgbctl::benchmarks;
+
+    return rgbctl::benchmarking::run(argc,
+                                     argv,
+                                     {
+                                         BENCHMARK(texture_sampling),
+                                         BENCHMARK(effect_ticks),
+                                         BENCHMARK(hex_parsing),
+                                         BENCHMARK(checksums),
+                                         BENCHMARK(output_stages),
+                                         BENCHMARK(colour_spaces),
+                                         BENCHMARK(resamplers),
+                                         BENCHMARK(driver_reports),
+                                         BENCHMARK(controller_ticks),
+                                         BENCHMARK(device_farm),
+                                     });
+}
@@ -0,0 +1,151 @@
+#include "../src/builtins/corsair/corsair_utils.hpp"
+#include "./benchmarks.hpp"
+#include "rgbctl/rgbctl.hpp"
+#include <algorithm>
+#include <array>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+using rgbctl::benchmarking::do_not_optimize;
+
+} // namespace
+
+namespace rgbctl::benchmarks
+{
+
+auto hex_parsing(benchmarking::Runner& runner) -> void
+{
+    std::array<std::string_view, 4> constexpr kColours {
+        "000000", "070050", "3f00ff", "FF8000"
+    };
+
+    std::size_t next = 0;
+    runner.run("rgb.hex_string_to_rgb_float", [&] {
+        RgbFloat rgb;
+        do_not_optimize(
+            hex_string_to_rgb_float(kColours[next++ % kColours.size()], rgb));
+        do_not_optimize(rgb);
+    });
+}
+
+/* A Corsair report checksums the 62 bytes between its report number
+ * and the checksum itself...
+ */
+auto checksums(benchmarking::Runner& runner) -> void
+{
+    using modules::builtin::corsair::compute_checksum;
+
+    for (auto size : { 62u, 1024u }) {
+        std::vector<std::uint8_t> data(size);
+        for (std::size_t n = 0; n < data.size(); ++n)
+            data[n] = static_cast<std::uint8_t>(n * 31);
+
+        runner.run("corsair.checksum/" + std::to_string(size), [&] {
+            do_not_optimize(data.data());
+            do_not_optimize(compute_checksum(data.begin(), data.end()));
+        });
+    }
+}
+
+/* A whole zone, with the gamma and channel order of a typical device,
+ * dithered and rounded, against converting it with `to_rgb_uint8`...
+ */
+auto output_stages(benchmarking::Runner& runner) -> void
+{
+    for (auto led_count : { 16u, 256u }) {
+        std::vector<RgbFloat> colours(led_count);
+        for (std::size_t n = 0; n < colours.size(); ++n) {
+            auto const v
+                = static_cast<float>(n) / static_cast<float>(led_count);
+            colours[n] = { v, 1.f - v, .5f };
+        }
+
+        std::vector<rgbctl_rgb_value> out(led_count);
+        auto const suffix = "/" + std::to_string(led_count);
+        for (auto dither : { true, false }) {
+            OutputStage stage { { .gamma = 2.2f,
+                                  .brightness = .8f,
+                                  .dither = dither },
+                                RGBCTL_CHANNEL_ORDER_BGR };
+
+            auto const name = dither ? "output.apply" : "output.apply_rounded";
+            runner.run(name + suffix, [&] {
+                do_not_optimize(colours.data());
+                do_not_optimize(stage.apply(colours, out));
+                do_not_optimize(out.data());
+            });
+        }
+
+        runner.run("output.to_rgb_uint8" + suffix, [&] {
+            do_not_optimize(colours.data());
+            std::transform(
+                colours.begin(), colours.end(), out.begin(), to_rgb_uint8);
+            do_not_optimize(out.data());
+        });
+    }
+}
+
+/* Converting a whole zone's samples back to sRGB, as an effect does
+ * each frame when its texture isn't sRGB. Each run starts from a copy,
+ * which is included...
+ */
+auto colour_spaces(benchmarking::Runner& runner) -> void
+{
+    for (auto led_count : { 16u, 256u }) {
+        std::vector<RgbFloat> colours(led_count);
+        for (std::size_t n = 0; n < colours.size(); ++n) {
+            auto const v
+                = static_cast<float>(n) / static_cast<float>(led_count);
+            colours[n] = { v, 1.f - v, .5f };
+        }
+
+        auto const suffix = "/" + std::to_string(led_count);
+        for (auto space : { ColourSpace::LinearRgb, ColourSpace::Oklab }) {
+            auto samples = colours;
+            from_srgb(space, samples);
+            auto out = samples;
+
+            auto const name = space == ColourSpace::Oklab
+                                  ? "colour.to_srgb_oklab"
+                                  : "colour.to_srgb_linear";
+            runner.run(name + suffix, [&] {
+                std::copy(samples.begin(), samples.end(), out.begin());
+                to_srgb(space, out);
+                do_not_optimize(out.data());
+            });
+        }
+    }
+}
+
+/* One rendered frame, stretched or shrunk to zones of typical sizes...
+ */
+auto resamplers(benchmarking::Runner& runner) -> void
+{
+    std::vector<RgbFloat> frame(120);
+    for (std::size_t n = 0; n < frame.size(); ++n) {
+        auto const v = static_cast<float>(n) / static_cast<float>(frame.size());
+        frame[n] = { v, 1.f - v, .5f };
+    }
+
+    for (auto target_size : { 4u, 16u, 256u }) {
+        std::vector<RgbFloat> out(target_size);
+        for (auto [resampling, name] :
+             { std::pair { Resampling::Nearest, "resample.nearest" },
+               std::pair { Resampling::Linear, "resample.linear" },
+               std::pair { Resampling::Area, "resample.area" } }) {
+            Resampler const resampler { frame.size(), target_size, resampling };
+            runner.run(name + ("/120to" + std::to_string(target_size)), [&] {
+                do_not_optimize(frame.data());
+                do_not_optimize(resampler.apply(frame, out));
+                do_not_optimize(out.data());
+            });
+        }
+    }
+}
+
+} // namespace rgbctl::benchmarks
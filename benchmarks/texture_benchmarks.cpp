@@ -0,0 +1,185 @@
+#include "./benchmarks.hpp"
+#include "rgbctl/rgbctl.hpp"
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+using rgbctl::benchmarking::do_not_optimize;
+
+auto gradient(std::size_t count) -> std::vector<rgbctl::RgbFloat>
+{
+    std::vector<rgbctl::RgbFloat> texels;
+    texels.reserve(count);
+    for (std::size_t n = 0; n < count; ++n) {
+        auto const t = static_cast<float>(n) / static_cast<float>(count);
+        texels.push_back({ t, 1.f - t, t * t });
+    }
+
+    return texels;
+}
+
+/* Walks the sample point across (and off) the texture, so that every
+ * sample is different and wrapping is exercised...
+ */
+template <typename Filtering>
+auto sample(rgbctl::benchmarking::Runner& runner,
+            std::string const& name,
+            std::size_t width,
+            std::size_t height,
+            Filtering filtering,
+            rgbctl::Addressing addressing = rgbctl::Addressing::Wrap) -> void
+{
+    auto const texels = gradient(width * height);
+    rgbctl::Texture const texture { texels,
+                                    width,
+                                    rgbctl::ColourSpace::Srgb,
+                                    rgbctl::Mipmaps::None,
+                                    addressing };
+
+    rgbctl::Vec<float, 2> uv { 0.f, 0.f };
+    runner.run(name, [&] {
+        uv[0] += 0.0137f;
+        uv[1] += 0.0071f;
+        if (uv[0] > 4.f)
+            uv = { -4.f, -4.f };
+
+        do_not_optimize(texture.sample(uv, filtering));
+    });
+}
+
+/* As `sample`, with the texels mapped from an 8 bit texture file...
+ */
+template <typename Filtering>
+auto sample_mapped(rgbctl::benchmarking::Runner& runner,
+                   std::string const& name,
+                   std::size_t width,
+                   std::size_t height,
+                   Filtering filtering) -> void
+{
+    auto const path = std::filesystem::temp_directory_path()
+                      / ("rgbctl_benchmarks.texture."
+                         + std::to_string(getpid()));
+    rgbctl::write_texture_file(
+        path, gradient(width * height), width, rgbctl::TexelFormat::Uint8);
+    rgbctl::Texture const texture {
+        std::make_shared<rgbctl::TextureFile const>(path)
+    };
+    std::filesystem::remove(path);
+
+    rgbctl::Vec<float, 2> uv { 0.f, 0.f };
+    runner.run(name, [&] {
+        uv[0] += 0.0137f;
+        uv[1] += 0.0071f;
+        if (uv[0] > 4.f)
+            uv = { -4.f, -4.f };
+
+        do_not_optimize(texture.sample(uv, filtering));
+    });
+}
+
+/* As `sample`, through the fixed point texture. The steps are the same,
+ * in Q16.16...
+ */
+template <typename Filtering>
+auto sample_fixed(rgbctl::benchmarking::Runner& runner,
+                  std::string const& name,
+                  std::size_t width,
+                  std::size_t height,
+                  Filtering filtering) -> void
+{
+    auto const texels = gradient(width * height);
+    rgbctl::FixedTexture const texture { texels, width };
+
+    rgbctl::FixedCoord uv { 0u, 0u };
+    runner.run(name, [&] {
+        uv[0] += 898;
+        uv[1] += 465;
+
+        do_not_optimize(texture.sample(uv, filtering));
+    });
+}
+
+} // namespace
+
+namespace rgbctl::benchmarks
+{
+
+auto texture_sampling(benchmarking::Runner& runner) -> void
+{
+    for (auto width : { 4u, 64u, 1024u }) {
+        auto const size = std::to_string(width) + "x1";
+        sample(runner,
+               "texture.nearest/" + size,
+               width,
+               1,
+               texture_filtering_nearest);
+        sample(runner,
+               "texture.linear/" + size,
+               width,
+               1,
+               texture_filtering_linear);
+        sample_fixed(runner,
+                     "texture.fixed_nearest/" + size,
+                     width,
+                     1,
+                     texture_filtering_nearest);
+        sample_fixed(runner,
+                     "texture.fixed_linear/" + size,
+                     width,
+                     1,
+                     texture_filtering_linear);
+    }
+
+    /* Wrapping a texture that isn't a power of two wide can't mask, and
+     * the other modes clamp...
+     */
+    sample(runner, "texture.linear/60x1", 60, 1, texture_filtering_linear);
+    sample(runner,
+           "texture.linear_clamp/64x1",
+           64,
+           1,
+           texture_filtering_linear,
+           Addressing::Clamp);
+    sample(runner,
+           "texture.linear_mirror/64x1",
+           64,
+           1,
+           texture_filtering_linear,
+           Addressing::Mirror);
+
+    for (auto width : { 16u, 256u }) {
+        auto const size = std::to_string(width) + "x" + std::to_string(width);
+        sample(runner,
+               "texture.nearest/" + size,
+               width,
+               width,
+               texture_filtering_nearest);
+        sample(runner,
+               "texture.linear/" + size,
+               width,
+               width,
+               texture_filtering_linear);
+        sample_fixed(runner,
+                     "texture.fixed_nearest/" + size,
+                     width,
+                     width,
+                     texture_filtering_nearest);
+        sample_fixed(runner,
+                     "texture.fixed_linear/" + size,
+                     width,
+                     width,
+                     texture_filtering_linear);
+        sample_mapped(runner,
+                      "texture.mapped_uint8_linear/" + size,
+                      width,
+                      width,
+                      texture_filtering_linear);
+    }
+}
+
+} // namespace rgbctl::benchmarks
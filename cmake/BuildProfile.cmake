@@ -0,0 +1,93 @@
+# Compiler and linker flags for every target, selected by
+# RGBCTL_BUILD_PROFILE:
+#
+#   debug-asan    Debug info and AddressSanitizer. The default
+#   release       -O3 and link-time optimisation
+#   pgo-generate  `release`, instrumented to record a profile into
+#                 RGBCTL_PGO_DIR. Build and run `rgbctl_pgo_training`
+#                 to record one
+#   pgo-use       `release`, optimised with the profile in RGBCTL_PGO_DIR
+#
+# GCC finds a profile by the path of the object it was recorded from, so
+# `pgo-generate` and `pgo-use` must share a build directory.
+
+set(RGBCTL_BUILD_PROFILES debug-asan release pgo-generate pgo-use)
+
+set(
+    RGBCTL_BUILD_PROFILE
+    debug-asan
+    CACHE STRING
+    "Build profile for ${PROJECT_NAME}: ${RGBCTL_BUILD_PROFILES}"
+)
+set_property(
+    CACHE RGBCTL_BUILD_PROFILE
+    PROPERTY STRINGS ${RGBCTL_BUILD_PROFILES}
+)
+
+set(
+    RGBCTL_PGO_DIR
+    "${CMAKE_BINARY_DIR}/pgo"
+    CACHE PATH
+    "Where the pgo-generate profile writes, and pgo-use reads, profile data"
+)
+
+if(NOT RGBCTL_BUILD_PROFILE IN_LIST RGBCTL_BUILD_PROFILES)
+    message(
+        FATAL_ERROR
+        "Unknown RGBCTL_BUILD_PROFILE '${RGBCTL_BUILD_PROFILE}'. "
+        "Expected one of: ${RGBCTL_BUILD_PROFILES}"
+    )
+endif()
+
+# Warnings are errors in the project's own targets. With link-time
+# optimisation some are only found when linking, so they're link
+# options there too
+function(rgbctl_warnings_as_errors)
+    set(warnings -Wall -Werror -Wextra -Wconversion -Wpedantic)
+    add_compile_options(${warnings})
+    if(CMAKE_INTERPROCEDURAL_OPTIMIZATION)
+        add_link_options(${warnings})
+    endif()
+endfunction()
+
+if(RGBCTL_BUILD_PROFILE STREQUAL "debug-asan")
+    add_compile_options(-g -fsanitize=address -fno-omit-frame-pointer)
+    add_link_options(-fsanitize=address)
+    return()
+endif()
+
+include(CheckIPOSupported)
+check_ipo_supported(RESULT ipo_supported OUTPUT ipo_error LANGUAGES C CXX)
+if(NOT ipo_supported)
+    message(FATAL_ERROR "Link-time optimisation isn't supported: ${ipo_error}")
+endif()
+
+set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+add_compile_options(-O3 -DNDEBUG)
+
+if(RGBCTL_BUILD_PROFILE STREQUAL "pgo-generate")
+    # The loop, the shader watchdog and the metrics server all run code
+    # on their own threads
+    add_compile_options(
+        -fprofile-generate=${RGBCTL_PGO_DIR}
+        -fprofile-update=atomic
+    )
+    add_link_options(-fprofile-generate=${RGBCTL_PGO_DIR})
+elseif(RGBCTL_BUILD_PROFILE STREQUAL "pgo-use")
+    if(NOT EXISTS "${RGBCTL_PGO_DIR}")
+        message(
+            WARNING
+            "No profile in ${RGBCTL_PGO_DIR}. Build with the pgo-generate "
+            "profile and run rgbctl_pgo_training first"
+        )
+    endif()
+
+    # Code the workload never ran is optimised as usual, rather than for
+    # size, and isn't an error under -Werror
+    add_compile_options(
+        -fprofile-use=${RGBCTL_PGO_DIR}
+        -fprofile-partial-training
+        -fprofile-correction
+        -Wno-missing-profile
+    )
+endif()
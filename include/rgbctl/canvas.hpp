@@ -0,0 +1,108 @@
+#ifndef RGBCTL_CANVAS_HPP_INCLUDED
+#define RGBCTL_CANVAS_HPP_INCLUDED
+
+#include "./effects.hpp"
+#include "./rgb.hpp"
+#include "./vec.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace rgbctl
+{
+
+/* Where each of a zone's LEDs sits on a canvas, from `{ 0, 0 }` at the
+ * top left to `{ 1, 1 }` at the bottom right...
+ */
+struct LedLayout
+{
+    std::vector<Vec<float, 2>> positions;
+};
+
+/* `count` LEDs evenly spaced from `from` to `to`, both ends included...
+ */
+auto led_line(std::size_t count, Vec<float, 2> from, Vec<float, 2> to)
+    -> LedLayout;
+
+/* `count` LEDs evenly spaced around a circle, clockwise from the top...
+ */
+auto led_ring(std::size_t count, Vec<float, 2> centre, float radius)
+    -> LedLayout;
+
+/* A frame buffer shared by zones across any number of devices. One
+ * effect renders into it, a row at a time as if the canvas were one
+ * long zone, and each zone samples it where its LEDs are. An effect
+ * moving across the canvas then moves across the case, for the cost
+ * of one render however many zones show it.
+ *
+ * A canvas is advanced by the zones that sample it, from the thread
+ * that ticks their controllers...
+ */
+struct Canvas
+{
+    Canvas(AnyEffect effect, std::size_t width, std::size_t height = 1);
+
+    auto width() const noexcept -> std::size_t;
+    auto height() const noexcept -> std::size_t;
+    auto pixels() const noexcept -> std::span<RgbFloat const>;
+    auto effect() const noexcept -> AnyEffect const&;
+
+    /* Renders the canvas as of `elapsed_ms` after it started, unless
+     * it already has been...
+     */
+    auto advance_to(std::size_t elapsed_ms) -> void;
+
+    /* How many times the effect has been ticked...
+     */
+    auto renders() const noexcept -> std::uint64_t;
+
+private:
+    AnyEffect effect_;
+    std::size_t width_;
+    std::size_t height_;
+    std::size_t elapsed_ms_;
+    std::uint64_t renders_;
+    std::vector<RgbFloat> pixels_;
+};
+
+/* An effect that shows a zone's part of a canvas. Each LED blends the
+ * four pixels around its position, with positions off the canvas held
+ * at its edge. The pixels and weights for each LED are worked out once,
+ * since neither the layout nor the canvas changes size. A zone longer
+ * than its layout is black past the end of it...
+ */
+struct CanvasSampler
+{
+    CanvasSampler(std::uint32_t zone_index,
+                  std::shared_ptr<Canvas> canvas,
+                  LedLayout const& layout);
+
+    auto zone_index() const noexcept -> std::uint32_t;
+
+    auto rgb_count() const noexcept -> std::size_t;
+
+    auto duration() const noexcept -> std::size_t;
+
+    auto remaining() const noexcept -> std::size_t;
+
+    auto tick(std::size_t ms, std::span<RgbFloat> out_frame) -> std::size_t;
+
+private:
+    static std::size_t constexpr kTaps = 4;
+
+    std::uint32_t zone_index_;
+    std::shared_ptr<Canvas> canvas_;
+    std::size_t elapsed_ms_;
+    std::size_t led_count_;
+
+    /* Tap `k` of LED `n` is at `n * kTaps + k`...
+     */
+    std::vector<std::uint32_t> indices_;
+    std::vector<float> weights_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_CANVAS_HPP_INCLUDED
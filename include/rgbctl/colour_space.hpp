@@ -0,0 +1,41 @@
+#ifndef RGBCTL_COLOUR_SPACE_HPP_INCLUDED
+#define RGBCTL_COLOUR_SPACE_HPP_INCLUDED
+
+#include "./rgb.hpp"
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace rgbctl
+{
+
+/* Where a texture's texels are interpolated. Colours are given, and
+ * come back, as gamma encoded sRGB, but blending those gives gradients
+ * that dip in brightness and muddy through grey. Blending linear RGB
+ * keeps the light constant, and blending OKLab keeps the perceived
+ * lightness and hue even as well...
+ */
+enum class ColourSpace
+{
+    Srgb,
+    LinearRgb,
+    Oklab
+};
+
+/* "srgb", "linear" or "oklab"...
+ */
+auto parse_colour_space(std::string_view) noexcept
+    -> std::optional<ColourSpace>;
+
+/* Converts colours in place. Neither conversion has branches or
+ * library calls once the colour space is chosen, so both vectorise...
+ */
+auto from_srgb(ColourSpace, std::span<RgbFloat>) noexcept -> void;
+auto to_srgb(ColourSpace, std::span<RgbFloat>) noexcept -> void;
+
+auto from_srgb(ColourSpace, RgbFloat) noexcept -> RgbFloat;
+auto to_srgb(ColourSpace, RgbFloat) noexcept -> RgbFloat;
+
+} // namespace rgbctl
+
+#endif // RGBCTL_COLOUR_SPACE_HPP_INCLUDED
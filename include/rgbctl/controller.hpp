@@ -4,7 +4,10 @@
 #include "./acquire.hpp"
 #include "./assert.hpp"
 #include "./device_context.hpp"
+#include "./latency_histogram.hpp"
 #include "./narrow.hpp"
+#include "./output_stage.hpp"
+#include "./trace.hpp"
 #include <cinttypes>
 #include <memory>
 #include <span>
@@ -13,6 +16,15 @@
 namespace rgbctl
 {
 
+/* Where a controller records how long its effect and its device
+ * take each tick. Either may be null...
+ */
+struct ControllerTimings
+{
+    LatencyHistogram* effect = nullptr;
+    LatencyHistogram* send = nullptr;
+};
+
 template <typename ReadWriteStream, typename Effect>
 struct Controller
 {
@@ -30,8 +42,14 @@ struct Controller
         , effect_ { std::move(effect) }
     {
         auto zones = module_.query_zones(device_context);
-        if (effect_.zone_index() < zones.size())
-            rgb_value_buffer_.resize(zones[effect_.zone_index()].rgb_count);
+        if (effect_.zone_index() < zones.size()) {
+            auto const& zone = zones[effect_.zone_index()];
+            colour_buffer_.resize(zone.rgb_count);
+            rgb_value_buffer_.resize(zone.rgb_count);
+            output_ = OutputStage {
+                {}, static_cast<rgbctl_channel_order>(zone.channel_order)
+            };
+        }
     }
 
     ~Controller()
@@ -42,17 +60,55 @@ struct Controller
 
     auto tick(std::uint32_t elapsed_milliseconds) -> void
     {
+        RGBCTL_TRACE_SCOPE("Controller::tick");
+
+        std::span<RgbFloat> colours { colour_buffer_.data(),
+                                      colour_buffer_.size() };
         std::span<rgbctl_rgb_value> out_val { rgb_value_buffer_.data(),
                                               rgb_value_buffer_.size() };
 
-        auto rgbs_processed = effect().tick(elapsed_milliseconds, out_val);
+        std::size_t rgbs_processed;
+        {
+            ScopedLatency latency { timings_.effect };
+            rgbs_processed = effect().tick(elapsed_milliseconds, colours);
+        }
+
+        RGBCTL_EXPECTS(rgbs_processed <= colours.size());
         RGBCTL_EXPECTS(can_narrow<std::uint32_t>(rgbs_processed));
+        {
+            RGBCTL_TRACE_SCOPE("OutputStage::apply");
+            output_.apply(colours.first(rgbs_processed), out_val);
+        }
+
+        auto const zone_index
+            = narrow_cast<std::uint32_t>(effect().zone_index());
+
+        ScopedLatency latency { timings_.send };
+        RGBCTL_TRACE_SCOPE("Module::send_rgb_data");
         module_.send_rgb_data(device_context_,
-                              effect().zone_index(),
+                              zone_index,
                               out_val.data(),
                               narrow_cast<std::uint32_t>(rgbs_processed));
     }
 
+    auto set_timings(ControllerTimings timings) noexcept -> void
+    {
+        timings_ = timings;
+    }
+
+    /* The zone decides the channel order, so only the colour
+     * correction can be changed...
+     */
+    auto set_output(OutputOptions const& options) -> void
+    {
+        output_ = OutputStage { options, output_.channel_order() };
+    }
+
+    auto output() const noexcept -> OutputStage const&
+    {
+        return output_;
+    }
+
     auto module() noexcept -> Module&
     {
         return module_;
@@ -94,7 +150,10 @@ private:
     Module module_;
     device_context_type device_context_;
     effect_type effect_;
+    OutputStage output_;
+    std::vector<RgbFloat> colour_buffer_;
     std::vector<rgbctl_rgb_value> rgb_value_buffer_;
+    ControllerTimings timings_ {};
 };
 
 struct AnyController
@@ -104,10 +163,18 @@ struct AnyController
         : inner_ { new Controller<ReadWriteStream, Effect> { std::move(inner) },
                    deleter<Controller<ReadWriteStream, Effect>> }
         , tick_ { tick_impl<Controller<ReadWriteStream, Effect>> }
+        , set_timings_ {
+            set_timings_impl<Controller<ReadWriteStream, Effect>>
+        }
+        , set_output_ { set_output_impl<Controller<ReadWriteStream, Effect>> }
     { }
 
     auto tick(std::uint32_t elapsed_milliseconds) -> void;
 
+    auto set_timings(ControllerTimings) noexcept -> void;
+
+    auto set_output(OutputOptions const&) -> void;
+
 private:
     template <typename T>
     static auto tick_impl(void* inner, std::uint32_t elapsed_milliseconds)
@@ -116,6 +183,20 @@ private:
         (*reinterpret_cast<T*>(inner)).tick(elapsed_milliseconds);
     }
 
+    template <typename T>
+    static auto set_timings_impl(void* inner,
+                                 ControllerTimings timings) noexcept -> void
+    {
+        (*reinterpret_cast<T*>(inner)).set_timings(timings);
+    }
+
+    template <typename T>
+    static auto set_output_impl(void* inner, OutputOptions const& options)
+        -> void
+    {
+        (*reinterpret_cast<T*>(inner)).set_output(options);
+    }
+
     template <typename T>
     static auto deleter(void* p) noexcept -> void
     {
@@ -126,19 +207,32 @@ private:
 
     std::unique_ptr<void, Deleter> inner_;
     auto (*tick_)(void*, std::uint32_t) -> void;
+    auto (*set_timings_)(void*, ControllerTimings) noexcept -> void;
+    auto (*set_output_)(void*, OutputOptions const&) -> void;
 };
 
 template <typename ReadWriteStream, typename Effect>
 auto make_controller(DeviceContext<ReadWriteStream>&& ctx,
                      Effect&& effect,
                      rgbctl_product_id id,
-                     rgbctl_module_acquisition_callback entry) -> AnyController
+                     rgbctl_module_acquisition_callback entry,
+                     void* user_data) -> AnyController
 {
-    auto mod = acquire_module(ctx, id, entry);
+    auto mod = acquire_module(ctx, id, entry, user_data);
     return AnyController { Controller<ReadWriteStream, Effect> {
         std::move(mod), std::move(ctx), std::move(effect) } };
 }
 
+template <typename ReadWriteStream, typename Effect>
+auto make_controller(DeviceContext<ReadWriteStream>&& ctx,
+                     Effect&& effect,
+                     rgbctl_product_id id,
+                     rgbctl_module_acquisition_callback entry) -> AnyController
+{
+    return make_controller(
+        std::move(ctx), std::move(effect), id, entry, nullptr);
+}
+
 } // namespace rgbctl
 
 #endif // RGBCTL_CONTROLLER_HPP_INCLUDED
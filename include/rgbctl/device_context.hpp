@@ -1,6 +1,7 @@
 #ifndef RGBCTL_DEVICE_CONTEXT_HPP_INCLUDED
 #define RGBCTL_DEVICE_CONTEXT_HPP_INCLUDED
 
+#include "./metrics.hpp"
 #include "./rgbctl.h"
 #include <cinttypes>
 #include <utility>
@@ -36,7 +37,11 @@ private:
                       std::uint32_t len) noexcept -> rgbctl_errno
     {
         auto& self = *static_cast<DeviceContext*>(ctx);
-        return self.stream().read(buffer, len);
+        auto const result = self.stream().read(buffer, len);
+        count(result,
+              metrics::Counter::BytesRead,
+              metrics::Counter::ReadErrors);
+        return result;
     }
 
     static auto write_(rgbctl_device_context* ctx,
@@ -45,9 +50,25 @@ private:
     {
         auto& self = *static_cast<DeviceContext*>(ctx);
         auto const result = self.stream().write(buffer, len);
+        count(result,
+              metrics::Counter::BytesWritten,
+              metrics::Counter::WriteErrors);
         return result;
     }
 
+    /* Streams return the number of bytes transferred, or a negated
+     * `RGBCTL_ERR_*`...
+     */
+    static auto count(rgbctl_errno result,
+                      metrics::Counter bytes,
+                      metrics::Counter errors) noexcept -> void
+    {
+        if (result < 0)
+            metrics::add(errors);
+        else
+            metrics::add(bytes, static_cast<std::uint64_t>(result));
+    }
+
     ReadWriteStream stream_;
 };
 
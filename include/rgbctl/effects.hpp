@@ -1,8 +1,11 @@
 #ifndef RGBCTL_EFFECTS_HPP_INCLUDED
 #define RGBCTL_EFFECTS_HPP_INCLUDED
 
+#include "./effects/animation.hpp"
 #include "./effects/linear.hpp"
 #include "./effects/rotate.hpp"
+#include "./effects/user.hpp"
+#include "./rgb.hpp"
 #include "./rgbctl.h"
 #include <concepts>
 #include <memory>
@@ -11,10 +14,13 @@
 
 namespace rgbctl
 {
+/* An effect renders colours, each channel from 0 to 1. It's left to
+ * the controller's `OutputStage` to turn them into device bytes...
+ */
 // clang-format off
 
 template <typename T>
-concept Effect = requires(T effect, std::size_t ms, std::span<rgbctl_rgb_value> out_val)
+concept Effect = requires(T effect, std::size_t ms, std::span<RgbFloat> out_val)
 {
     { effect.zone_index() } noexcept -> std::convertible_to<std::size_t>;
 
@@ -54,7 +60,7 @@ struct AnyEffect
 
     auto remaining() const noexcept -> std::size_t;
 
-    auto tick(std::size_t, std::span<rgbctl_rgb_value>) -> std::size_t;
+    auto tick(std::size_t, std::span<RgbFloat>) -> std::size_t;
 
 private:
     template <Effect T>
@@ -84,7 +90,7 @@ private:
     template <Effect T>
     static auto tick_impl(void* p,
                           std::size_t ms,
-                          std::span<rgbctl_rgb_value> out_val) -> std::size_t
+                          std::span<RgbFloat> out_val) -> std::size_t
     {
         return reinterpret_cast<T*>(p)->tick(ms, out_val);
     }
@@ -95,7 +101,7 @@ private:
         auto (*rgb_count)(void const*) -> std::size_t;
         auto (*duration)(void const*) -> std::size_t;
         auto (*remaining)(void const*) -> std::size_t;
-        auto (*tick)(void*, std::size_t, std::span<rgbctl_rgb_value>)
+        auto (*tick)(void*, std::size_t, std::span<RgbFloat>)
             -> std::size_t;
     };
 
@@ -0,0 +1,45 @@
+#ifndef RGBCTL_EFFECTS_ANIMATION_HPP_INCLUDED
+#define RGBCTL_EFFECTS_ANIMATION_HPP_INCLUDED
+
+#include "../rgb.hpp"
+#include "../texture_stream.hpp"
+
+#include <cinttypes>
+#include <cstddef>
+#include <memory>
+#include <span>
+
+namespace rgbctl::effects
+{
+
+/* Plays an animated texture across a zone, a frame every `frame_ms`,
+ * stretching each frame's first row over the zone's LEDs. Zones can
+ * share a stream, as long as they're ticked together...
+ */
+struct Animation
+{
+    Animation(std::uint32_t /*zone_index*/,
+              std::shared_ptr<TextureStream> /*stream*/,
+              std::size_t /*frame_ms*/);
+
+    auto zone_index() const noexcept -> std::uint32_t;
+
+    auto rgb_count() const noexcept -> std::size_t;
+
+    auto duration() const noexcept -> std::size_t;
+
+    auto remaining() const noexcept -> std::size_t;
+
+    auto tick(std::size_t ms, std::span<RgbFloat> out_frame)
+        -> std::size_t;
+
+private:
+    std::size_t elapsed_ms_;
+    std::uint32_t zone_index_;
+    std::shared_ptr<TextureStream> stream_;
+    std::size_t frame_ms_;
+};
+
+} // namespace rgbctl::effects
+
+#endif // RGBCTL_EFFECTS_ANIMATION_HPP_INCLUDED
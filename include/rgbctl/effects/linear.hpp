@@ -1,11 +1,15 @@
 #ifndef RGBCTL_EFFECTS_LINEAR_HPP_INCLUDED
 #define RGBCTL_EFFECTS_LINEAR_HPP_INCLUDED
 
+#include "../colour_space.hpp"
+#include "../fixed_texture.hpp"
 #include "../rgb.hpp"
 #include "../texture.hpp"
 #include <cinttypes>
 #include <cstddef>
+#include <memory>
 #include <span>
+#include <variant>
 #include <vector>
 
 namespace rgbctl::effects
@@ -16,7 +20,16 @@ struct Linear
     explicit Linear(std::uint32_t zone_index,
                     std::size_t rgb_count,
                     std::size_t duration_ms,
-                    std::span<RgbFloat const> data);
+                    std::span<RgbFloat const> data,
+                    TexturePrecision = TexturePrecision::Float,
+                    ColourSpace = ColourSpace::Srgb);
+
+    /* Scrolls through the rows of a texture that's already been built,
+     * one frame per row, such as one shared through a `TextureCache`...
+     */
+    Linear(std::uint32_t zone_index,
+           std::size_t duration_ms,
+           std::shared_ptr<Texture const> texture);
 
     auto rgb_count() const noexcept -> std::size_t;
 
@@ -26,14 +39,18 @@ struct Linear
 
     auto remaining() const noexcept -> std::size_t;
 
-    auto tick(std::size_t ms, std::span<rgbctl_rgb_value> out_frame)
+    auto tick(std::size_t ms, std::span<RgbFloat> out_frame)
         -> std::size_t;
 
 private:
     std::size_t elapsed_ms_;
     std::uint32_t zone_index_;
     std::size_t duration_ms_;
-    Texture texture_;
+    /* Only the texture for the precision asked for is built...
+     */
+    std::variant<std::shared_ptr<Texture const>,
+                 std::shared_ptr<FixedTexture const>>
+        texture_;
 };
 
 } // namespace rgbctl::effects
@@ -1,13 +1,17 @@
 #ifndef RGBCTL_EFFECTS_ROTATE_HPP_INCLUDED
 #define RGBCTL_EFFECTS_ROTATE_HPP_INCLUDED
 
+#include "../colour_space.hpp"
+#include "../fixed_texture.hpp"
 #include "../rgb.hpp"
 #include "../rgbctl.h"
 #include "../texture.hpp"
 
 #include <cinttypes>
 #include <cstddef>
+#include <memory>
 #include <span>
+#include <variant>
 #include <vector>
 
 namespace rgbctl::effects
@@ -17,7 +21,18 @@ struct Rotate
 {
     Rotate(std::uint32_t /*zone_index*/,
            std::size_t /*duration_ms*/,
-           std::span<RgbFloat const> /*data*/);
+           std::span<RgbFloat const> /*data*/,
+           TexturePrecision = TexturePrecision::Float,
+           ColourSpace = ColourSpace::Srgb,
+           Mipmaps = Mipmaps::None);
+
+    /* Rotates a texture that's already been built, such as one mapped
+     * from a texture file. Effects built from the same texture share
+     * it, rather than each holding a copy...
+     */
+    Rotate(std::uint32_t /*zone_index*/,
+           std::size_t /*duration_ms*/,
+           std::shared_ptr<Texture const> /*texture*/);
 
     auto zone_index() const noexcept -> std::uint32_t;
 
@@ -27,14 +42,18 @@ struct Rotate
 
     auto remaining() const noexcept -> std::size_t;
 
-    auto tick(std::size_t ms, std::span<rgbctl_rgb_value> out_frame)
+    auto tick(std::size_t ms, std::span<RgbFloat> out_frame)
         -> std::size_t;
 
 private:
     std::size_t elapsed_ms_;
     std::uint32_t zone_index_;
     std::size_t duration_ms_;
-    Texture texture_;
+    /* Only the texture for the precision asked for is built...
+     */
+    std::variant<std::shared_ptr<Texture const>,
+                 std::shared_ptr<FixedTexture const>>
+        texture_;
 };
 
 } // namespace rgbctl::effects
@@ -0,0 +1,86 @@
+#ifndef RGBCTL_EFFECTS_USER_HPP_INCLUDED
+#define RGBCTL_EFFECTS_USER_HPP_INCLUDED
+
+#include "../colour_space.hpp"
+#include "../rgb.hpp"
+#include "../rgbctl.h"
+#include "../texture.hpp"
+#include "../shader_slot.hpp"
+#include "../shader_watchdog.hpp"
+#include "../user_shader.hpp"
+
+#include <cinttypes>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace rgbctl::effects
+{
+
+/* Runs a user shader over a zone. The shader is invoked once per
+ * tick with the coordinates of every LED in the zone. The shader is
+ * taken from a slot, so it can be replaced between ticks.
+ *
+ * With a non-zero `budget`, the shader runs under a `ShaderWatchdog`.
+ * Whenever it overruns, or has been demoted, the zone keeps its last
+ * good frame. Replacing the shader gives it a fresh start.
+ *
+ * The shader samples the texture in `colour_space`, and always gets
+ * sRGB back.
+ */
+struct User
+{
+    User(std::uint32_t /*zone_index*/,
+         std::size_t /*duration_ms*/,
+         UserShader /*shader*/,
+         std::span<RgbFloat const> /*data*/,
+         ShaderBudget /*budget*/ = {},
+         ColourSpace /*colour_space*/ = ColourSpace::Srgb);
+
+    User(std::uint32_t /*zone_index*/,
+         std::size_t /*duration_ms*/,
+         std::shared_ptr<ShaderSlot> /*shader*/,
+         std::span<RgbFloat const> /*data*/,
+         ShaderBudget /*budget*/ = {},
+         ColourSpace /*colour_space*/ = ColourSpace::Srgb);
+
+    User(std::uint32_t /*zone_index*/,
+         std::size_t /*duration_ms*/,
+         std::shared_ptr<ShaderSlot> /*shader*/,
+         std::shared_ptr<Texture const> /*texture*/,
+         ShaderBudget /*budget*/ = {});
+
+    auto zone_index() const noexcept -> std::uint32_t;
+
+    auto rgb_count() const noexcept -> std::size_t;
+
+    auto duration() const noexcept -> std::size_t;
+
+    auto remaining() const noexcept -> std::size_t;
+
+    auto tick(std::size_t ms, std::span<RgbFloat> out_frame)
+        -> std::size_t;
+
+    auto shader_slot() const noexcept -> std::shared_ptr<ShaderSlot> const&;
+
+    auto watchdog() const noexcept -> ShaderWatchdog const&;
+
+private:
+    auto resize(std::size_t) -> void;
+
+    std::size_t elapsed_ms_;
+    std::uint32_t zone_index_;
+    std::size_t duration_ms_;
+    std::shared_ptr<Texture const> texture_;
+    std::shared_ptr<ShaderSlot> shader_;
+    std::uint32_t shader_generation_;
+    std::unique_ptr<ShaderWatchdog> watchdog_;
+    std::vector<float> u_;
+    std::vector<float> v_;
+    std::vector<rgbctl_rgb_float_value> shaded_;
+};
+
+} // namespace rgbctl::effects
+
+#endif // RGBCTL_EFFECTS_USER_HPP_INCLUDED
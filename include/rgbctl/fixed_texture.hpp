@@ -0,0 +1,82 @@
+#ifndef RGBCTL_FIXED_TEXTURE_HPP_INCLUDED
+#define RGBCTL_FIXED_TEXTURE_HPP_INCLUDED
+
+#include "./rgb.hpp"
+#include "./texture.hpp"
+#include "./vec.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace rgbctl
+{
+
+/* Which texture an effect samples...
+ */
+enum class TexturePrecision
+{
+    Float,
+    Fixed
+};
+
+/* Q0.16 colour channels, where 0xffff is full brightness...
+ */
+using RgbFixed = Rgb<std::uint16_t>;
+
+/* Q16.16 texture coordinates. Only the fraction is ever used, so
+ * coordinates wrap around the texture for free, negative ones (in two's
+ * complement) included...
+ */
+using FixedCoord = Vec<std::uint32_t, 2>;
+
+auto to_rgb_fixed(RgbFloat const&) noexcept -> RgbFixed;
+auto to_rgb_float(RgbFixed const&) noexcept -> RgbFloat;
+auto to_fixed_coord(Vec<float, 2> const&) noexcept -> FixedCoord;
+
+/* A texture sampled with integer arithmetic alone, for hosts where
+ * floating point is slow. Its texels are Q0.16 and its linear filtering
+ * weights Q0.15, so it's within 1/32768 of sampling a `Texture` with
+ * the same texels, plus what's lost storing them in 16 bits...
+ */
+struct FixedTexture
+{
+    static std::size_t constexpr one_row = Texture::one_row;
+
+    FixedTexture() noexcept = default;
+
+    explicit FixedTexture(std::span<RgbFloat const> texels,
+                          std::size_t width = one_row);
+
+    auto width() const noexcept -> std::size_t;
+    auto height() const noexcept -> std::size_t;
+
+    auto sample(FixedCoord const&, Filtering) const noexcept -> RgbFixed;
+    auto sample(FixedCoord const&, NearestFiltering) const noexcept
+        -> RgbFixed;
+    auto sample(FixedCoord const&, LinearFiltering) const noexcept
+        -> RgbFixed;
+
+private:
+    std::vector<RgbFixed> texels_;
+    std::uint32_t width_ = 0;
+    std::uint32_t height_ = 0;
+};
+
+/* Builds whichever texture `precision` asks for from sRGB `texels`,
+ * for effects that sample either. Fixed point textures are always sRGB
+ * and have no mipmaps, so asking for either of those throws...
+ */
+auto make_texture(std::span<RgbFloat const> texels,
+                  std::size_t width,
+                  TexturePrecision precision,
+                  ColourSpace colour_space = ColourSpace::Srgb,
+                  Mipmaps mipmaps = Mipmaps::None)
+    -> std::variant<std::shared_ptr<Texture const>,
+                    std::shared_ptr<FixedTexture const>>;
+
+} // namespace rgbctl
+
+#endif // RGBCTL_FIXED_TEXTURE_HPP_INCLUDED
@@ -0,0 +1,57 @@
+#ifndef RGBCTL_HASH_HPP_INCLUDED
+#define RGBCTL_HASH_HPP_INCLUDED
+
+#include <cinttypes>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace rgbctl
+{
+
+std::uint64_t constexpr kFnv1aOffsetBasis = 0xcbf29ce484222325;
+std::uint64_t constexpr kFnv1aPrime = 0x00000100000001b3;
+
+/* FNV-1a. Not cryptographic, only good enough for spotting identical
+ * content. Pass the result of a previous call as `hash` to hash
+ * several pieces of data as one...
+ */
+constexpr auto fnv1a(std::span<std::byte const> data,
+                     std::uint64_t hash = kFnv1aOffsetBasis) noexcept
+    -> std::uint64_t
+{
+    for (auto b : data) {
+        hash ^= static_cast<std::uint64_t>(b);
+        hash *= kFnv1aPrime;
+    }
+
+    return hash;
+}
+
+constexpr auto fnv1a(std::string_view data,
+                     std::uint64_t hash = kFnv1aOffsetBasis) noexcept
+    -> std::uint64_t
+{
+    for (auto c : data) {
+        hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(c));
+        hash *= kFnv1aPrime;
+    }
+
+    return hash;
+}
+
+inline auto to_hex(std::uint64_t hash) -> std::string
+{
+    auto constexpr kDigits = "0123456789abcdef";
+
+    std::string result(16, '0');
+    for (auto pos = result.rbegin(); pos != result.rend(); ++pos, hash >>= 4)
+        *pos = kDigits[hash & 0x0f];
+
+    return result;
+}
+
+} // namespace rgbctl
+
+#endif // RGBCTL_HASH_HPP_INCLUDED
@@ -0,0 +1,133 @@
+#ifndef RGBCTL_LATENCY_HISTOGRAM_HPP_INCLUDED
+#define RGBCTL_LATENCY_HISTOGRAM_HPP_INCLUDED
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <string>
+
+namespace rgbctl
+{
+
+/* A fixed size, log-linear histogram of latencies, in the style of
+ * HdrHistogram. Each power of two is split into `kSubBuckets` linear
+ * buckets, so any latency is recorded to within 1/`kSubBuckets` of its
+ * value, from nanoseconds up to the full range of a `uint64_t`.
+ *
+ * Recording is lock free, and can be done from any thread while
+ * another reads the statistics. The statistics are only approximate
+ * while that happens...
+ */
+struct LatencyHistogram
+{
+    using duration = std::chrono::nanoseconds;
+
+    static constexpr std::size_t kSubBucketBits = 4;
+    static constexpr std::size_t kSubBuckets = 1 << kSubBucketBits;
+    static constexpr std::size_t kBucketCount
+        = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    explicit LatencyHistogram(duration deadline = duration::max()) noexcept;
+
+    LatencyHistogram(LatencyHistogram const&) = delete;
+    auto operator=(LatencyHistogram const&) -> LatencyHistogram& = delete;
+
+    auto record(duration) noexcept -> void;
+
+    auto count() const noexcept -> std::uint64_t;
+
+    /* How many recorded latencies were longer than the deadline...
+     */
+    auto missed_deadlines() const noexcept -> std::uint64_t;
+
+    auto deadline() const noexcept -> duration;
+
+    auto max() const noexcept -> duration;
+
+    /* Every recorded latency added together, exactly rather than from
+     * the buckets...
+     */
+    auto sum() const noexcept -> duration;
+
+    /* The latency that `q` (0 - 1) of the recorded latencies are at or
+     * below, rounded up to the end of its bucket...
+     */
+    auto percentile(double q) const noexcept -> duration;
+
+    auto reset() noexcept -> void;
+
+    static auto bucket_index(std::uint64_t) noexcept -> std::size_t;
+
+    static auto bucket_upper_bound(std::size_t) noexcept -> std::uint64_t;
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_;
+    std::atomic<std::uint64_t> count_;
+    std::atomic<std::uint64_t> missed_;
+    std::atomic<std::uint64_t> max_;
+    std::atomic<std::uint64_t> sum_;
+    duration deadline_;
+};
+
+/* Owns a set of named histograms. References returned by
+ * `histogram()` stay valid for the registry's lifetime, so they can be
+ * handed out to whatever is being measured...
+ */
+struct HistogramRegistry
+{
+    auto histogram(std::string name,
+                   LatencyHistogram::duration deadline
+                   = LatencyHistogram::duration::max()) -> LatencyHistogram&;
+
+    auto size() const noexcept -> std::size_t;
+
+    /* Calls `f(name, histogram)` for each histogram, in the order they
+     * were added...
+     */
+    template <typename F>
+    auto for_each(F&& f) const -> void
+    {
+        for (auto const& entry : entries_)
+            f(entry.name, entry.histogram);
+    }
+
+    /* Writes a table of each histogram's count, p50, p99, max (in
+     * microseconds) and missed deadlines...
+     */
+    auto dump(std::ostream&) const -> void;
+
+private:
+    struct Entry
+    {
+        explicit Entry(std::string, LatencyHistogram::duration);
+
+        std::string name;
+        LatencyHistogram histogram;
+    };
+
+    std::deque<Entry> entries_;
+};
+
+/* Records the time from construction to destruction, if given a
+ * histogram...
+ */
+struct ScopedLatency
+{
+    explicit ScopedLatency(LatencyHistogram*) noexcept;
+    ~ScopedLatency();
+
+    ScopedLatency(ScopedLatency const&) = delete;
+    auto operator=(ScopedLatency const&) -> ScopedLatency& = delete;
+
+private:
+    LatencyHistogram* histogram_;
+    std::chrono::steady_clock::time_point started_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_LATENCY_HISTOGRAM_HPP_INCLUDED
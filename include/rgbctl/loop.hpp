@@ -23,6 +23,17 @@ auto loop(std::uint32_t ms_per_loop,
 
 } // namespace detail
 
+/* Blocks the signals that `loop()` waits for on the calling thread.
+ * Background threads should call this before anything else, so those
+ * signals are only ever delivered to the thread running the loop...
+ */
+auto block_loop_signals() noexcept -> void;
+
+/* Returns true if `loop()` has received SIGUSR1 since the last call,
+ * i.e. someone has asked for a status report...
+ */
+auto take_status_request() noexcept -> bool;
+
 template <typename UnaryPredicate>
 auto loop(std::uint32_t ms_per_loop, UnaryPredicate f) -> void
 {
@@ -0,0 +1,48 @@
+#ifndef RGBCTL_METRICS_HPP_INCLUDED
+#define RGBCTL_METRICS_HPP_INCLUDED
+
+#include "./latency_histogram.hpp"
+#include <array>
+#include <cinttypes>
+#include <cstddef>
+#include <iosfwd>
+
+namespace rgbctl::metrics
+{
+
+enum class Counter : std::size_t
+{
+    FramesRendered,
+    FramesSkipped,
+    BytesWritten,
+    BytesRead,
+    WriteErrors,
+    ReadErrors,
+    ShaderWorkersAbandoned,
+};
+
+constexpr std::size_t kCounterCount
+    = static_cast<std::size_t>(Counter::ShaderWorkersAbandoned) + 1;
+
+using Counters = std::array<std::uint64_t, kCounterCount>;
+
+/* Counters are kept per thread, and only summed when read, so adding
+ * to one is a plain relaxed store to memory no other thread writes.
+ * The only lock is taken once per thread, the first time it counts
+ * anything...
+ */
+auto add(Counter, std::uint64_t n = 1) noexcept -> void;
+
+auto snapshot() -> Counters;
+
+auto name(Counter) noexcept -> char const*;
+
+/* Writes the counters, and optionally a registry's histograms, in the
+ * Prometheus text exposition format...
+ */
+auto write_prometheus(std::ostream&, HistogramRegistry const* = nullptr)
+    -> void;
+
+} // namespace rgbctl::metrics
+
+#endif // RGBCTL_METRICS_HPP_INCLUDED
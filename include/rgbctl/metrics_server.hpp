@@ -0,0 +1,54 @@
+#ifndef RGBCTL_METRICS_SERVER_HPP_INCLUDED
+#define RGBCTL_METRICS_SERVER_HPP_INCLUDED
+
+#include "./latency_histogram.hpp"
+#include <filesystem>
+#include <sys/types.h>
+#include <thread>
+
+namespace rgbctl
+{
+
+/* Serves the metrics over a Unix domain socket, from a thread of its
+ * own. Each client that connects is sent a snapshot in the Prometheus
+ * text format, and the connection is then closed, e.g.
+ *
+ *     socat - UNIX-CONNECT:/run/rgbctl/metrics.sock
+ *
+ * A client that stops reading is dropped after a second.
+ *
+ * A socket already at `socket_path` is replaced, but anything else
+ * there is an error. Only the socket the server bound is removed when
+ * it stops.
+ *
+ * No more histograms may be added to `histograms` once the server has
+ * started, and it must outlive the server.
+ */
+struct MetricsServer
+{
+    MetricsServer(std::filesystem::path socket_path,
+                  HistogramRegistry const* histograms);
+    ~MetricsServer();
+
+    MetricsServer(MetricsServer const&) = delete;
+    auto operator=(MetricsServer const&) -> MetricsServer& = delete;
+
+    auto socket_path() const noexcept -> std::filesystem::path const&;
+
+private:
+    auto run() -> void;
+
+    auto serve(int client) -> void;
+
+    std::filesystem::path socket_path_;
+    HistogramRegistry const* histograms_;
+    int socket_fd_;
+    dev_t socket_device_;
+    ino_t socket_inode_;
+    int stop_fds_[2];
+    std::thread thread_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_METRICS_SERVER_HPP_INCLUDED
@@ -0,0 +1,60 @@
+#ifndef RGBCTL_NATIVE_SHADER_COMPILER_HPP_INCLUDED
+#define RGBCTL_NATIVE_SHADER_COMPILER_HPP_INCLUDED
+
+#include "./shader_slot.hpp"
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rgbctl
+{
+
+/* Rebuilds user shaders with the system C compiler (`$CC`, split into
+ * words like make does, or `cc`) at `-O2 -march=native`, in the
+ * background. Each shader's slot keeps
+ * running whatever it already has, usually the TCC build, until the
+ * native build has been loaded and published into it. If there's no
+ * compiler, or it fails, the slot is simply left alone. Nor is a
+ * build published if the slot's source has changed since `compile()`
+ * was called.
+ */
+struct NativeShaderCompiler
+{
+    explicit NativeShaderCompiler(std::filesystem::path cache_directory);
+    ~NativeShaderCompiler();
+
+    NativeShaderCompiler(NativeShaderCompiler const&) = delete;
+    auto operator=(NativeShaderCompiler const&)
+        -> NativeShaderCompiler& = delete;
+
+    auto compile(std::string source, std::shared_ptr<ShaderSlot> slot)
+        -> void;
+
+    auto wait() -> void;
+
+    static auto compile_library(std::string const& source,
+                                std::filesystem::path const& output) -> bool;
+
+private:
+    struct Worker
+    {
+        std::thread thread;
+        std::shared_ptr<std::atomic_bool> done;
+    };
+
+    auto path(std::string const& source) const -> std::filesystem::path;
+
+    auto reap() -> void;
+
+    std::filesystem::path directory_;
+    std::mutex workers_mutex_;
+    std::vector<Worker> workers_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_NATIVE_SHADER_COMPILER_HPP_INCLUDED
@@ -0,0 +1,87 @@
+#ifndef RGBCTL_OUTPUT_STAGE_HPP_INCLUDED
+#define RGBCTL_OUTPUT_STAGE_HPP_INCLUDED
+
+#include "./rgb.hpp"
+#include "./rgbctl.h"
+#include <array>
+#include <cinttypes>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace rgbctl
+{
+
+/* How a device's colours are corrected on their way out...
+ */
+struct OutputOptions
+{
+    /* Each channel is raised to this power. LEDs are driven linearly,
+     * so something around 2.2 makes fades look even to the eye...
+     */
+    float gamma = 1.f;
+
+    /* Scales every channel, capping how bright the LEDs get...
+     */
+    float brightness = 1.f;
+
+    /* Scales each channel, to correct a device's tint...
+     */
+    RgbFloat white_balance { 1.f, 1.f, 1.f };
+
+    /* Carries the part of each channel that doesn't fit in a byte over
+     * to the next frame, so slow fades don't step...
+     */
+    bool dither = true;
+};
+
+/* Converts a zone's colours into the bytes its device expects. Gamma,
+ * brightness and white balance are baked into a lookup table per
+ * channel, built once, so converting an LED costs three lookups. The
+ * tables are indexed by the colour quantised to `kLutSize` steps, and
+ * hold 8.8 fixed point values, which are rounded to device bytes or,
+ * with `OutputOptions::dither`, dithered over time. Dithering keeps a
+ * byte of residue per channel for each LED converted, allocated the
+ * first time a zone that size is converted...
+ */
+struct OutputStage
+{
+    /* 16 steps for every byte value, and every byte value a step of
+     * its own, so colours that are already whole bytes come out exact.
+     * That's 4081 entries per channel...
+     */
+    static std::size_t constexpr kLutSize = 255 * 16 + 1;
+
+    explicit OutputStage(
+        OutputOptions const& options = {},
+        rgbctl_channel_order order = RGBCTL_CHANNEL_ORDER_RGB);
+
+    auto options() const noexcept -> OutputOptions const&;
+
+    auto channel_order() const noexcept -> rgbctl_channel_order;
+
+    /* Converts as many of `in` as fit into `out`, returning how many
+     * were converted...
+     */
+    auto apply(std::span<RgbFloat const> in, std::span<rgbctl_rgb_value> out)
+        -> std::size_t;
+
+private:
+    static auto dither(std::uint16_t const* fixed,
+                       std::uint8_t* residues,
+                       std::uint8_t* bytes,
+                       std::size_t count) noexcept -> void;
+
+    OutputOptions options_;
+    rgbctl_channel_order order_;
+
+    /* The colour channel that goes in each of the device's channels...
+     */
+    std::array<std::size_t, 3> sources_;
+    std::vector<std::uint16_t> luts_;
+    std::vector<std::uint8_t> residues_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_OUTPUT_STAGE_HPP_INCLUDED
@@ -0,0 +1,78 @@
+#ifndef RGBCTL_PLUGIN_REGISTRY_HPP_INCLUDED
+#define RGBCTL_PLUGIN_REGISTRY_HPP_INCLUDED
+
+#include "./rgbctl.h"
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace rgbctl
+{
+
+/* Keeps track of the driver plugins found in a plugin directory.
+ *
+ * Scanning only opens each plugin long enough to validate its ABI
+ * version and copy its product list. The plugin is closed again
+ * until `load()` is called for one of its products, which is expected
+ * to happen only once a matching device has actually been detected.
+ *
+ * Any `Module` acquired through a loaded plugin must be destroyed
+ * before the registry, as the registry owns the plugin's code.
+ */
+struct PluginRegistry
+{
+    PluginRegistry() noexcept;
+    PluginRegistry(PluginRegistry&&) noexcept;
+    ~PluginRegistry();
+
+    PluginRegistry(PluginRegistry const&) = delete;
+    auto operator=(PluginRegistry const&) -> PluginRegistry& = delete;
+    auto operator=(PluginRegistry&&) noexcept -> PluginRegistry&;
+
+    auto scan(std::filesystem::path const& directory) -> std::size_t;
+
+    auto add(std::filesystem::path const& plugin) -> void;
+
+    auto supports(rgbctl_product_id) const noexcept -> bool;
+
+    auto products() const noexcept -> std::span<rgbctl_product_id const>;
+
+    auto load(rgbctl_product_id) -> rgbctl_module_registration const&;
+
+    auto plugin_count() const noexcept -> std::size_t;
+
+    auto loaded_count() const noexcept -> std::size_t;
+
+private:
+    struct DlDeleter
+    {
+        auto operator()(void*) const noexcept -> void;
+    };
+
+    using DlPtr = std::unique_ptr<void, DlDeleter>;
+
+    struct Plugin
+    {
+        std::filesystem::path path;
+        DlPtr handle;
+        rgbctl_module_registration registration;
+    };
+
+    static auto open(std::filesystem::path const&, int flags) -> DlPtr;
+
+    static auto registration(void* handle,
+                             std::filesystem::path const&)
+        -> rgbctl_module_registration;
+
+    auto find(rgbctl_product_id) const noexcept -> Plugin*;
+
+    std::vector<std::unique_ptr<Plugin>> plugins_;
+    std::vector<rgbctl_product_id> products_;
+    std::vector<Plugin*> product_owners_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_PLUGIN_REGISTRY_HPP_INCLUDED
@@ -0,0 +1,68 @@
+#ifndef RGBCTL_RENDER_HPP_INCLUDED
+#define RGBCTL_RENDER_HPP_INCLUDED
+
+#include "./effects.hpp"
+#include "./output_stage.hpp"
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <span>
+
+namespace rgbctl
+{
+
+enum class RenderFormat
+{
+    /* Each frame's RGB bytes, one after another, with no header...
+     */
+    Raw,
+
+    /* A binary PPM (P6) image with a row for each frame...
+     */
+    Ppm
+};
+
+struct RenderOptions
+{
+    /* How much simulated time to render...
+     */
+    std::chrono::milliseconds duration { 10'000 };
+    std::chrono::milliseconds frame_period { 33 };
+    RenderFormat format = RenderFormat::Raw;
+    OutputOptions output {};
+};
+
+/* An effect, and the number of LEDs in the zone it renders to...
+ */
+struct RenderZone
+{
+    AnyEffect effect;
+    std::size_t rgb_count;
+};
+
+struct RenderStats
+{
+    std::size_t frames;
+
+    /* Wall clock time taken to render every frame, including writing
+     * them out...
+     */
+    std::chrono::nanoseconds elapsed;
+
+    auto frames_per_second() const noexcept -> double;
+};
+
+/* Runs `zones`' effects over `options.duration` of simulated time, as
+ * fast as they'll go, and writes every frame to `out`. A frame is each
+ * zone's LEDs in turn, in RGB order, so the zones sit side by side in
+ * a PPM strip.
+ * LEDs that an effect doesn't fill are left black. Throws if `out`
+ * can't be written...
+ */
+auto render(std::span<RenderZone> zones,
+            RenderOptions const& options,
+            std::ostream& out) -> RenderStats;
+
+} // namespace rgbctl
+
+#endif // RGBCTL_RENDER_HPP_INCLUDED
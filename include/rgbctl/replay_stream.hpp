@@ -0,0 +1,58 @@
+#ifndef RGBCTL_REPLAY_STREAM_HPP_INCLUDED
+#define RGBCTL_REPLAY_STREAM_HPP_INCLUDED
+
+#include "./rgbctl.h"
+#include "./traffic_log.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+namespace rgbctl
+{
+
+enum class ReplayTiming
+{
+    /* Every transfer completes immediately...
+     */
+    Immediate,
+
+    /* Each transfer starts no earlier, and takes no less time, than it
+     * did when it was recorded...
+     */
+    Recorded
+};
+
+/* Plays a traffic log back to whatever drives the stream, in place of
+ * the device it was recorded from. Reads return what the device sent,
+ * and writes what the device accepted, failures included. A transfer
+ * that doesn't match the next one recorded (a read in place of a write,
+ * or different bytes written) is counted as a divergence...
+ */
+struct ReplayStream
+{
+    explicit ReplayStream(std::vector<TrafficRecord> records,
+                          ReplayTiming timing = ReplayTiming::Immediate);
+
+    auto read(unsigned char*, std::uint32_t) noexcept -> rgbctl_errno;
+    auto write(unsigned char const*, std::uint32_t) noexcept -> rgbctl_errno;
+
+    auto divergences() const noexcept -> std::size_t;
+
+    /* How many recorded transfers haven't been replayed yet...
+     */
+    auto remaining() const noexcept -> std::size_t;
+
+private:
+    auto next(TrafficDirection) noexcept -> TrafficRecord const*;
+    auto wait(TrafficRecord const&) const noexcept -> void;
+
+    std::vector<TrafficRecord> records_;
+    std::size_t next_;
+    std::size_t divergences_;
+    ReplayTiming timing_;
+    std::uint64_t started_ns_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_REPLAY_STREAM_HPP_INCLUDED
@@ -0,0 +1,68 @@
+#ifndef RGBCTL_RESAMPLER_HPP_INCLUDED
+#define RGBCTL_RESAMPLER_HPP_INCLUDED
+
+#include "./rgb.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace rgbctl
+{
+
+enum class Resampling
+{
+    /* Each LED takes the source LED under its centre...
+     */
+    Nearest,
+
+    /* Each LED blends the two source LEDs either side of its centre...
+     */
+    Linear,
+
+    /* Each LED averages the source LEDs it covers, weighted by how much
+     * of each it covers. Shrinking a frame this way doesn't alias...
+     */
+    Area
+};
+
+/* Stretches or shrinks a frame of LEDs to a zone of a different size,
+ * so one rendered frame can drive zones of any size. LEDs are spaced
+ * evenly along both, centre to centre, and the ends don't wrap. Which
+ * source LEDs go into each target LED, and by how much, is worked out
+ * once when the resampler is built. Applying it is then a weighted sum
+ * per tap, stored a tap at a time across every target LED, so there's
+ * no division or branching per LED...
+ */
+struct Resampler
+{
+    Resampler(std::size_t source_size,
+              std::size_t target_size,
+              Resampling = Resampling::Linear);
+
+    auto source_size() const noexcept -> std::size_t;
+    auto target_size() const noexcept -> std::size_t;
+    auto resampling() const noexcept -> Resampling;
+
+    /* `source` must hold `source_size()` colours and `target` at least
+     * `target_size()`. Returns how many were written...
+     */
+    auto apply(std::span<RgbFloat const> source,
+               std::span<RgbFloat> target) const -> std::size_t;
+
+private:
+    std::size_t source_size_;
+    std::size_t target_size_;
+    Resampling resampling_;
+    std::size_t taps_;
+
+    /* Tap `k` of target LED `n` is at `k * target_size_ + n`. Indices
+     * are of the source LED...
+     */
+    std::vector<std::uint32_t> indices_;
+    std::vector<float> weights_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_RESAMPLER_HPP_INCLUDED
@@ -32,10 +32,24 @@ struct rgbctl_rgb_value
     uint8_t red, green, blue;
 };
 
+/* The order a zone's LEDs take their channels in. The values sent to
+ * a zone are already in its order, so a module just copies them...
+ */
+enum rgbctl_channel_order
+{
+    RGBCTL_CHANNEL_ORDER_RGB = 0,
+    RGBCTL_CHANNEL_ORDER_RBG,
+    RGBCTL_CHANNEL_ORDER_GRB,
+    RGBCTL_CHANNEL_ORDER_GBR,
+    RGBCTL_CHANNEL_ORDER_BRG,
+    RGBCTL_CHANNEL_ORDER_BGR
+};
+
 struct rgbctl_zone
 {
     uint32_t rgb_count;
     char const* name;
+    uint32_t channel_order; /* an `rgbctl_channel_order` */
 };
 
 struct rgbctl_module
@@ -78,6 +92,19 @@ struct rgbctl_module_registration
     void* user_data;
 };
 
+/* Plugins...
+ *
+ * A driver plugin is a shared object that exports an `init` function
+ * matching `rgbctl_module_init`, and a `rgbctl_module_abi_version`
+ * object equal to the `RGBCTL_MODULE_ABI_VERSION` it was built
+ * against. `init` may be called more than once, and the plugin may be
+ * unloaded in between, so it must not acquire any resources. Those
+ * belong in the acquisition callback.
+ */
+#define RGBCTL_MODULE_ABI_VERSION 2
+
+typedef rgbctl_errno (*rgbctl_module_init)(struct rgbctl_module_registration*);
+
 rgbctl_errno
 rgbctl_write(struct rgbctl_device_context*, unsigned char const*, uint32_t);
 
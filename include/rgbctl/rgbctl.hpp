@@ -3,16 +3,40 @@
 
 #include "./acquire.hpp"
 #include "./assert.hpp"
+#include "./canvas.hpp"
+#include "./colour_space.hpp"
 #include "./controller.hpp"
 #include "./detected_device.hpp"
 #include "./detector.hpp"
 #include "./device_context.hpp"
 #include "./effects.hpp"
+#include "./fixed_texture.hpp"
+#include "./hash.hpp"
+#include "./latency_histogram.hpp"
 #include "./loop.hpp"
+#include "./metrics.hpp"
+#include "./metrics_server.hpp"
 #include "./narrow.hpp"
+#include "./native_shader_compiler.hpp"
+#include "./output_stage.hpp"
+#include "./plugin_registry.hpp"
 #include "./raw_device_stream.hpp"
+#include "./render.hpp"
+#include "./replay_stream.hpp"
+#include "./resampler.hpp"
 #include "./rgb.hpp"
+#include "./shader_cache.hpp"
+#include "./shader_slot.hpp"
+#include "./shader_watchdog.hpp"
+#include "./shader_watcher.hpp"
+#include "./simulated_device_stream.hpp"
 #include "./texture.hpp"
+#include "./texture_cache.hpp"
+#include "./texture_file.hpp"
+#include "./texture_stream.hpp"
+#include "./trace.hpp"
+#include "./traffic_log.hpp"
+#include "./user_shader.hpp"
 #include "./utils.hpp"
 #include "./vec.hpp"
 
@@ -0,0 +1,39 @@
+#ifndef RGBCTL_SHADER_H_INCLUDED
+#define RGBCTL_SHADER_H_INCLUDED
+
+#include "./texture.h"
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* User shaders...
+ *
+ * A user shader is C source that defines a function named by
+ * `RGBCTL_SHADER_ENTRY_POINT`, matching `rgbctl_shader`. It is called
+ * once per frame for a whole zone rather than once per LED, so it
+ * should loop over the `count` coordinates in its input and write one
+ * colour to `out` for each of them. `rgb_sample_texture_n` samples a
+ * whole zone's worth of texels in one call.
+ */
+#define RGBCTL_SHADER_ABI_VERSION 1
+#define RGBCTL_SHADER_ENTRY_POINT "shade"
+
+struct rgbctl_shader_input
+{
+    float const* u;
+    float const* v;
+    uint32_t count;
+    float stage; /* Progress through the effect, in the range [0, 1) */
+    uint32_t elapsed_ms;
+    struct rgbctl_texture const* texture;
+};
+
+typedef void (*rgbctl_shader)(struct rgbctl_shader_input const*,
+                              struct rgbctl_rgb_float_value*);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // RGBCTL_SHADER_H_INCLUDED
@@ -0,0 +1,39 @@
+#ifndef RGBCTL_SHADER_CACHE_HPP_INCLUDED
+#define RGBCTL_SHADER_CACHE_HPP_INCLUDED
+
+#include "./user_shader.hpp"
+#include <cinttypes>
+#include <filesystem>
+#include <string>
+
+namespace rgbctl
+{
+
+/* Caches compiled user shaders on disk as shared objects, so a shader
+ * is only compiled the first time it's seen. Entries are keyed on the
+ * shader source, the compiler version and the shader ABI version, so
+ * changing any of them simply results in a cache miss.
+ */
+struct ShaderCache
+{
+    explicit ShaderCache(std::filesystem::path directory);
+
+    static auto default_directory() -> std::filesystem::path;
+
+    auto load(std::string const& source) -> UserShader;
+
+    auto load_file(std::filesystem::path const&) -> UserShader;
+
+    auto key(std::string const& source) const -> std::uint64_t;
+
+    auto path(std::string const& source) const -> std::filesystem::path;
+
+    auto directory() const noexcept -> std::filesystem::path const&;
+
+private:
+    std::filesystem::path directory_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_SHADER_CACHE_HPP_INCLUDED
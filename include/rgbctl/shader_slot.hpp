@@ -0,0 +1,52 @@
+#ifndef RGBCTL_SHADER_SLOT_HPP_INCLUDED
+#define RGBCTL_SHADER_SLOT_HPP_INCLUDED
+
+#include "./user_shader.hpp"
+#include <atomic>
+#include <cinttypes>
+#include <memory>
+#include <mutex>
+
+namespace rgbctl
+{
+
+/* Holds the shader an effect is running, and lets another thread
+ * replace it. A replacement is only picked up when the animation
+ * thread next calls `acquire()`, i.e. between frames, so a shader is
+ * never swapped out part way through a zone.
+ *
+ * Every `publish()` starts a new revision, i.e. a change of source.
+ * `replace()` is for a different build of the same source, and is
+ * ignored if the source has changed since `revision()` was read, so a
+ * slow build of an old revision can't undo a reload...
+ */
+struct ShaderSlot
+{
+    explicit ShaderSlot(UserShader initial = {}) noexcept;
+
+    ShaderSlot(ShaderSlot const&) = delete;
+    auto operator=(ShaderSlot const&) -> ShaderSlot& = delete;
+
+    auto publish(UserShader) -> void;
+
+    auto replace(UserShader, std::uint32_t revision) -> bool;
+
+    auto acquire() noexcept -> UserShader const&;
+
+    auto generation() const noexcept -> std::uint32_t;
+
+    auto revision() const noexcept -> std::uint32_t;
+
+private:
+    auto store(UserShader) -> void;
+
+    UserShader current_;
+    std::mutex publish_mutex_;
+    std::atomic<std::shared_ptr<UserShader>> pending_;
+    std::atomic<std::uint32_t> generation_;
+    std::atomic<std::uint32_t> revision_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_SHADER_SLOT_HPP_INCLUDED
@@ -0,0 +1,104 @@
+#ifndef RGBCTL_SHADER_WATCHDOG_HPP_INCLUDED
+#define RGBCTL_SHADER_WATCHDOG_HPP_INCLUDED
+
+#include "./shader.h"
+#include "./texture.hpp"
+#include "./user_shader.hpp"
+#include <chrono>
+#include <cinttypes>
+#include <memory>
+#include <span>
+#include <thread>
+
+namespace rgbctl
+{
+
+struct ShaderBudget
+{
+    /* How long a shader may take to shade one zone. Zero disables
+     * the watchdog, and shaders run inline on the calling thread...
+     */
+    std::chrono::microseconds per_frame;
+
+    /* How many frames in a row a shader may overrun before it's
+     * demoted...
+     */
+    std::uint32_t max_overruns;
+};
+
+/* How many abandoned workers, across every watchdog, may still be
+ * stuck in a shader before no more are started. Each one is a thread
+ * that can't be reclaimed until its shader returns, if ever, so once
+ * there are this many, a watchdog that needs a new worker stays
+ * demoted instead...
+ */
+std::uint32_t constexpr kMaxAbandonedShaderWorkers = 4;
+
+struct ShaderTimings
+{
+    std::uint64_t frames;
+    std::uint64_t overruns;
+    std::chrono::nanoseconds last;
+    std::chrono::nanoseconds max;
+};
+
+/* Runs a user shader on a worker thread, and waits for it only until
+ * the frame's budget runs out. A shader that overruns leaves the
+ * output untouched, so the caller keeps showing its last good frame.
+ *
+ * A shader that overruns `max_overruns` frames in a row is demoted:
+ * it isn't run again until `reset()`, e.g. because it's been
+ * replaced. If it's still running at that point, which is the case
+ * for a shader stuck in a loop, its worker is abandoned. The worker
+ * owns copies of everything the shader can see, so it's safe to let
+ * it run on indefinitely. Abandoned workers are counted, and bounded
+ * by `kMaxAbandonedShaderWorkers`.
+ */
+struct ShaderWatchdog
+{
+    explicit ShaderWatchdog(ShaderBudget);
+    ~ShaderWatchdog();
+
+    ShaderWatchdog(ShaderWatchdog const&) = delete;
+    auto operator=(ShaderWatchdog const&) -> ShaderWatchdog& = delete;
+
+    /* Returns false, without writing to `out`, if the shader didn't
+     * finish in time or has been demoted...
+     */
+    auto run(UserShader const&,
+             rgbctl_shader_input const&,
+             std::shared_ptr<Texture const> const&,
+             std::span<rgbctl_rgb_float_value> out) -> bool;
+
+    auto reset() -> void;
+
+    auto demoted() const noexcept -> bool;
+
+    auto timings() const noexcept -> ShaderTimings const&;
+
+    /* How many abandoned workers are still running a shader...
+     */
+    static auto abandoned_workers() noexcept -> std::uint32_t;
+
+private:
+    struct Job;
+
+    static auto work(std::shared_ptr<Job>) -> void;
+
+    auto start() -> void;
+
+    auto overrun() -> bool;
+
+    auto abandon() -> void;
+
+    ShaderBudget budget_;
+    std::shared_ptr<Job> job_;
+    std::thread worker_;
+    std::uint32_t consecutive_overruns_;
+    bool demoted_;
+    ShaderTimings timings_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_SHADER_WATCHDOG_HPP_INCLUDED
@@ -0,0 +1,71 @@
+#ifndef RGBCTL_SHADER_WATCHER_HPP_INCLUDED
+#define RGBCTL_SHADER_WATCHER_HPP_INCLUDED
+
+#include "./native_shader_compiler.hpp"
+#include "./shader_slot.hpp"
+#include <atomic>
+#include <cinttypes>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rgbctl
+{
+
+/* Watches user shader sources with inotify and, whenever one is saved,
+ * recompiles it with TCC on the watcher's own thread and publishes it
+ * into its slot, so the animation thread picks it up between frames.
+ * A shader that fails to compile is reported on `stderr` and the slot
+ * keeps running the previous one.
+ *
+ * Each source file's directory is watched, rather than the file, so
+ * that editors which save by renaming a new file over the old one are
+ * still noticed.
+ *
+ * If given a `NativeShaderCompiler`, which must outlive the watcher,
+ * each reloaded shader is also handed to it to be rebuilt natively.
+ */
+struct ShaderWatcher
+{
+    explicit ShaderWatcher(NativeShaderCompiler* native_compiler = nullptr);
+    ~ShaderWatcher();
+
+    ShaderWatcher(ShaderWatcher const&) = delete;
+    auto operator=(ShaderWatcher const&) -> ShaderWatcher& = delete;
+
+    auto watch(std::filesystem::path const& source,
+               std::shared_ptr<ShaderSlot> slot) -> void;
+
+    /* The number of reloads attempted so far, whether or not they
+     * compiled...
+     */
+    auto reload_count() const noexcept -> std::uint32_t;
+
+private:
+    struct Watch
+    {
+        int descriptor;
+        std::filesystem::path source;
+        std::shared_ptr<ShaderSlot> slot;
+    };
+
+    auto run() -> void;
+
+    auto changed(int descriptor, char const* name) -> std::vector<Watch>;
+
+    auto reload(Watch const&) -> void;
+
+    NativeShaderCompiler* native_compiler_;
+    int inotify_fd_;
+    int stop_fds_[2];
+    std::mutex watches_mutex_;
+    std::vector<Watch> watches_;
+    std::atomic<std::uint32_t> reloads_;
+    std::thread thread_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_SHADER_WATCHER_HPP_INCLUDED
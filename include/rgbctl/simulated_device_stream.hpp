@@ -0,0 +1,102 @@
+#ifndef RGBCTL_SIMULATED_DEVICE_STREAM_HPP_INCLUDED
+#define RGBCTL_SIMULATED_DEVICE_STREAM_HPP_INCLUDED
+
+#include "./rgbctl.h"
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+#include <deque>
+#include <span>
+#include <vector>
+
+namespace rgbctl
+{
+
+/* The devices whose protocols a `SimulatedDeviceStream` can speak,
+ * named after the builtin drivers for them...
+ */
+enum class SimulatedProtocol
+{
+    CorsairH100iProXt,
+    AsusX570
+};
+
+struct SimulatedDeviceLimits
+{
+    /* How long after a report is written its response can be read.
+     * Reading before then blocks, as it would on a real device...
+     */
+    std::chrono::microseconds response_latency { 0 };
+
+    /* Writes block until the device could have taken them at this
+     * rate. Zero means no limit...
+     */
+    std::uint32_t bytes_per_second = 0;
+
+    /* A full speed USB device's interrupt endpoint: one 64 byte packet
+     * per 1ms frame, with its response a frame later.
+     */
+    static auto usb_full_speed() noexcept -> SimulatedDeviceLimits;
+};
+
+struct SimulatedDeviceStats
+{
+    std::uint64_t reports = 0;
+    std::uint64_t frames = 0;
+    std::uint64_t bytes_written = 0;
+    std::uint64_t bytes_read = 0;
+    std::uint64_t checksum_errors = 0;
+    std::uint64_t sequence_errors = 0;
+    std::uint64_t protocol_errors = 0;
+};
+
+/* A `ReadWriteStream` for `DeviceContext` that behaves like one of the
+ * builtin drivers' devices, so the whole pipeline can be run, and load
+ * tested with as many devices as we like, without any hardware. Reports
+ * are checked like the device would check them, and the colours they
+ * carry are kept for inspection...
+ */
+struct SimulatedDeviceStream
+{
+    explicit SimulatedDeviceStream(SimulatedProtocol,
+                                   SimulatedDeviceLimits = {});
+
+    auto read(unsigned char*, std::uint32_t) noexcept -> rgbctl_errno;
+    auto write(unsigned char const*, std::uint32_t) noexcept -> rgbctl_errno;
+
+    auto protocol() const noexcept -> SimulatedProtocol;
+    auto stats() const noexcept -> SimulatedDeviceStats const&;
+
+    /* The colour of each LED, as last written by a colour report...
+     */
+    auto leds() const noexcept -> std::span<rgbctl_rgb_value const>;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Response
+    {
+        Clock::time_point ready_at;
+        std::vector<unsigned char> data;
+    };
+
+    auto report_size() const noexcept -> std::size_t;
+    auto on_report(Clock::time_point written_at) -> void;
+    auto on_corsair_report() -> std::vector<unsigned char>;
+    auto on_asus_report() -> std::vector<unsigned char>;
+    auto respond(Clock::time_point written_at,
+                 std::vector<unsigned char> data) -> void;
+
+    SimulatedProtocol protocol_;
+    SimulatedDeviceLimits limits_;
+    SimulatedDeviceStats stats_;
+    std::vector<unsigned char> report_;
+    std::deque<Response> responses_;
+    std::vector<rgbctl_rgb_value> leds_;
+    Clock::time_point busy_until_;
+    std::uint8_t last_sequence_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_SIMULATED_DEVICE_STREAM_HPP_INCLUDED
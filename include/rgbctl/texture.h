@@ -1,6 +1,8 @@
 #ifndef RGBCTL_TEXTURE_H_INCLUDED
 #define RGBCTL_TEXTURE_H_INCLUDED
 
+#include <inttypes.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -21,6 +23,17 @@ struct rgbctl_rgb_float_value
 struct rgbctl_rgb_float_value
 rgb_sample_texture(struct rgbctl_texture const*, float x, float y, int);
 
+/* Samples `n` texels in one call, at the coordinates `(x[i], y[i])`,
+ * writing each to `out[i]`...
+ */
+void
+rgb_sample_texture_n(struct rgbctl_texture const*,
+                     float const* x,
+                     float const* y,
+                     uint32_t n,
+                     int,
+                     struct rgbctl_rgb_float_value* out);
+
 #ifdef __cplusplus
 }
 #endif
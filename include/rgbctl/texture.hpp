@@ -1,9 +1,12 @@
 #ifndef RGBCTL_TEXTURE_HPP_INCLUDED
 #define RGBCTL_TEXTURE_HPP_INCLUDED
 
+#include "./colour_space.hpp"
 #include "./rgb.hpp"
 #include "./texture.h"
+#include "./texture_file.hpp"
 #include <cstddef>
+#include <memory>
 #include <span>
 #include <vector>
 
@@ -24,28 +27,110 @@ enum class Filtering
 {
 } texture_filtering_linear;
 
+/* Where samples outside the texture, from 0 to 1 along each axis, are
+ * taken from. `Wrap` repeats the texture, `Clamp` extends its edges and
+ * `Mirror` repeats it flipped every other time...
+ */
+enum class Addressing
+{
+    Wrap,
+    Clamp,
+    Mirror
+};
+
+/* How a texture's smaller levels are built, each half the size of the
+ * last, down to a single texel. Sampling a level with about as many
+ * texels as there are LEDs stops a wide texture aliasing on a short
+ * zone. `Box` averages each pair of texels, and `Lanczos` uses a wider
+ * two lobe filter that keeps gradients sharper...
+ */
+enum class Mipmaps
+{
+    None,
+    Box,
+    Lanczos
+};
+
 } // namespace rgbctl
 
 struct rgbctl_texture
 {
     static std::size_t constexpr one_row = static_cast<std::size_t>(-1);
 
-    rgbctl_texture(std::span<rgbctl::RgbFloat const> texels,
-                   std::size_t width = one_row);
+    /* `texels` are sRGB, converted to `colour_space` up front. There
+     * must be some, and `width` must divide how many...
+     */
+    rgbctl_texture(
+        std::span<rgbctl::RgbFloat const> texels,
+        std::size_t width = one_row,
+        rgbctl::ColourSpace colour_space = rgbctl::ColourSpace::Srgb,
+        rgbctl::Mipmaps mipmaps = rgbctl::Mipmaps::None,
+        rgbctl::Addressing addressing = rgbctl::Addressing::Wrap);
+
+    /* Samples `file`'s texels where they're mapped, unless they have to
+     * be converted to `colour_space` or have mipmaps built, in which
+     * case they're copied as from a span...
+     */
+    explicit rgbctl_texture(
+        std::shared_ptr<rgbctl::TextureFile const> file,
+        rgbctl::ColourSpace colour_space = rgbctl::ColourSpace::Srgb,
+        rgbctl::Mipmaps mipmaps = rgbctl::Mipmaps::None,
+        rgbctl::Addressing addressing = rgbctl::Addressing::Wrap);
 
     auto width() const noexcept -> std::size_t;
     auto height() const noexcept -> std::size_t;
+    auto colour_space() const noexcept -> rgbctl::ColourSpace;
+    auto addressing() const noexcept -> rgbctl::Addressing;
 
-    auto sample(rgbctl::Vec<float, 2> const&, rgbctl::Filtering) const noexcept
-        -> rgbctl::RgbFloat;
+    /* The full size texture is level 0...
+     */
+    auto levels() const noexcept -> std::size_t;
+    auto width(std::size_t level) const noexcept -> std::size_t;
+
+    /* The smallest level still at least `sample_count` texels wide, for
+     * sampling across a zone of that many LEDs...
+     */
+    auto level_for(std::size_t sample_count) const noexcept -> std::size_t;
+
+    /* Samples are in the texture's colour space. `rgbctl::to_srgb`
+     * converts them back, best done a zone at a time. A level past the
+     * last samples the last...
+     */
+    auto sample(rgbctl::Vec<float, 2> const&,
+                rgbctl::Filtering,
+                std::size_t level = 0) const noexcept -> rgbctl::RgbFloat;
     auto sample(rgbctl::Vec<float, 2> const&,
-                rgbctl::NearestFiltering) const noexcept -> rgbctl::RgbFloat;
+                rgbctl::NearestFiltering,
+                std::size_t level = 0) const noexcept -> rgbctl::RgbFloat;
     auto sample(rgbctl::Vec<float, 2> const&,
-                rgbctl::LinearFiltering) const noexcept -> rgbctl::RgbFloat;
+                rgbctl::LinearFiltering,
+                std::size_t level = 0) const noexcept -> rgbctl::RgbFloat;
 
 private:
-    std::vector<rgbctl::RgbFloat> texels_;
-    std::size_t width_;
+    struct Level
+    {
+        std::size_t offset;
+        std::size_t width;
+        std::size_t height;
+
+        /* Both sides are powers of two, so wrapping is a mask...
+         */
+        bool power_of_two;
+    };
+
+    auto build(std::vector<rgbctl::RgbFloat>, std::size_t, rgbctl::Mipmaps)
+        -> void;
+    auto level(std::size_t) const noexcept -> Level const&;
+
+    /* The texels are immutable, so copies of a texture share them. They
+     * are either floats or, mapped from an 8 bit texture file, bytes...
+     */
+    std::shared_ptr<void const> storage_;
+    std::span<rgbctl::RgbFloat const> texels_;
+    std::span<rgbctl::RgbUint8 const> bytes_;
+    std::vector<Level> levels_;
+    rgbctl::ColourSpace colour_space_;
+    rgbctl::Addressing addressing_;
 };
 
 namespace rgbctl
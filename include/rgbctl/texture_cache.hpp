@@ -0,0 +1,77 @@
+#ifndef RGBCTL_TEXTURE_CACHE_HPP_INCLUDED
+#define RGBCTL_TEXTURE_CACHE_HPP_INCLUDED
+
+#include "./colour_space.hpp"
+#include "./rgb.hpp"
+#include "./texture.hpp"
+#include "./texture_file.hpp"
+#include <array>
+#include <cinttypes>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace rgbctl
+{
+
+/* Interns textures, so effects and zones asking for the same texels,
+ * size, colour space, mipmaps and addressing share a single immutable
+ * `Texture`. Entries are keyed on a hash of all of those, and keep what
+ * the texture was built from, so a hit is compared before it's shared
+ * and a hash collision just builds another texture. The cache doesn't
+ * keep textures alive. One is freed once nothing samples it, and built
+ * again if it's asked for again. It's safe to use from any thread...
+ */
+struct TextureCache
+{
+    auto get(std::span<RgbFloat const> texels,
+             std::size_t width = Texture::one_row,
+             ColourSpace colour_space = ColourSpace::Srgb,
+             Mipmaps mipmaps = Mipmaps::None,
+             Addressing addressing = Addressing::Wrap)
+        -> std::shared_ptr<Texture const>;
+
+    /* A file's texels are interned with the same texels from a span,
+     * or from another file...
+     */
+    auto get(std::shared_ptr<TextureFile const> file,
+             ColourSpace colour_space = ColourSpace::Srgb,
+             Mipmaps mipmaps = Mipmaps::None,
+             Addressing addressing = Addressing::Wrap)
+        -> std::shared_ptr<Texture const>;
+
+    /* How many textures are still alive...
+     */
+    auto size() const -> std::size_t;
+
+private:
+    using Parameters = std::array<std::uint64_t, 5>;
+
+    struct Entry
+    {
+        std::weak_ptr<Texture const> texture;
+        Parameters parameters;
+
+        /* A copy of the texels the texture was built from, or the file
+         * they're mapped from. The texture keeps the file alive...
+         */
+        std::vector<std::byte> texels;
+        std::weak_ptr<TextureFile const> file;
+    };
+
+    template <typename Create>
+    auto intern(Parameters const& parameters,
+                std::span<std::byte const> texels,
+                std::shared_ptr<TextureFile const> file,
+                Create&& create) -> std::shared_ptr<Texture const>;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::uint64_t, Entry> entries_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_TEXTURE_CACHE_HPP_INCLUDED
@@ -0,0 +1,106 @@
+#ifndef RGBCTL_TEXTURE_FILE_HPP_INCLUDED
+#define RGBCTL_TEXTURE_FILE_HPP_INCLUDED
+
+#include "./rgb.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace rgbctl
+{
+
+/* A texture file is a header and its texels, laid out so the file can
+ * be mapped and sampled where it lies. It starts with
+ * `kTextureFileMagic`, then
+ *
+ *   width      4 bytes, little endian
+ *   height     4 bytes, little endian
+ *   format     1 byte, a `TexelFormat`
+ *   reserved   3 bytes, zero
+ *   frames     4 bytes, little endian, where 0 means 1
+ *   texels     `width * height` sRGB texels for each frame, a row at
+ *              a time
+ *
+ * The header is 24 bytes, so float texels are aligned wherever the file
+ * is mapped. A file of more than one frame is an animation, played by
+ * `TextureStream`...
+ */
+unsigned char constexpr kTextureFileMagic[] = { 'R', 'G', 'B', 'C',
+                                                'T', 'L', 'X', 1 };
+
+enum class TexelFormat : std::uint8_t
+{
+    /* Three little endian floats, from 0 to 1...
+     */
+    Float = 1,
+
+    /* Three bytes, from 0 to 255...
+     */
+    Uint8 = 2
+};
+
+std::size_t constexpr kTextureFileHeaderSize = 24;
+
+struct TextureFileHeader
+{
+    std::size_t width;
+    std::size_t height;
+    TexelFormat format;
+    std::size_t frames;
+
+    /* The bytes taken by each frame's texels...
+     */
+    auto frame_size() const noexcept -> std::size_t;
+};
+
+/* Throws if `header` doesn't start a texture file...
+ */
+auto parse_texture_file_header(std::span<unsigned char const> header)
+    -> TextureFileHeader;
+
+/* A texture file, mapped read only. Nothing is copied, so a texture
+ * costs no heap however large it is, and processes sampling the same
+ * file share its pages. Only an animation's first frame is sampled...
+ */
+struct TextureFile
+{
+    /* Throws if `path` can't be mapped or isn't a complete texture
+     * file...
+     */
+    explicit TextureFile(std::filesystem::path const& path);
+    ~TextureFile();
+
+    TextureFile(TextureFile const&) = delete;
+    auto operator=(TextureFile const&) -> TextureFile& = delete;
+
+    auto width() const noexcept -> std::size_t;
+    auto height() const noexcept -> std::size_t;
+    auto format() const noexcept -> TexelFormat;
+    auto frames() const noexcept -> std::size_t;
+
+    /* The first frame's texels, in whichever of these matches
+     * `format()`. The other is empty...
+     */
+    auto texels() const noexcept -> std::span<RgbFloat const>;
+    auto bytes() const noexcept -> std::span<RgbUint8 const>;
+
+private:
+    void* mapping_;
+    std::size_t mapped_size_;
+    TextureFileHeader header_;
+};
+
+/* Writes `texels`, `width` to a row, as a texture file of `frames`
+ * frames, one after another. `Uint8` rounds each channel to the nearest
+ * of 256 levels...
+ */
+auto write_texture_file(std::filesystem::path const& path,
+                        std::span<RgbFloat const> texels,
+                        std::size_t width,
+                        TexelFormat format = TexelFormat::Float,
+                        std::size_t frames = 1) -> void;
+
+} // namespace rgbctl
+
+#endif // RGBCTL_TEXTURE_FILE_HPP_INCLUDED
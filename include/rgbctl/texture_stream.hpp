@@ -0,0 +1,93 @@
+#ifndef RGBCTL_TEXTURE_STREAM_HPP_INCLUDED
+#define RGBCTL_TEXTURE_STREAM_HPP_INCLUDED
+
+#include "./colour_space.hpp"
+#include "./texture.hpp"
+#include "./texture_file.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rgbctl
+{
+
+/* Plays an animated texture file a frame at a time, without loading
+ * all of it. A reader thread decodes the frames after the one being
+ * shown into a ring of `read_ahead` textures, and waits for room once
+ * the ring is full, so only a few frames are ever in memory however
+ * long the animation is.
+ *
+ * Frames are numbered from the start of playback, and wrap around the
+ * animation, so a stream loops for as long as it's played...
+ */
+struct TextureStream
+{
+    explicit TextureStream(std::filesystem::path const& path,
+                           ColourSpace colour_space = ColourSpace::Srgb,
+                           Mipmaps mipmaps = Mipmaps::None,
+                           std::size_t read_ahead = 4);
+    ~TextureStream();
+
+    TextureStream(TextureStream const&) = delete;
+    auto operator=(TextureStream const&) -> TextureStream& = delete;
+
+    auto width() const noexcept -> std::size_t;
+    auto height() const noexcept -> std::size_t;
+    auto frames() const noexcept -> std::size_t;
+
+    /* The texture for `frame`. If the reader has fallen behind, this is
+     * the latest frame before it that's been decoded, and counts as
+     * late. It only waits for the reader on the first call, and when
+     * `frame` is before the last one returned, which restarts reading
+     * from `frame`. Rethrows anything the reader failed with...
+     */
+    auto frame(std::size_t frame) -> std::shared_ptr<Texture const>;
+
+    /* How many times `frame()` returned an earlier frame than asked
+     * for...
+     */
+    auto late() const -> std::size_t;
+
+    /* How many decoded frames are waiting in the ring...
+     */
+    auto buffered() const -> std::size_t;
+
+private:
+    struct Decoded
+    {
+        std::size_t frame;
+        std::shared_ptr<Texture const> texture;
+    };
+
+    auto run() -> void;
+    auto decode(std::size_t frame) -> std::shared_ptr<Texture const>;
+    auto consume(std::size_t frame) -> void;
+
+    int file_no_;
+    TextureFileHeader header_;
+    ColourSpace colour_space_;
+    Mipmaps mipmaps_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<Decoded> ring_;
+    std::size_t first_;
+    std::size_t count_;
+    Decoded current_;
+    std::size_t next_;
+    std::size_t generation_;
+    std::size_t late_;
+    std::exception_ptr error_;
+    bool stop_;
+
+    std::thread thread_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_TEXTURE_STREAM_HPP_INCLUDED
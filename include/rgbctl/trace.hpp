@@ -0,0 +1,57 @@
+#ifndef RGBCTL_TRACE_HPP_INCLUDED
+#define RGBCTL_TRACE_HPP_INCLUDED
+
+#include "./utils.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <iosfwd>
+
+/* Records the time until the end of the enclosing scope as an event
+ * named `name`, which must be a string literal. Costs one relaxed load
+ * when tracing isn't enabled...
+ */
+#define RGBCTL_TRACE_SCOPE(name) ::rgbctl::trace::Scope RGBCTL_UNUSED() { name }
+
+namespace rgbctl::trace
+{
+
+/* Starts recording. Each thread records into a ring buffer of its own,
+ * holding its last `events_per_thread` events, so recording never
+ * takes a lock. The only lock is taken once per thread, the first time
+ * it records anything, and if that thread's buffer can't be allocated
+ * its events are dropped...
+ */
+auto enable(std::size_t events_per_thread = 1 << 16) -> void;
+
+auto enabled() noexcept -> bool;
+
+/* Monotonic nanoseconds, the clock that events are recorded against.
+ */
+auto now() noexcept -> std::uint64_t;
+
+auto record(char const* name,
+            std::uint64_t start_ns,
+            std::uint64_t end_ns) noexcept -> void;
+
+/* Writes every recorded event in the Chrome trace event format, which
+ * can be loaded into `chrome://tracing` or Perfetto. Best called once
+ * the other threads have stopped recording...
+ */
+auto write_json(std::ostream&) -> void;
+
+struct Scope
+{
+    explicit Scope(char const* name) noexcept;
+    ~Scope();
+
+    Scope(Scope const&) = delete;
+    auto operator=(Scope const&) -> Scope& = delete;
+
+private:
+    char const* name_;
+    std::uint64_t start_ns_;
+};
+
+} // namespace rgbctl::trace
+
+#endif // RGBCTL_TRACE_HPP_INCLUDED
@@ -0,0 +1,158 @@
+#ifndef RGBCTL_TRAFFIC_LOG_HPP_INCLUDED
+#define RGBCTL_TRAFFIC_LOG_HPP_INCLUDED
+
+#include "./rgbctl.h"
+#include "./trace.hpp"
+#include <cinttypes>
+#include <filesystem>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace rgbctl
+{
+
+/* A traffic log holds every read and write made through a device's
+ * stream. It starts with `kTrafficLogMagic`, then each transfer is
+ *
+ *   kind             1 byte, a `TrafficDirection`, with the top bit
+ *                    set if the transfer failed
+ *   start            varint, nanoseconds since the last transfer
+ *                    started (or since recording started)
+ *   duration         varint, nanoseconds
+ *   requested        varint, the bytes asked for
+ *   length | error   varint, the bytes transferred or, if the transfer
+ *                    failed, the `RGBCTL_ERR_*` it failed with
+ *   data             `length` bytes
+ *
+ * Varints are LEB128, so a report sent once a frame and taking a few
+ * hundred microseconds costs 9 bytes on top of the report itself...
+ */
+unsigned char constexpr kTrafficLogMagic[] = { 'R', 'G', 'B', 'C',
+                                               'T', 'L', 'T', 2 };
+
+enum class TrafficDirection : std::uint8_t
+{
+    Read = 1,
+    Write = 2
+};
+
+struct TrafficRecord
+{
+    TrafficDirection direction;
+
+    /* Nanoseconds since recording started...
+     */
+    std::uint64_t start_ns;
+    std::uint64_t duration_ns;
+
+    /* The length passed to the stream, which a transfer can fall short
+     * of...
+     */
+    std::uint32_t requested;
+
+    /* As returned by the stream: the bytes transferred, or a negated
+     * `RGBCTL_ERR_*`...
+     */
+    rgbctl_errno result;
+    std::vector<unsigned char> data;
+};
+
+/* Appends transfers to a traffic log. They're encoded into memory and
+ * written out in blocks, so recording a transfer normally costs a copy
+ * and no system call...
+ */
+struct TrafficRecorder
+{
+    explicit TrafficRecorder(std::filesystem::path const&);
+    ~TrafficRecorder();
+
+    TrafficRecorder(TrafficRecorder const&) = delete;
+    auto operator=(TrafficRecorder const&) -> TrafficRecorder& = delete;
+
+    auto record(TrafficDirection,
+                std::uint64_t start_ns,
+                std::uint64_t end_ns,
+                std::uint32_t requested,
+                rgbctl_errno result,
+                unsigned char const* data) noexcept -> void;
+
+    /* Writes out everything recorded so far...
+     */
+    auto flush() noexcept -> void;
+
+    /* Transfers that couldn't be recorded, for want of memory or
+     * because the log couldn't be written...
+     */
+    auto dropped() const noexcept -> std::uint64_t;
+
+private:
+    int file_no_;
+    std::uint64_t last_start_ns_;
+    std::uint64_t dropped_;
+    std::uint64_t buffered_;
+    std::vector<unsigned char> buffer_;
+};
+
+/* Throws if `path` can't be read or isn't a complete traffic log...
+ */
+auto read_traffic_log(std::filesystem::path const& path)
+    -> std::vector<TrafficRecord>;
+
+/* Records everything read from and written to `ReadWriteStream`, so
+ * the traffic can be replayed later with `ReplayStream`...
+ */
+template <typename ReadWriteStream>
+struct RecordingStream
+{
+    RecordingStream(ReadWriteStream inner, std::filesystem::path const& log)
+        : inner_ { std::move(inner) }
+        , recorder_ { std::make_unique<TrafficRecorder>(log) }
+    { }
+
+    auto read(unsigned char* buffer, std::uint32_t len) noexcept
+        -> rgbctl_errno
+    {
+        auto const start_ns = trace::now();
+        auto const result = inner_.read(buffer, len);
+        recorder_->record(TrafficDirection::Read,
+                          start_ns,
+                          trace::now(),
+                          len,
+                          result,
+                          buffer);
+        return result;
+    }
+
+    auto write(unsigned char const* buffer, std::uint32_t len) noexcept
+        -> rgbctl_errno
+    {
+        auto const start_ns = trace::now();
+        auto const result = inner_.write(buffer, len);
+        recorder_->record(TrafficDirection::Write,
+                          start_ns,
+                          trace::now(),
+                          len,
+                          result,
+                          buffer);
+        return result;
+    }
+
+    auto inner() noexcept -> ReadWriteStream&
+    {
+        return inner_;
+    }
+
+    auto recorder() noexcept -> TrafficRecorder&
+    {
+        return *recorder_;
+    }
+
+private:
+    ReadWriteStream inner_;
+    std::unique_ptr<TrafficRecorder> recorder_;
+};
+
+} // namespace rgbctl
+
+#endif // RGBCTL_TRAFFIC_LOG_HPP_INCLUDED
@@ -0,0 +1,64 @@
+#ifndef RGBCTL_USER_SHADER_HPP_INCLUDED
+#define RGBCTL_USER_SHADER_HPP_INCLUDED
+
+#include "./shader.h"
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace rgbctl
+{
+
+struct ShaderCompileError : std::runtime_error
+{
+    explicit ShaderCompileError(std::string const&);
+};
+
+/* A compiled user shader. Copies share ownership of the compiled
+ * code, which stays loaded until the last copy is destroyed.
+ */
+struct UserShader
+{
+    UserShader() noexcept;
+    UserShader(rgbctl_shader entry, std::shared_ptr<void const> code) noexcept;
+
+    auto operator()(rgbctl_shader_input const&,
+                    std::span<rgbctl_rgb_float_value>) const -> void;
+
+    explicit operator bool() const noexcept;
+
+private:
+    rgbctl_shader entry_;
+    std::shared_ptr<void const> code_;
+};
+
+auto compile_user_shader(std::string const& source) -> UserShader;
+
+auto compile_user_shader_file(std::filesystem::path const&) -> UserShader;
+
+auto read_user_shader_source(std::filesystem::path const&) -> std::string;
+
+/* Compiles a shader into a shared object at `output`, rather than
+ * into memory. The shared object expects the host program to export
+ * the texture API.
+ */
+auto compile_user_shader_library(std::string const& source,
+                                 std::filesystem::path const& output) -> void;
+
+auto load_user_shader_library(std::filesystem::path const&) -> UserShader;
+
+/* A path next to `output` to build a shared object at before renaming
+ * it into place. Each call gets its own, so threads and processes
+ * building the same shader at once don't write over each other.
+ */
+auto user_shader_temporary_path(std::filesystem::path const& output)
+    -> std::filesystem::path;
+
+auto user_shader_compiler_id() -> std::string const&;
+
+} // namespace rgbctl
+
+#endif // RGBCTL_USER_SHADER_HPP_INCLUDED
@@ -1,8 +1,77 @@
 #include "rgbctl/rgbctl.h"
+#include <stddef.h>
+
+uint32_t const rgbctl_module_abi_version = RGBCTL_MODULE_ABI_VERSION;
+
+static struct rgbctl_product_id const products[] = { { 0xffff, 0x0001 } };
+
+static struct rgbctl_zone const zones[] = {
+    { 8, "Test zone", RGBCTL_CHANNEL_ORDER_RGB }
+};
+
+static rgbctl_errno on_rgb_data(struct rgbctl_device_context* ctx,
+                                uint32_t zone_index,
+                                struct rgbctl_rgb_value const* rgb_data,
+                                uint32_t rgb_data_count,
+                                void* user_data)
+{
+    (void)(ctx);
+    (void)(rgb_data);
+    (void)(user_data);
+
+    if (zone_index >= sizeof(zones) / sizeof(zones[0]))
+        return -RGBCTL_ERR_WRITE;
+
+    return (rgbctl_errno)rgb_data_count;
+}
+
+static rgbctl_errno on_query_zones(struct rgbctl_device_context* ctx,
+                                   struct rgbctl_zone const** zones_out,
+                                   void* user_data)
+{
+    (void)(ctx);
+    (void)(user_data);
+
+    *zones_out = zones;
+    return (rgbctl_errno)(sizeof(zones) / sizeof(zones[0]));
+}
+
+static void on_release(struct rgbctl_device_context* ctx, void* user_data)
+{
+    (void)(ctx);
+    (void)(user_data);
+}
+
+static void on_shutdown(void* user_data)
+{
+    (void)(user_data);
+}
+
+static struct rgbctl_module module = {
+    on_rgb_data, on_query_zones, on_release, on_shutdown
+};
+
+static rgbctl_errno acquire(struct rgbctl_device_context* ctx,
+                            struct rgbctl_product_id id,
+                            struct rgbctl_module_acquisition* acquisition,
+                            void* user_data)
+{
+    (void)(ctx);
+    (void)(id);
+    (void)(user_data);
+
+    acquisition->module = &module;
+    acquisition->user_data = NULL;
+
+    return RGBCTL_SUCCESS;
+}
 
 rgbctl_errno init(struct rgbctl_module_registration* reg)
 {
-    (void)(reg);
+    reg->products = products;
+    reg->product_count = sizeof(products) / sizeof(products[0]);
+    reg->acquire_callback = acquire;
+    reg->user_data = NULL;
 
-    return -RGBCTL_ERR_NOT_IMPLEMENTED;
+    return RGBCTL_SUCCESS;
 }
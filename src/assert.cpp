@@ -7,8 +7,9 @@
 namespace rgbctl
 {
 
-[[noreturn]] auto condition_failure(char const* condition,
-                                    char const* type) noexcept -> void
+[[noreturn]] auto condition_failure([[maybe_unused]] char const* condition,
+                                    [[maybe_unused]] char const* type) noexcept
+    -> void
 {
 #ifndef NDEBUG
     std::fprintf(stderr, "ASSERT: %s failed - %s\n", type, condition);
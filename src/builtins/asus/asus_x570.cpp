@@ -93,7 +93,9 @@ auto AsusX570::on_acquire(rgbctl_device_context* ctx) noexcept -> rgbctl_errno
     return RGBCTL_SUCCESS;
 }
 
-rgbctl_zone constexpr kZones[] = { { 4, "Mainboard LEDs" } };
+rgbctl_zone constexpr kZones[] = {
+    { 4, "Mainboard LEDs", RGBCTL_CHANNEL_ORDER_RGB }
+};
 
 auto AsusX570::on_rgb_data(rgbctl_device_context* ctx,
                            std::uint32_t zone_index,
@@ -2,6 +2,7 @@
 #define RGBCTL_BUILTINS_BASE_MODULE_HPP_INCLUDED
 
 #include "rgbctl/rgbctl.h"
+#include "rgbctl/trace.hpp"
 #include <cassert>
 #include <memory>
 #include <type_traits>
@@ -43,6 +44,8 @@ struct BaseModule : rgbctl_module
         static_assert(std::is_standard_layout_v<Report>,
                       "Must be standard layout");
 
+        RGBCTL_TRACE_SCOPE("BaseModule::write_report");
+
         std::size_t written = 0;
         while (written < sizeof(rpt)) {
             auto result = rgbctl_write(
@@ -66,6 +69,8 @@ struct BaseModule : rgbctl_module
         static_assert(std::is_standard_layout_v<Report>,
                       "Must be standard layout");
 
+        RGBCTL_TRACE_SCOPE("BaseModule::read_report");
+
         std::size_t bytes_read = 0;
         while (bytes_read < sizeof(rpt)) {
             auto result = rgbctl_read(
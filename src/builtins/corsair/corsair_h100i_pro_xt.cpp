@@ -262,7 +262,10 @@ auto zone_map_iterator(ZoneMap map,
     return ZoneMapIterator<N> { map, output };
 }
 
-rgbctl_zone constexpr kZones[] = { { 4, "Center" }, { 12, "Ring" } };
+/* Red and blue channels are swapped on this device...
+ */
+rgbctl_zone constexpr kZones[] = { { 4, "Center", RGBCTL_CHANNEL_ORDER_BGR },
+                                   { 12, "Ring", RGBCTL_CHANNEL_ORDER_BGR } };
 
 std::array<std::size_t, 4> constexpr kCenterZoneMap = { 0, 1, 2, 3 };
 std::array<std::size_t, 12> constexpr kRingZoneMap
@@ -286,21 +289,14 @@ auto CorsairH100iProXt::on_rgb_data(rgbctl_device_context* ctx,
     auto const rgb_count
         = static_cast<std::size_t>(std::min(n, kZones[zone_index].rgb_count));
 
-    std::transform(
-        data,
-        data + rgb_count,
-        zone_map_iterator(kZoneMaps[zone_index], rgb_data_),
-        [](auto const item) {
-            return rgbctl_rgb_value { item.blue, item.green, item.red };
-        });
+    std::copy_n(
+        data, rgb_count, zone_map_iterator(kZoneMaps[zone_index], rgb_data_));
 
     Report<ColourData> rpt {};
     Response rpt_out {};
 
     rpt.sequence_command = 0x04;
 
-    /* Red and blue channels are swapped on this device...
-     */
     std::copy_n(begin(rgb_data_),
                 std::min(std::size_t { n }, std::size(rgb_data_)),
                 std::begin(rpt.report_data.rgbs));
@@ -0,0 +1,186 @@
+#include "rgbctl/canvas.hpp"
+#include "rgbctl/assert.hpp"
+#include "rgbctl/narrow.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+
+namespace rgbctl
+{
+
+auto led_line(std::size_t count, Vec<float, 2> from, Vec<float, 2> to)
+    -> LedLayout
+{
+    LedLayout layout;
+    layout.positions.reserve(count);
+
+    auto const steps
+        = static_cast<float>(std::max(count, std::size_t { 2 }) - 1);
+    for (std::size_t n = 0; n < count; ++n) {
+        auto const t = static_cast<float>(n) / steps;
+        layout.positions.push_back(lerp(from, to, t));
+    }
+
+    return layout;
+}
+
+auto led_ring(std::size_t count, Vec<float, 2> centre, float radius)
+    -> LedLayout
+{
+    auto constexpr kTwoPi = 6.28318530717959f;
+
+    LedLayout layout;
+    layout.positions.reserve(count);
+    for (std::size_t n = 0; n < count; ++n) {
+        auto const angle
+            = kTwoPi * static_cast<float>(n) / static_cast<float>(count);
+        layout.positions.push_back({ centre[0] + radius * std::sin(angle),
+                                     centre[1] - radius * std::cos(angle) });
+    }
+
+    return layout;
+}
+
+Canvas::Canvas(AnyEffect effect, std::size_t width, std::size_t height)
+    : effect_ { std::move(effect) }
+    , width_ { width }
+    , height_ { height }
+    , elapsed_ms_ { 0 }
+    , renders_ { 0 }
+    , pixels_(width * height)
+{
+    if (!width || !height)
+        throw std::invalid_argument { "canvas: empty" };
+}
+
+auto Canvas::width() const noexcept -> std::size_t
+{
+    return width_;
+}
+
+auto Canvas::height() const noexcept -> std::size_t
+{
+    return height_;
+}
+
+auto Canvas::pixels() const noexcept -> std::span<RgbFloat const>
+{
+    return pixels_;
+}
+
+auto Canvas::effect() const noexcept -> AnyEffect const&
+{
+    return effect_;
+}
+
+auto Canvas::advance_to(std::size_t elapsed_ms) -> void
+{
+    if (elapsed_ms <= elapsed_ms_)
+        return;
+
+    effect_.tick(elapsed_ms - elapsed_ms_, pixels_);
+    elapsed_ms_ = elapsed_ms;
+    ++renders_;
+}
+
+auto Canvas::renders() const noexcept -> std::uint64_t
+{
+    return renders_;
+}
+
+CanvasSampler::CanvasSampler(std::uint32_t zone_index,
+                             std::shared_ptr<Canvas> canvas,
+                             LedLayout const& layout)
+    : zone_index_ { zone_index }
+    , canvas_ { std::move(canvas) }
+    , elapsed_ms_ { 0 }
+    , led_count_ { layout.positions.size() }
+    , indices_(layout.positions.size() * kTaps)
+    , weights_(layout.positions.size() * kTaps)
+{
+    RGBCTL_EXPECTS(canvas_);
+
+    auto const width = canvas_->width();
+    auto const height = canvas_->height();
+    if (!can_narrow<std::uint32_t>(width * height))
+        throw std::invalid_argument { "canvas sampler: canvas too large" };
+
+    /* Pixel centres are half a pixel in from the canvas' edges...
+     */
+    auto const axis = [](float position, std::size_t size) {
+        auto const last = static_cast<float>(size - 1);
+        auto const x = std::clamp(
+            position * static_cast<float>(size) - .5f, 0.f, last);
+        auto const low = static_cast<std::size_t>(x);
+        return std::tuple { low,
+                            std::min(low + 1, size - 1),
+                            x - static_cast<float>(low) };
+    };
+
+    for (std::size_t n = 0; n < led_count_; ++n) {
+        auto const& position = layout.positions[n];
+        auto const [left, right, u] = axis(position[0], width);
+        auto const [top, bottom, v] = axis(position[1], height);
+
+        auto* indices = indices_.data() + n * kTaps;
+        indices[0] = static_cast<std::uint32_t>(top * width + left);
+        indices[1] = static_cast<std::uint32_t>(top * width + right);
+        indices[2] = static_cast<std::uint32_t>(bottom * width + left);
+        indices[3] = static_cast<std::uint32_t>(bottom * width + right);
+
+        auto* weights = weights_.data() + n * kTaps;
+        weights[0] = (1.f - u) * (1.f - v);
+        weights[1] = u * (1.f - v);
+        weights[2] = (1.f - u) * v;
+        weights[3] = u * v;
+    }
+}
+
+auto CanvasSampler::zone_index() const noexcept -> std::uint32_t
+{
+    return zone_index_;
+}
+
+auto CanvasSampler::rgb_count() const noexcept -> std::size_t
+{
+    return led_count_;
+}
+
+auto CanvasSampler::duration() const noexcept -> std::size_t
+{
+    return canvas_->effect().duration();
+}
+
+auto CanvasSampler::remaining() const noexcept -> std::size_t
+{
+    return canvas_->effect().remaining();
+}
+
+auto CanvasSampler::tick(std::size_t ms, std::span<RgbFloat> out_frame)
+    -> std::size_t
+{
+    elapsed_ms_ += ms;
+    canvas_->advance_to(elapsed_ms_);
+
+    auto const pixels = canvas_->pixels();
+    auto const count = std::min(led_count_, out_frame.size());
+    for (std::size_t n = 0; n < count; ++n) {
+        auto const* indices = indices_.data() + n * kTaps;
+        auto const* weights = weights_.data() + n * kTaps;
+
+        RgbFloat colour { 0.f, 0.f, 0.f };
+        for (std::size_t k = 0; k < kTaps; ++k)
+            colour += pixels[indices[k]] * weights[k];
+
+        out_frame[n] = colour;
+    }
+
+    std::fill(out_frame.begin() + static_cast<std::ptrdiff_t>(count),
+              out_frame.end(),
+              RgbFloat { 0.f, 0.f, 0.f });
+
+    return count;
+}
+
+} // namespace rgbctl
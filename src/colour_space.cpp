@@ -0,0 +1,210 @@
+#include "rgbctl/colour_space.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cinttypes>
+
+namespace
+{
+
+using rgbctl::RgbFloat;
+
+template <int N>
+auto power(float x) noexcept -> float
+{
+    if constexpr (N == 1)
+        return x;
+    else
+        return x * power<N - 1>(x);
+}
+
+/* The `N`th root of a non-negative `x`. Dividing the float's bits, as
+ * an integer, by `N` gets within a few percent, and Newton's method
+ * gets the rest, so there are no library calls to stop the compiler
+ * vectorising...
+ */
+template <int N>
+auto root(float x) noexcept -> float
+{
+    auto constexpr kOne = std::uint32_t { 0x3f800000 };
+    auto y = std::bit_cast<float>(
+        std::bit_cast<std::uint32_t>(x) / N + kOne / N * (N - 1));
+
+    for (int n = 0; n < 3; ++n)
+        y = (static_cast<float>(N - 1) * y + x / power<N - 1>(y)) / N;
+
+    return y;
+}
+
+auto srgb_to_linear(float value) noexcept -> float
+{
+    auto const x = std::max(value, 0.f);
+    auto const curve = std::max((x + .055f) / 1.055f, 0.f);
+    auto const curve_fifth = root<5>(curve);
+    return x <= .04045f ? x / 12.92f
+                        : curve * curve * curve_fifth * curve_fifth;
+}
+
+auto linear_to_srgb(float value) noexcept -> float
+{
+    auto const x = std::max(value, 0.f);
+    auto const cube_root = root<3>(x);
+    auto const curve = 1.055f * cube_root * root<4>(cube_root) - .055f;
+    return x <= .0031308f ? x * 12.92f : curve;
+}
+
+/* A block of colours, one array per channel, so the conversions that
+ * mix channels vectorise across colours rather than within one...
+ */
+std::size_t constexpr kBlockSize = 64;
+
+struct Planes
+{
+    std::array<float, kBlockSize> x, y, z;
+
+    auto load(std::span<RgbFloat const> colours) noexcept -> void
+    {
+        for (std::size_t n = 0; n < colours.size(); ++n) {
+            x[n] = colours[n][0];
+            y[n] = colours[n][1];
+            z[n] = colours[n][2];
+        }
+    }
+
+    auto store(std::span<RgbFloat> colours) const noexcept -> void
+    {
+        for (std::size_t n = 0; n < colours.size(); ++n) {
+            colours[n][0] = x[n];
+            colours[n][1] = y[n];
+            colours[n][2] = z[n];
+        }
+    }
+};
+
+/* Björn Ottosson's OKLab, from linear sRGB...
+ */
+auto linear_to_oklab(Planes& block) noexcept -> void
+{
+    for (std::size_t n = 0; n < kBlockSize; ++n) {
+        auto const r = std::max(block.x[n], 0.f);
+        auto const g = std::max(block.y[n], 0.f);
+        auto const b = std::max(block.z[n], 0.f);
+
+        auto const l = root<3>(
+            0.4122214708f * r + 0.5363325363f * g + 0.0514459929f * b);
+        auto const m = root<3>(
+            0.2119034982f * r + 0.6806995451f * g + 0.1073969566f * b);
+        auto const s = root<3>(
+            0.0883024619f * r + 0.2817188376f * g + 0.6299787005f * b);
+
+        block.x[n] = 0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s;
+        block.y[n] = 1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s;
+        block.z[n] = 0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s;
+    }
+}
+
+auto oklab_to_linear(Planes& block) noexcept -> void
+{
+    for (std::size_t n = 0; n < kBlockSize; ++n) {
+        auto const lightness = block.x[n];
+        auto const a = block.y[n];
+        auto const b = block.z[n];
+
+        auto const l_ = lightness + 0.3963377774f * a + 0.2158037573f * b;
+        auto const m_ = lightness - 0.1055613458f * a - 0.0638541728f * b;
+        auto const s_ = lightness - 0.0894841775f * a - 1.2914855480f * b;
+
+        auto const l = l_ * l_ * l_;
+        auto const m = m_ * m_ * m_;
+        auto const s = s_ * s_ * s_;
+
+        block.x[n] = 4.0767416621f * l - 3.3077115913f * m + 0.2309699292f * s;
+        block.y[n] = -1.2684380046f * l + 2.6097574011f * m - 0.3413193965f * s;
+        block.z[n] = -0.0041960863f * l - 0.7034186147f * m + 1.7076147010f * s;
+    }
+}
+
+template <typename Convert>
+auto convert_blocks(std::span<RgbFloat> colours, Convert convert) noexcept
+    -> void
+{
+    Planes block {};
+    for (std::size_t first = 0; first < colours.size(); first += kBlockSize) {
+        auto const part = colours.subspan(
+            first, std::min(kBlockSize, colours.size() - first));
+        block.load(part);
+        convert(block);
+        block.store(part);
+    }
+}
+
+/* Each channel on its own; the inner loop is over a colour's three
+ * channels, which the compiler unrolls and vectorises across
+ * colours...
+ */
+template <typename Convert>
+auto convert_channels(std::span<RgbFloat> colours, Convert convert) noexcept
+    -> void
+{
+    for (auto& colour : colours) {
+        for (std::size_t c = 0; c < 3; ++c)
+            colour[c] = convert(colour[c]);
+    }
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+auto parse_colour_space(std::string_view name) noexcept
+    -> std::optional<ColourSpace>
+{
+    if (name == "srgb")
+        return ColourSpace::Srgb;
+
+    if (name == "linear")
+        return ColourSpace::LinearRgb;
+
+    if (name == "oklab")
+        return ColourSpace::Oklab;
+
+    return std::nullopt;
+}
+
+auto from_srgb(ColourSpace space, std::span<RgbFloat> colours) noexcept
+    -> void
+{
+    if (space == ColourSpace::Srgb)
+        return;
+
+    convert_channels(colours, srgb_to_linear);
+
+    if (space == ColourSpace::Oklab)
+        convert_blocks(colours, linear_to_oklab);
+}
+
+auto to_srgb(ColourSpace space, std::span<RgbFloat> colours) noexcept -> void
+{
+    if (space == ColourSpace::Srgb)
+        return;
+
+    if (space == ColourSpace::Oklab)
+        convert_blocks(colours, oklab_to_linear);
+
+    convert_channels(colours, linear_to_srgb);
+}
+
+auto from_srgb(ColourSpace space, RgbFloat colour) noexcept -> RgbFloat
+{
+    from_srgb(space, std::span { &colour, 1 });
+    return colour;
+}
+
+auto to_srgb(ColourSpace space, RgbFloat colour) noexcept -> RgbFloat
+{
+    to_srgb(space, std::span { &colour, 1 });
+    return colour;
+}
+
+} // namespace rgbctl
@@ -10,4 +10,16 @@ auto AnyController::tick(std::uint32_t elapsed_milliseconds) -> void
     tick_(inner_.get(), elapsed_milliseconds);
 }
 
+auto AnyController::set_timings(ControllerTimings timings) noexcept -> void
+{
+    RGBCTL_EXPECTS(inner_);
+    set_timings_(inner_.get(), timings);
+}
+
+auto AnyController::set_output(OutputOptions const& options) -> void
+{
+    RGBCTL_EXPECTS(inner_);
+    set_output_(inner_.get(), options);
+}
+
 } // namespace rgbctl
@@ -1,5 +1,6 @@
 #include "rgbctl/effects.hpp"
 #include "rgbctl/assert.hpp"
+#include "rgbctl/trace.hpp"
 
 namespace rgbctl
 {
@@ -27,10 +28,11 @@ auto AnyEffect::remaining() const noexcept -> std::size_t
     return interface_.remaining(inner_.get());
 }
 
-auto AnyEffect::tick(std::size_t ms, std::span<rgbctl_rgb_value> out_val)
+auto AnyEffect::tick(std::size_t ms, std::span<RgbFloat> out_val)
     -> std::size_t
 {
     RGBCTL_EXPECTS(inner_.get());
+    RGBCTL_TRACE_SCOPE("AnyEffect::tick");
     return interface_.tick(inner_.get(), ms, out_val);
 }
 
@@ -0,0 +1,69 @@
+#include "rgbctl/effects/animation.hpp"
+#include "rgbctl/assert.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace rgbctl::effects
+{
+
+Animation::Animation(std::uint32_t zone_index,
+                     std::shared_ptr<TextureStream> stream,
+                     std::size_t frame_ms)
+    : elapsed_ms_ { 0 }
+    , zone_index_ { zone_index }
+    , stream_ { std::move(stream) }
+    , frame_ms_ { frame_ms }
+{
+    RGBCTL_EXPECTS(stream_);
+
+    if (!frame_ms_)
+        throw std::invalid_argument { "animation: no frame period" };
+}
+
+auto Animation::zone_index() const noexcept -> std::uint32_t
+{
+    return zone_index_;
+}
+
+auto Animation::rgb_count() const noexcept -> std::size_t
+{
+    return stream_->width();
+}
+
+auto Animation::duration() const noexcept -> std::size_t
+{
+    return stream_->frames() * frame_ms_;
+}
+
+auto Animation::remaining() const noexcept -> std::size_t
+{
+    return duration() - elapsed_ms_ % duration();
+}
+
+auto Animation::tick(std::size_t ms, std::span<RgbFloat> out_frame)
+    -> std::size_t
+{
+    if (!out_frame.size())
+        return 0;
+
+    /* Elapsed time isn't wrapped at the end of the animation, as the
+     * stream would take a frame before the last as a seek...
+     */
+    elapsed_ms_ += ms;
+    auto const texture = stream_->frame(elapsed_ms_ / frame_ms_);
+
+    auto const level = texture->level_for(out_frame.size());
+    float u = 1 / static_cast<float>(out_frame.size());
+
+    std::size_t n = 0;
+    std::for_each(out_frame.begin(), out_frame.end(), [&](auto& out) {
+        Vec<float, 2> coords { u * static_cast<float>(n++), 0.f };
+        out = texture->sample(coords, Filtering::Linear, level);
+    });
+
+    to_srgb(texture->colour_space(), out_frame);
+    return n;
+}
+
+} // namespace rgbctl::effects
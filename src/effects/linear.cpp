@@ -1,8 +1,9 @@
 #include "rgbctl/effects/linear.hpp"
-
+#include "rgbctl/assert.hpp"
 #include <cassert>
 #include <cinttypes>
 #include <cmath>
+#include <utility>
 
 namespace rgbctl::effects
 {
@@ -10,11 +11,13 @@ namespace rgbctl::effects
 Linear::Linear(std::uint32_t zone_index,
                std::size_t rgb_count,
                std::size_t duration_ms,
-               std::span<RgbFloat const> rgbs)
+               std::span<RgbFloat const> rgbs,
+               TexturePrecision precision,
+               ColourSpace colour_space)
     : elapsed_ms_ { 0 }
     , zone_index_ { zone_index }
     , duration_ms_ { duration_ms }
-    , texture_ { rgbs, rgb_count }
+    , texture_ { make_texture(rgbs, rgb_count, precision, colour_space) }
 {
     /* Ensure we've got the right amount of RGBs
      * in each frame...
@@ -22,6 +25,17 @@ Linear::Linear(std::uint32_t zone_index,
     assert(rgbs.size() % rgb_count == 0);
 }
 
+Linear::Linear(std::uint32_t zone_index,
+               std::size_t duration_ms,
+               std::shared_ptr<Texture const> texture)
+    : elapsed_ms_ { 0 }
+    , zone_index_ { zone_index }
+    , duration_ms_ { duration_ms }
+    , texture_ { std::move(texture) }
+{
+    RGBCTL_EXPECTS(std::get<0>(texture_));
+}
+
 auto Linear::zone_index() const noexcept -> std::uint32_t
 {
     return zone_index_;
@@ -29,7 +43,10 @@ auto Linear::zone_index() const noexcept -> std::uint32_t
 
 auto Linear::rgb_count() const noexcept -> std::size_t
 {
-    return texture_.width();
+    if (auto const* fixed = std::get_if<1>(&texture_))
+        return (*fixed)->width();
+
+    return std::get<0>(texture_)->width();
 }
 
 auto Linear::duration() const noexcept -> std::size_t
@@ -45,7 +62,7 @@ auto Linear::remaining() const noexcept -> std::size_t
     return static_cast<std::size_t>(duration_ms_ - elapsed_ms_);
 }
 
-auto Linear::tick(std::size_t ms, std::span<rgbctl_rgb_value> out_frame)
+auto Linear::tick(std::size_t ms, std::span<RgbFloat> out_frame)
     -> std::size_t
 {
     if (!out_frame.size())
@@ -58,14 +75,28 @@ auto Linear::tick(std::size_t ms, std::span<rgbctl_rgb_value> out_frame)
     float v
         = static_cast<float>(elapsed_ms_) / static_cast<float>(duration_ms_);
 
+    std::size_t n = 0;
+    if (auto const* fixed = std::get_if<1>(&texture_)) {
+        auto const row = to_fixed_coord({ 0.f, v })[1];
+        auto const size = out_frame.size();
+        std::for_each(out_frame.begin(), out_frame.end(), [&](auto& out) {
+            auto const u = static_cast<std::uint32_t>((n++ << 16) / size);
+            out = to_rgb_float(
+                (*fixed)->sample({ u, row }, texture_filtering_linear));
+        });
+
+        return n;
+    }
+
+    auto const& texture = *std::get<0>(texture_);
     float u = 1 / static_cast<float>(out_frame.size());
 
-    std::size_t n = 0;
     std::for_each(out_frame.begin(), out_frame.end(), [&](auto& out) {
         Vec<float, 2> coords { u * static_cast<float>(n++), v };
-        out = to_rgb_uint8(texture_.sample(coords, Filtering::Linear));
+        out = texture.sample(coords, Filtering::Linear);
     });
 
+    to_srgb(texture.colour_space(), out_frame);
     return n;
 }
 
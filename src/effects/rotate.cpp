@@ -1,19 +1,36 @@
 #include "rgbctl/effects/rotate.hpp"
+#include "rgbctl/assert.hpp"
 #include <cassert>
 #include <cmath>
+#include <utility>
 
 namespace rgbctl::effects
 {
 
 Rotate::Rotate(std::uint32_t zone_index,
                std::size_t duration_ms,
-               std::span<RgbFloat const> data)
+               std::span<RgbFloat const> data,
+               TexturePrecision precision,
+               ColourSpace colour_space,
+               Mipmaps mipmaps)
     : elapsed_ms_ { 0 }
     , zone_index_ { zone_index }
     , duration_ms_ { duration_ms }
-    , texture_ { { data.begin(), data.end() } }
+    , texture_ { make_texture(
+          data, Texture::one_row, precision, colour_space, mipmaps) }
 { }
 
+Rotate::Rotate(std::uint32_t zone_index,
+               std::size_t duration_ms,
+               std::shared_ptr<Texture const> texture)
+    : elapsed_ms_ { 0 }
+    , zone_index_ { zone_index }
+    , duration_ms_ { duration_ms }
+    , texture_ { std::move(texture) }
+{
+    RGBCTL_EXPECTS(std::get<0>(texture_));
+}
+
 auto Rotate::zone_index() const noexcept -> std::uint32_t
 {
     return zone_index_;
@@ -21,7 +38,10 @@ auto Rotate::zone_index() const noexcept -> std::uint32_t
 
 auto Rotate::rgb_count() const noexcept -> std::size_t
 {
-    return texture_.width();
+    if (auto const* fixed = std::get_if<1>(&texture_))
+        return (*fixed)->width();
+
+    return std::get<0>(texture_)->width();
 }
 
 auto Rotate::duration() const noexcept -> std::size_t
@@ -37,7 +57,7 @@ auto Rotate::remaining() const noexcept -> std::size_t
     return duration_ms_ - elapsed_ms_;
 }
 
-auto Rotate::tick(std::size_t ms, std::span<rgbctl_rgb_value> out_frame)
+auto Rotate::tick(std::size_t ms, std::span<RgbFloat> out_frame)
     -> std::size_t
 {
     if (!out_frame.size())
@@ -50,14 +70,34 @@ auto Rotate::tick(std::size_t ms, std::span<rgbctl_rgb_value> out_frame)
     float v
         = static_cast<float>(elapsed_ms_) / static_cast<float>(duration_ms_);
 
+    std::size_t n = 0;
+    if (auto const* fixed = std::get_if<1>(&texture_)) {
+        /* Each LED's coordinate is exact, rather than accumulating a
+         * rounded step...
+         */
+        auto const offset = to_fixed_coord({ v, 0.f });
+        auto const size = out_frame.size();
+        std::for_each(out_frame.begin(), out_frame.end(), [&](auto& out) {
+            auto const u = static_cast<std::uint32_t>((n++ << 16) / size);
+            out = to_rgb_float((*fixed)->sample(
+                { u - offset[0], 0u }, texture_filtering_linear));
+        });
+
+        return n;
+    }
+
+    /* One texel per LED, or near it, however wide the texture...
+     */
+    auto const& texture = *std::get<0>(texture_);
+    auto const level = texture.level_for(out_frame.size());
     float u = 1 / static_cast<float>(out_frame.size());
 
-    std::size_t n = 0;
     std::for_each(out_frame.begin(), out_frame.end(), [&](auto& out) {
         Vec<float, 2> coords { u * static_cast<float>(n++) - v, 0.f };
-        out = to_rgb_uint8(texture_.sample(coords, Filtering::Linear));
+        out = texture.sample(coords, Filtering::Linear, level);
     });
 
+    to_srgb(texture.colour_space(), out_frame);
     return n;
 }
 
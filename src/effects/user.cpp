@@ -0,0 +1,160 @@
+#include "rgbctl/effects/user.hpp"
+#include "rgbctl/assert.hpp"
+#include "rgbctl/narrow.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace rgbctl::effects
+{
+
+User::User(std::uint32_t zone_index,
+           std::size_t duration_ms,
+           UserShader shader,
+           std::span<RgbFloat const> data,
+           ShaderBudget budget,
+           ColourSpace colour_space)
+    : User { zone_index,
+             duration_ms,
+             std::make_shared<ShaderSlot>(std::move(shader)),
+             data,
+             budget,
+             colour_space }
+{ }
+
+User::User(std::uint32_t zone_index,
+           std::size_t duration_ms,
+           std::shared_ptr<ShaderSlot> shader,
+           std::span<RgbFloat const> data,
+           ShaderBudget budget,
+           ColourSpace colour_space)
+    : User { zone_index,
+             duration_ms,
+             std::move(shader),
+             std::make_shared<Texture const>(
+                 data, Texture::one_row, colour_space),
+             budget }
+{ }
+
+/* The texture is shared, rather than owned outright, because a shader
+ * abandoned by the watchdog may still be sampling it...
+ */
+User::User(std::uint32_t zone_index,
+           std::size_t duration_ms,
+           std::shared_ptr<ShaderSlot> shader,
+           std::shared_ptr<Texture const> texture,
+           ShaderBudget budget)
+    : elapsed_ms_ { 0 }
+    , zone_index_ { zone_index }
+    , duration_ms_ { duration_ms }
+    , texture_ { std::move(texture) }
+    , shader_ { std::move(shader) }
+    , shader_generation_ { 0 }
+    , watchdog_ { std::make_unique<ShaderWatchdog>(budget) }
+{
+    RGBCTL_EXPECTS(shader_);
+    RGBCTL_EXPECTS(texture_);
+
+    if (!duration_ms_)
+        throw std::invalid_argument { "user effect: no duration" };
+
+    shader_generation_ = shader_->generation();
+}
+
+auto User::zone_index() const noexcept -> std::uint32_t
+{
+    return zone_index_;
+}
+
+auto User::rgb_count() const noexcept -> std::size_t
+{
+    return texture_->width();
+}
+
+auto User::duration() const noexcept -> std::size_t
+{
+    return duration_ms_;
+}
+
+auto User::remaining() const noexcept -> std::size_t
+{
+    if (elapsed_ms_ > duration_ms_)
+        return 0;
+
+    return duration_ms_ - elapsed_ms_;
+}
+
+auto User::tick(std::size_t ms, std::span<RgbFloat> out_frame)
+    -> std::size_t
+{
+    if (!out_frame.size())
+        return 0;
+
+    elapsed_ms_ += ms;
+    if (elapsed_ms_ > duration_ms_)
+        elapsed_ms_ %= duration_ms_;
+
+    float v
+        = static_cast<float>(elapsed_ms_) / static_cast<float>(duration_ms_);
+
+    if (out_frame.size() != u_.size())
+        resize(out_frame.size());
+
+    std::fill(v_.begin(), v_.end(), v);
+
+    rgbctl_shader_input const input {
+        .u = u_.data(),
+        .v = v_.data(),
+        .count = narrow_cast<std::uint32_t>(u_.size()),
+        .stage = v,
+        .elapsed_ms = narrow_cast<std::uint32_t>(elapsed_ms_),
+        .texture = texture_.get(),
+    };
+
+    /* Read the generation first so that, if we race with a publish,
+     * the worst case is resetting the watchdog one frame too often...
+     */
+    auto const generation = shader_->generation();
+    auto const& shader = shader_->acquire();
+    if (generation != shader_generation_) {
+        shader_generation_ = generation;
+        watchdog_->reset();
+    }
+
+    if (shader)
+        watchdog_->run(shader, input, texture_, shaded_);
+    else
+        std::fill(shaded_.begin(), shaded_.end(), rgbctl_rgb_float_value {});
+
+    std::transform(
+        shaded_.begin(), shaded_.end(), out_frame.begin(), [](auto const& c) {
+            return RgbFloat { c.red, c.green, c.blue };
+        });
+
+    return out_frame.size();
+}
+
+auto User::shader_slot() const noexcept -> std::shared_ptr<ShaderSlot> const&
+{
+    return shader_;
+}
+
+auto User::watchdog() const noexcept -> ShaderWatchdog const&
+{
+    return *watchdog_;
+}
+
+/* The LED coordinates along the zone only change with its size, so
+ * they're computed once up front rather than every tick...
+ */
+auto User::resize(std::size_t rgb_count) -> void
+{
+    u_.resize(rgb_count);
+    v_.resize(rgb_count);
+    shaded_.resize(rgb_count);
+
+    float const u = 1 / static_cast<float>(rgb_count);
+    for (std::size_t n = 0; n < rgb_count; ++n)
+        u_[n] = u * static_cast<float>(n);
+}
+
+} // namespace rgbctl::effects
@@ -0,0 +1,178 @@
+#include "rgbctl/fixed_texture.hpp"
+#include "rgbctl/narrow.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+
+using rgbctl::FixedCoord;
+using rgbctl::RgbFixed;
+
+std::uint32_t constexpr kWeightBits = 15;
+
+/* Where a coordinate's fraction falls on an axis `size` texels long, as
+ * the texel it's in and, in Q0.15, how far it is into that texel...
+ */
+struct AxisPosition
+{
+    std::uint32_t index;
+    std::uint32_t next;
+    std::int32_t weight;
+};
+
+auto position(std::uint32_t coord, std::uint32_t size) noexcept
+    -> AxisPosition
+{
+    auto const texels = (coord & 0xffff) * size;
+    auto const index = texels >> 16;
+    auto const weight = (texels & 0xffff) >> (16 - kWeightBits);
+    return { index,
+             index + 1 == size ? 0 : index + 1,
+             static_cast<std::int32_t>(weight) };
+}
+
+auto mix(std::uint16_t a, std::uint16_t b, std::int32_t weight) noexcept
+    -> std::uint16_t
+{
+    auto const delta = std::int32_t { b } - std::int32_t { a };
+    return static_cast<std::uint16_t>(a + ((delta * weight) >> kWeightBits));
+}
+
+auto mix(RgbFixed const& a, RgbFixed const& b, std::int32_t weight) noexcept
+    -> RgbFixed
+{
+    return { mix(a[0], b[0], weight),
+             mix(a[1], b[1], weight),
+             mix(a[2], b[2], weight) };
+}
+
+auto to_fixed(float value) noexcept -> std::uint16_t
+{
+    auto const clamped = std::min(std::max(0.f, value), 1.f);
+    return static_cast<std::uint16_t>(std::lround(clamped * 65535.f));
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+auto to_rgb_fixed(RgbFloat const& rgb) noexcept -> RgbFixed
+{
+    return { to_fixed(rgb[0]), to_fixed(rgb[1]), to_fixed(rgb[2]) };
+}
+
+auto to_rgb_float(RgbFixed const& rgb) noexcept -> RgbFloat
+{
+    auto constexpr kScale = 1.f / 65535.f;
+    return { static_cast<float>(rgb[0]) * kScale,
+             static_cast<float>(rgb[1]) * kScale,
+             static_cast<float>(rgb[2]) * kScale };
+}
+
+/* Only the fraction matters, so the whole part is reduced first to keep
+ * it in range...
+ */
+auto to_fixed_coord(Vec<float, 2> const& coord) noexcept -> FixedCoord
+{
+    auto const fraction = [](float value) {
+        return static_cast<std::uint32_t>(
+            std::lround((value - std::floor(value)) * 65536.f));
+    };
+
+    return { fraction(coord[0]), fraction(coord[1]) };
+}
+
+FixedTexture::FixedTexture(std::span<RgbFloat const> texels,
+                           std::size_t width)
+    : texels_(texels.size())
+{
+    if (texels.empty())
+        throw std::invalid_argument { "fixed texture: no texels" };
+
+    if (width == one_row)
+        width = texels.size();
+
+    if (!width || texels.size() % width)
+        throw std::invalid_argument { "fixed texture: bad width" };
+
+    if (!can_narrow<std::uint16_t>(width)
+        || !can_narrow<std::uint16_t>(texels.size() / width))
+        throw std::invalid_argument { "fixed texture: too large" };
+
+    width_ = static_cast<std::uint32_t>(width);
+    height_ = static_cast<std::uint32_t>(texels.size() / width);
+    std::transform(texels.begin(), texels.end(), texels_.begin(), to_rgb_fixed);
+}
+
+auto FixedTexture::width() const noexcept -> std::size_t
+{
+    return width_;
+}
+
+auto FixedTexture::height() const noexcept -> std::size_t
+{
+    return height_;
+}
+
+auto FixedTexture::sample(FixedCoord const& coord,
+                          Filtering filtering) const noexcept -> RgbFixed
+{
+    switch (filtering) {
+    case Filtering::Nearest:
+        return sample(coord, texture_filtering_nearest);
+    case Filtering::Linear:
+    default:
+        return sample(coord, texture_filtering_linear);
+    }
+}
+
+auto FixedTexture::sample(FixedCoord const& coord,
+                          NearestFiltering) const noexcept -> RgbFixed
+{
+    auto const u = position(coord[0], width_);
+    auto const v = position(coord[1], height_);
+    return texels_[v.index * width_ + u.index];
+}
+
+auto FixedTexture::sample(FixedCoord const& coord,
+                          LinearFiltering) const noexcept -> RgbFixed
+{
+    auto const u = position(coord[0], width_);
+    auto const v = position(coord[1], height_);
+
+    auto const* row = texels_.data() + v.index * width_;
+    auto const* next_row = texels_.data() + v.next * width_;
+
+    return mix(mix(row[u.index], row[u.next], u.weight),
+                mix(next_row[u.index], next_row[u.next], u.weight),
+                v.weight);
+}
+
+auto make_texture(std::span<RgbFloat const> texels,
+                  std::size_t width,
+                  TexturePrecision precision,
+                  ColourSpace colour_space,
+                  Mipmaps mipmaps)
+    -> std::variant<std::shared_ptr<Texture const>,
+                    std::shared_ptr<FixedTexture const>>
+{
+    if (precision == TexturePrecision::Float)
+        return std::make_shared<Texture const>(
+            texels, width, colour_space, mipmaps);
+
+    /* Fixed point channels can't hold OKLab, or keep enough precision
+     * for dark linear colours...
+     */
+    if (colour_space != ColourSpace::Srgb)
+        throw std::invalid_argument { "fixed point textures are sRGB" };
+
+    if (mipmaps != Mipmaps::None)
+        throw std::invalid_argument { "fixed point textures have no mipmaps" };
+
+    return std::make_shared<FixedTexture const>(texels, width);
+}
+
+} // namespace rgbctl
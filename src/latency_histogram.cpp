@@ -0,0 +1,221 @@
+#include "rgbctl/latency_histogram.hpp"
+#include "rgbctl/assert.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <ostream>
+
+namespace
+{
+
+auto to_count(rgbctl::LatencyHistogram::duration value) noexcept
+    -> std::uint64_t
+{
+    return value.count() < 0 ? 0 : static_cast<std::uint64_t>(value.count());
+}
+
+auto to_duration(std::uint64_t value) noexcept
+    -> rgbctl::LatencyHistogram::duration
+{
+    using rep = rgbctl::LatencyHistogram::duration::rep;
+
+    auto constexpr max = static_cast<std::uint64_t>(
+        std::numeric_limits<rep>::max());
+    return rgbctl::LatencyHistogram::duration { static_cast<rep>(
+        std::min(value, max)) };
+}
+
+auto microseconds(rgbctl::LatencyHistogram::duration value) noexcept
+    -> double
+{
+    return std::chrono::duration<double, std::micro> { value }.count();
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+LatencyHistogram::LatencyHistogram(duration deadline) noexcept
+    : buckets_ {}
+    , count_ { 0 }
+    , missed_ { 0 }
+    , max_ { 0 }
+    , sum_ { 0 }
+    , deadline_ { deadline }
+{ }
+
+auto LatencyHistogram::record(duration value) noexcept -> void
+{
+    auto const n = to_count(value);
+
+    buckets_[bucket_index(n)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(n, std::memory_order_relaxed);
+
+    if (value > deadline_)
+        missed_.fetch_add(1, std::memory_order_relaxed);
+
+    auto current = max_.load(std::memory_order_relaxed);
+    while (n > current
+           && !max_.compare_exchange_weak(
+               current, n, std::memory_order_relaxed))
+        ;
+}
+
+auto LatencyHistogram::count() const noexcept -> std::uint64_t
+{
+    return count_.load(std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::missed_deadlines() const noexcept -> std::uint64_t
+{
+    return missed_.load(std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::deadline() const noexcept -> duration
+{
+    return deadline_;
+}
+
+auto LatencyHistogram::max() const noexcept -> duration
+{
+    return to_duration(max_.load(std::memory_order_relaxed));
+}
+
+auto LatencyHistogram::sum() const noexcept -> duration
+{
+    return to_duration(sum_.load(std::memory_order_relaxed));
+}
+
+auto LatencyHistogram::percentile(double q) const noexcept -> duration
+{
+    auto const total = count();
+    if (!total)
+        return duration::zero();
+
+    auto const target = std::max<std::uint64_t>(
+        1,
+        static_cast<std::uint64_t>(
+            std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(total))));
+
+    std::uint64_t seen = 0;
+    for (std::size_t n = 0; n < kBucketCount; ++n) {
+        seen += buckets_[n].load(std::memory_order_relaxed);
+        if (seen >= target)
+            return std::min(to_duration(bucket_upper_bound(n)), max());
+    }
+
+    return max();
+}
+
+auto LatencyHistogram::reset() noexcept -> void
+{
+    for (auto& bucket : buckets_)
+        bucket.store(0, std::memory_order_relaxed);
+
+    count_.store(0, std::memory_order_relaxed);
+    missed_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+}
+
+/* Values below `kSubBuckets` get a bucket each. Above that, a value's
+ * group is given by its most significant bit, and its bucket within the
+ * group by the `kSubBucketBits` bits below that...
+ */
+auto LatencyHistogram::bucket_index(std::uint64_t value) noexcept
+    -> std::size_t
+{
+    if (value < kSubBuckets)
+        return static_cast<std::size_t>(value);
+
+    auto const msb = static_cast<std::size_t>(std::bit_width(value) - 1);
+    auto const group = msb - kSubBucketBits + 1;
+    auto const sub_bucket
+        = static_cast<std::size_t>(value >> (group - 1)) - kSubBuckets;
+
+    return group * kSubBuckets + sub_bucket;
+}
+
+auto LatencyHistogram::bucket_upper_bound(std::size_t index) noexcept
+    -> std::uint64_t
+{
+    RGBCTL_EXPECTS(index < kBucketCount);
+
+    auto const group = index / kSubBuckets;
+    auto const sub_bucket = index % kSubBuckets;
+    if (!group)
+        return index;
+
+    if (index == kBucketCount - 1)
+        return std::numeric_limits<std::uint64_t>::max();
+
+    return ((kSubBuckets + sub_bucket + 1) << (group - 1)) - 1;
+}
+
+HistogramRegistry::Entry::Entry(std::string name,
+                                LatencyHistogram::duration deadline)
+    : name { std::move(name) }
+    , histogram { deadline }
+{ }
+
+auto HistogramRegistry::histogram(std::string name,
+                                  LatencyHistogram::duration deadline)
+    -> LatencyHistogram&
+{
+    return entries_.emplace_back(std::move(name), deadline).histogram;
+}
+
+auto HistogramRegistry::size() const noexcept -> std::size_t
+{
+    return entries_.size();
+}
+
+auto HistogramRegistry::dump(std::ostream& os) const -> void
+{
+    auto const width = std::accumulate(
+        entries_.begin(),
+        entries_.end(),
+        std::size_t { 4 },
+        [](auto w, auto const& e) { return std::max(w, e.name.size()); });
+
+    auto const flags = os.flags();
+    auto const precision = os.precision();
+
+    os << std::left << std::setw(static_cast<int>(width)) << "name"
+       << std::right << std::setw(10) << "count" << std::setw(12)
+       << "p50 (us)" << std::setw(12) << "p99 (us)" << std::setw(12)
+       << "max (us)" << std::setw(10) << "missed" << '\n';
+
+    os << std::fixed << std::setprecision(1);
+    for (auto const& entry : entries_) {
+        auto const& h = entry.histogram;
+        os << std::left << std::setw(static_cast<int>(width)) << entry.name
+           << std::right << std::setw(10) << h.count() << std::setw(12)
+           << microseconds(h.percentile(.5)) << std::setw(12)
+           << microseconds(h.percentile(.99)) << std::setw(12)
+           << microseconds(h.max()) << std::setw(10) << h.missed_deadlines()
+           << '\n';
+    }
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+ScopedLatency::ScopedLatency(LatencyHistogram* histogram) noexcept
+    : histogram_ { histogram }
+    , started_ { histogram ? std::chrono::steady_clock::now()
+                           : std::chrono::steady_clock::time_point {} }
+{ }
+
+ScopedLatency::~ScopedLatency()
+{
+    if (histogram_)
+        histogram_->record(std::chrono::steady_clock::now() - started_);
+}
+
+} // namespace rgbctl
@@ -1,4 +1,5 @@
 #include "rgbctl/loop.hpp"
+#include "rgbctl/trace.hpp"
 #include <atomic>
 #include <cmath>
 #include <errno.h>
@@ -23,26 +24,51 @@ auto from_milliseconds(std::uint32_t val) noexcept -> timespec
 }
 
 std::atomic_size_t sigints_received = 0;
+std::atomic_bool status_requested = false;
 
 auto sigint_handler(int) -> void
 {
     sigints_received++;
 }
 
+auto sigusr1_handler(int) -> void
+{
+    status_requested = true;
+}
+
+auto loop_signals() noexcept -> sigset_t
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGUSR1);
+    return signals;
+}
+
 } // namespace
 
 namespace rgbctl
 {
 
+auto block_loop_signals() noexcept -> void
+{
+    auto const blockset = loop_signals();
+    pthread_sigmask(SIG_BLOCK, &blockset, nullptr);
+}
+
+auto take_status_request() noexcept -> bool
+{
+    return status_requested.exchange(false);
+}
+
 auto detail::loop(std::uint32_t ms_per_loop,
                   auto (*f)(std::uint32_t, void*)->bool,
                   void* fn) -> void
 {
     sigints_received = 0;
-    sigset_t blockset, emptyset, savedset;
+    sigset_t emptyset, savedset;
     sigemptyset(&emptyset);
-    sigemptyset(&blockset);
-    sigaddset(&blockset, SIGINT);
+    auto const blockset = loop_signals();
     sigprocmask(SIG_BLOCK, &blockset, &savedset);
 
     struct sigaction sa;
@@ -51,6 +77,9 @@ auto detail::loop(std::uint32_t ms_per_loop,
     sigemptyset(&sa.sa_mask);
     sigaction(SIGINT, &sa, nullptr);
 
+    sa.sa_handler = sigusr1_handler;
+    sigaction(SIGUSR1, &sa, nullptr);
+
     timespec then {};
     timespec now {};
     clock_gettime(CLOCK_MONOTONIC, &then);
@@ -66,6 +95,7 @@ auto detail::loop(std::uint32_t ms_per_loop,
 
         target_ms += elapsed_ms;
         if (target_ms >= ms_per_loop) {
+            RGBCTL_TRACE_SCOPE("loop.frame");
             if (!f(target_ms, fn))
                 break;
             auto loop_count = target_ms / ms_per_loop;
@@ -74,14 +104,24 @@ auto detail::loop(std::uint32_t ms_per_loop,
 
         auto sleep_for_ms = from_milliseconds(ms_per_loop - target_ms);
 
+        auto const sleep_started = trace::enabled() ? trace::now() : 0;
         auto select_result
             = pselect(0, nullptr, nullptr, nullptr, &sleep_for_ms, &emptyset);
+        auto const select_errno = errno;
+        if (sleep_started)
+            trace::record("loop.sleep", sleep_started, trace::now());
 
         if (select_result < 0) {
-            if (errno == EINTR && sigints_received > 0)
+            if (select_errno == EINTR && sigints_received > 0)
                 break;
 
-            throw std::system_error { errno, std::system_category() };
+            /* SIGUSR1 just wakes us early. The request is picked up
+             * through `take_status_request()`...
+             */
+            if (select_errno == EINTR)
+                continue;
+
+            throw std::system_error { select_errno, std::system_category() };
         }
     }
 
@@ -3,16 +3,75 @@
 #include "./builtins/corsair/corsair_h100i_pro_xt.hpp"
 #include "./fixed_config.hpp"
 #include "rgbctl/rgbctl.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <libtcc.h>
+#include <memory>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
-using Mod = std::tuple<rgbctl_product_id, rgbctl_module_acquisition_callback>;
+using Mod
+    = std::tuple<rgbctl_product_id, rgbctl_module_acquisition_callback, void*>;
 using RegisteredModules = std::vector<Mod>;
 using Devices = std::vector<rgbctl::DetectedDevice>;
 
+auto constexpr kFramePeriod = std::chrono::milliseconds { 33 };
+
+auto product_name(rgbctl_product_id id) -> std::string
+{
+    std::ostringstream name;
+    name << std::hex << std::setfill('0') << std::setw(4) << id.vendor_id
+         << ':' << std::setw(4) << id.product_id;
+    return name.str();
+}
+
+/* Where effects interpolate their textures, set by `RGBCTL_COLOUR_SPACE`
+ * to "srgb", "linear" or "oklab"...
+ */
+auto texture_colour_space() -> rgbctl::ColourSpace
+{
+    auto const* name = std::getenv("RGBCTL_COLOUR_SPACE");
+    if (!name)
+        return rgbctl::ColourSpace::Srgb;
+
+    if (auto const space = rgbctl::parse_colour_space(name))
+        return *space;
+
+    throw std::runtime_error { "app: parse RGBCTL_COLOUR_SPACE" };
+}
+
+/* The texture effects sample: the texture file at `RGBCTL_TEXTURE`,
+ * mapped rather than read, or else the builtin gradient. Every zone
+ * shares the one texture, and the file is only opened and mapped once,
+ * however many controllers ask for it...
+ */
+auto create_texture() -> std::shared_ptr<rgbctl::Texture const>
+{
+    static rgbctl::TextureCache cache;
+
+    if (auto const* path = std::getenv("RGBCTL_TEXTURE")) {
+        static auto const file
+            = std::make_shared<rgbctl::TextureFile const>(path);
+        return cache.get(file, texture_colour_space());
+    }
+
+    auto texture_config = rgbctl::fixed_texture_config();
+
+    return cache.get({ data(texture_config.data),
+                       texture_config.data.size() },
+                     rgbctl::Texture::one_row,
+                     texture_colour_space());
+}
+
 auto create_rotate_effect(std::uint32_t zone_index) -> rgbctl::effects::Rotate
 {
     // std::array<rgbctl::RgbFloat, 32> inputs {};
@@ -22,12 +81,7 @@ auto create_rotate_effect(std::uint32_t zone_index) -> rgbctl::effects::Rotate
     // hex_string_to_rgb_float("070050", *rgb++);
     // hex_string_to_rgb_float("3f00ff", *rgb++);
 
-    auto texture_config = rgbctl::fixed_texture_config();
-
-    return rgbctl::effects::Rotate { zone_index,
-                                     5000,
-                                     { data(texture_config.data),
-                                       texture_config.data.size() } };
+    return rgbctl::effects::Rotate { zone_index, 5000, create_texture() };
 }
 
 auto create_linear_effect(std::uint32_t zone_index) -> rgbctl::effects::Linear
@@ -52,6 +106,89 @@ auto create_linear_effect(std::uint32_t zone_index) -> rgbctl::effects::Linear
     };
 }
 
+/* User shaders get this long to shade a zone, unless overridden by
+ * `RGBCTL_SHADER_BUDGET_US`, and are demoted after overrunning a few
+ * frames in a row...
+ */
+auto user_shader_budget() -> rgbctl::ShaderBudget
+{
+    std::chrono::microseconds per_frame { 5000 };
+    if (auto const* budget = std::getenv("RGBCTL_SHADER_BUDGET_US"))
+        per_frame = std::chrono::microseconds {
+            static_cast<std::chrono::microseconds::rep>(
+                std::strtoul(budget, nullptr, 10))
+        };
+
+    return rgbctl::ShaderBudget { .per_frame = per_frame, .max_overruns = 3 };
+}
+
+/* Colour correction for every device, from `RGBCTL_GAMMA`,
+ * `RGBCTL_BRIGHTNESS` and `RGBCTL_WHITE_BALANCE` (a hex colour).
+ * Dithering is on unless `RGBCTL_DITHER` is `0`...
+ */
+auto output_options() -> rgbctl::OutputOptions
+{
+    rgbctl::OutputOptions options;
+    if (auto const* gamma = std::getenv("RGBCTL_GAMMA"))
+        options.gamma = std::strtof(gamma, nullptr);
+
+    if (auto const* brightness = std::getenv("RGBCTL_BRIGHTNESS"))
+        options.brightness = std::strtof(brightness, nullptr);
+
+    if (auto const* white_balance = std::getenv("RGBCTL_WHITE_BALANCE")) {
+        if (!rgbctl::hex_string_to_rgb_float(white_balance,
+                                             options.white_balance))
+            throw std::runtime_error { "app: parse RGBCTL_WHITE_BALANCE" };
+    }
+
+    if (auto const* dither = std::getenv("RGBCTL_DITHER"))
+        options.dither = std::string_view { dither } != "0";
+
+    return options;
+}
+
+auto create_user_effect(std::uint32_t zone_index,
+                        std::shared_ptr<rgbctl::ShaderSlot> shader)
+    -> rgbctl::effects::User
+{
+    return rgbctl::effects::User {
+        zone_index,
+        5000,
+        std::move(shader),
+        create_texture(),
+        user_shader_budget()
+    };
+}
+
+/* Plays the animated texture file at `RGBCTL_ANIMATION`, a frame each
+ * frame period. Every zone shares the one stream...
+ */
+auto create_animation_effect(std::uint32_t zone_index, char const* path)
+    -> rgbctl::effects::Animation
+{
+    static auto const stream = std::make_shared<rgbctl::TextureStream>(
+        path, texture_colour_space());
+
+    return rgbctl::effects::Animation {
+        zone_index, stream, static_cast<std::size_t>(kFramePeriod.count())
+    };
+}
+
+auto create_effect(std::uint32_t zone_index,
+                   std::shared_ptr<rgbctl::ShaderSlot> const& shader)
+    -> rgbctl::AnyEffect
+{
+    if (shader)
+        return rgbctl::AnyEffect { create_user_effect(zone_index, shader) };
+
+    if (auto const* animation = std::getenv("RGBCTL_ANIMATION"))
+        return rgbctl::AnyEffect {
+            create_animation_effect(zone_index, animation)
+        };
+
+    return rgbctl::AnyEffect { create_rotate_effect(zone_index) };
+}
+
 template <typename Effect>
 auto create_controller(rgbctl_product_id id,
                        Effect&& effect,
@@ -71,50 +208,393 @@ auto create_controller(rgbctl_product_id id,
     if (mod_pos == registered_modules.end() || device_pos == devices.end())
         throw std::runtime_error { "app: match device to module" };
 
-    rgbctl::DeviceContext<rgbctl::RawDeviceStream> ctx {
-        rgbctl::RawDeviceStream { device_pos->device_path }
+    rgbctl::RawDeviceStream stream { device_pos->device_path };
+
+    /* `RGBCTL_RECORD_TRAFFIC` names a directory to log each device's
+     * traffic to, for replaying with `ReplayStream`...
+     */
+    if (auto const* record_dir = std::getenv("RGBCTL_RECORD_TRAFFIC")) {
+        auto const log = std::filesystem::path { record_dir }
+                         / (product_name(id) + ".rgbtraffic");
+        rgbctl::DeviceContext ctx { rgbctl::RecordingStream {
+            std::move(stream), log } };
+
+        return rgbctl::make_controller(std::move(ctx),
+                                       std::move(effect),
+                                       std::get<0>(*mod_pos),
+                                       std::get<1>(*mod_pos),
+                                       std::get<2>(*mod_pos));
+    }
+
+    rgbctl::DeviceContext<rgbctl::RawDeviceStream> ctx { std::move(stream) };
+
+    return rgbctl::make_controller(std::move(ctx),
+                                   std::move(effect),
+                                   std::get<0>(*mod_pos),
+                                   std::get<1>(*mod_pos),
+                                   std::get<2>(*mod_pos));
+}
+
+/* A device that speaks the protocol of the builtin module for `id`,
+ * limited to the speed of a real one unless `RGBCTL_SIMULATED_UNLIMITED`
+ * is set...
+ */
+template <typename Effect>
+auto create_simulated_controller(rgbctl_product_id id,
+                                 rgbctl::SimulatedProtocol protocol,
+                                 Effect&& effect,
+                                 RegisteredModules const& registered_modules)
+    -> rgbctl::AnyController
+{
+    auto mod_pos = std::find_if(
+        registered_modules.begin(),
+        registered_modules.end(),
+        [&](auto const& item) { return std::get<0>(item) == id; });
+
+    if (mod_pos == registered_modules.end())
+        throw std::runtime_error { "app: match simulated device to module" };
+
+    auto const limits = std::getenv("RGBCTL_SIMULATED_UNLIMITED")
+                            ? rgbctl::SimulatedDeviceLimits {}
+                            : rgbctl::SimulatedDeviceLimits::usb_full_speed();
+
+    rgbctl::DeviceContext<rgbctl::SimulatedDeviceStream> ctx {
+        rgbctl::SimulatedDeviceStream { protocol, limits }
     };
 
     return rgbctl::make_controller(std::move(ctx),
                                    std::move(effect),
                                    std::get<0>(*mod_pos),
-                                   std::get<1>(*mod_pos));
+                                   std::get<1>(*mod_pos),
+                                   std::get<2>(*mod_pos));
+}
+
+/* The number of LEDs in zone `zone_index` of the device that the
+ * builtin module for `id` drives, asked of a simulated one...
+ */
+auto simulated_zone_size(rgbctl_product_id id,
+                         rgbctl::SimulatedProtocol protocol,
+                         std::uint32_t zone_index,
+                         RegisteredModules const& registered_modules)
+    -> std::size_t
+{
+    auto mod_pos = std::find_if(
+        registered_modules.begin(),
+        registered_modules.end(),
+        [&](auto const& item) { return std::get<0>(item) == id; });
+
+    if (mod_pos == registered_modules.end())
+        throw std::runtime_error { "app: match simulated device to module" };
+
+    rgbctl::DeviceContext<rgbctl::SimulatedDeviceStream> ctx {
+        rgbctl::SimulatedDeviceStream { protocol }
+    };
+
+    auto mod = rgbctl::acquire_module(ctx,
+                                      std::get<0>(*mod_pos),
+                                      std::get<1>(*mod_pos),
+                                      std::get<2>(*mod_pos));
+    auto const zones = mod.query_zones(ctx);
+    auto const size
+        = zone_index < zones.size() ? zones[zone_index].rgb_count : 0;
+    mod.release(ctx);
+
+    return size;
+}
+
+/* With `RGBCTL_CANVAS` set, the builtin devices' zones share a canvas,
+ * the Asus strip across its left half and the Corsair ring on its
+ * right, so the effect sweeps from one device to the other. Returns
+ * the Asus zone's effect, then the Corsair's...
+ */
+auto create_canvas_effects(std::shared_ptr<rgbctl::ShaderSlot> const& shader,
+                           RegisteredModules const& registered_modules)
+    -> std::vector<rgbctl::AnyEffect>
+{
+    using rgbctl::modules::builtin::asus::AsusX570;
+    using rgbctl::modules::builtin::corsair::CorsairH100iProXt;
+
+    auto canvas
+        = std::make_shared<rgbctl::Canvas>(create_effect(0, shader), 64);
+
+    auto const strip
+        = simulated_zone_size(AsusX570::product_id,
+                              rgbctl::SimulatedProtocol::AsusX570,
+                              0,
+                              registered_modules);
+    auto const ring
+        = simulated_zone_size(CorsairH100iProXt::product_id,
+                              rgbctl::SimulatedProtocol::CorsairH100iProXt,
+                              1,
+                              registered_modules);
+
+    std::vector<rgbctl::AnyEffect> effects;
+    effects.emplace_back(rgbctl::CanvasSampler {
+        0, canvas, rgbctl::led_line(strip, { 0.f, .5f }, { .5f, .5f }) });
+    effects.emplace_back(rgbctl::CanvasSampler {
+        1, canvas, rgbctl::led_ring(ring, { .75f, .5f }, .25f) });
+
+    return effects;
+}
+
+/* Renders `RGBCTL_RENDER_SECONDS` (default 10) of the builtin devices'
+ * effects to `path`, as fast as possible and without any hardware. A
+ * `.ppm` path gets an image strip, anything else raw RGB bytes...
+ */
+auto render_to_file(std::filesystem::path const& path,
+                    std::shared_ptr<rgbctl::ShaderSlot> const& shader,
+                    RegisteredModules const& registered_modules) -> void
+{
+    using rgbctl::modules::builtin::asus::AsusX570;
+    using rgbctl::modules::builtin::corsair::CorsairH100iProXt;
+
+    rgbctl::RenderOptions options { .frame_period = kFramePeriod,
+                                    .output = output_options() };
+    if (auto const* seconds = std::getenv("RGBCTL_RENDER_SECONDS"))
+        options.duration = std::chrono::seconds {
+            static_cast<std::chrono::seconds::rep>(
+                std::strtoul(seconds, nullptr, 10))
+        };
+
+    if (path.extension() == ".ppm")
+        options.format = rgbctl::RenderFormat::Ppm;
+
+    std::vector<rgbctl::AnyEffect> effects;
+    if (std::getenv("RGBCTL_CANVAS")) {
+        effects = create_canvas_effects(shader, registered_modules);
+    }
+    else {
+        effects.push_back(create_effect(0, shader));
+        effects.push_back(create_effect(1, shader));
+    }
+
+    std::vector<rgbctl::RenderZone> zones;
+    zones.push_back({ std::move(effects[0]),
+                      simulated_zone_size(AsusX570::product_id,
+                                          rgbctl::SimulatedProtocol::AsusX570,
+                                          0,
+                                          registered_modules) });
+    zones.push_back(
+        { std::move(effects[1]),
+          simulated_zone_size(CorsairH100iProXt::product_id,
+                              rgbctl::SimulatedProtocol::CorsairH100iProXt,
+                              1,
+                              registered_modules) });
+
+    std::ofstream out { path, std::ios::binary };
+    if (!out)
+        throw std::runtime_error { "app: open render output" };
+
+    /* The builtin drivers leave `std::cerr` in hex...
+     */
+    auto const stats = rgbctl::render(zones, options, out);
+    std::cerr << std::dec << "Rendered " << stats.frames << " frames in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                     stats.elapsed)
+                     .count()
+              << "ms (" << stats.frames_per_second() << " frames/s)\n";
+}
+
+auto is_registered(rgbctl_product_id id,
+                   RegisteredModules const& registered_modules) -> bool
+{
+    return std::any_of(
+        registered_modules.begin(),
+        registered_modules.end(),
+        [&](auto const& item) { return std::get<0>(item) == id; });
+}
+
+/* Plugins are only loaded for devices that are actually present and
+ * not already handled by a builtin module. Returns the product IDs
+ * that were registered this way...
+ */
+auto register_plugin_modules(rgbctl::PluginRegistry& plugins,
+                             Devices const& devices,
+                             RegisteredModules& registered_modules)
+    -> std::vector<rgbctl_product_id>
+{
+    std::vector<rgbctl_product_id> registered;
+    for (auto const& device : devices) {
+        if (is_registered(device.product_id, registered_modules)
+            || !plugins.supports(device.product_id))
+            continue;
+
+        auto const& reg = plugins.load(device.product_id);
+        registered_modules.push_back(
+            { device.product_id, reg.acquire_callback, reg.user_data });
+        registered.push_back(device.product_id);
+    }
+
+    return registered;
 }
 
 auto app() -> void
 {
+    auto const* trace_path = std::getenv("RGBCTL_TRACE");
+    if (trace_path)
+        rgbctl::trace::enable();
+
     rgbctl_module_registration reg {};
     if (rgbctl::modules::init(&reg) != RGBCTL_SUCCESS)
         throw std::runtime_error { "app: init modules" };
 
     RegisteredModules registered_modules;
     while (reg.product_count--)
-        registered_modules.push_back({ *reg.products++, reg.acquire_callback });
+        registered_modules.push_back(
+            { *reg.products++, reg.acquire_callback, reg.user_data });
+
+    /* Must outlive `controllers`, as it owns the plugins' code...
+     */
+    rgbctl::PluginRegistry plugins;
+    if (auto const* plugin_dir = std::getenv("RGBCTL_PLUGIN_DIR"))
+        plugins.scan(plugin_dir);
 
     Devices devices;
     rgbctl::detect(devices);
 
+    auto const plugin_products
+        = register_plugin_modules(plugins, devices, registered_modules);
+
+    /* Every user effect shares the one shader slot, so an optimised
+     * or edited build of the shader only has to be swapped in once...
+     */
+    std::shared_ptr<rgbctl::ShaderSlot> shader;
+    std::optional<rgbctl::NativeShaderCompiler> native_compiler;
+    std::optional<rgbctl::ShaderWatcher> shader_watcher;
+    if (auto const* shader_path = std::getenv("RGBCTL_USER_SHADER")) {
+        rgbctl::ShaderCache cache { rgbctl::ShaderCache::default_directory() };
+        auto const source = rgbctl::read_user_shader_source(shader_path);
+        shader = std::make_shared<rgbctl::ShaderSlot>(cache.load(source));
+
+        if (std::getenv("RGBCTL_NATIVE_SHADERS")) {
+            native_compiler.emplace(cache.directory());
+            native_compiler->compile(source, shader);
+        }
+
+        shader_watcher.emplace(native_compiler ? &*native_compiler : nullptr);
+        shader_watcher->watch(shader_path, shader);
+    }
+
+    if (auto const* render_path = std::getenv("RGBCTL_RENDER")) {
+        render_to_file(render_path, shader, registered_modules);
+        return;
+    }
+
     using rgbctl::modules::builtin::asus::AsusX570;
     using rgbctl::modules::builtin::corsair::CorsairH100iProXt;
 
+    /* Must outlive `controllers`, which record into it. A frame is
+     * counted as late once it's more than half a frame behind...
+     */
+    rgbctl::HistogramRegistry histograms;
+    auto& loop_period = histograms.histogram(
+        "loop.period", kFramePeriod + kFramePeriod / 2);
+
+    auto const output = output_options();
+
     std::vector<rgbctl::AnyController> controllers;
-    controllers.push_back(create_controller(AsusX570::product_id,
-                                            create_rotate_effect(0),
-                                            registered_modules,
-                                            devices));
-    controllers.push_back(create_controller(CorsairH100iProXt::product_id,
-                                            create_rotate_effect(1),
-                                            registered_modules,
-                                            devices));
-
-    rgbctl::loop(33, [&](auto elapsed) {
+    auto add_controller = [&](rgbctl_product_id id, rgbctl::AnyEffect effect) {
+        auto& ctrl = controllers.emplace_back(create_controller(
+            id, std::move(effect), registered_modules, devices));
+        ctrl.set_output(output);
+
+        auto const name = product_name(id);
+        ctrl.set_timings(
+            { .effect = &histograms.histogram(name + ".effect", kFramePeriod),
+              .send = &histograms.histogram(name + ".send", kFramePeriod) });
+    };
+
+    /* `RGBCTL_SIMULATED_DEVICES` replaces the builtin devices with that
+     * many simulated ones, alternately Corsair and Asus, for load
+     * testing. Each kind shares its histograms...
+     */
+    if (auto const* simulated = std::getenv("RGBCTL_SIMULATED_DEVICES")) {
+        auto const timings = [&](std::string const& name) {
+            return rgbctl::ControllerTimings {
+                .effect = &histograms.histogram(name + ".effect", kFramePeriod),
+                .send = &histograms.histogram(name + ".send", kFramePeriod)
+            };
+        };
+
+        auto const corsair_timings = timings("simulated.corsair");
+        auto const asus_timings = timings("simulated.asus");
+
+        auto const count = std::strtoul(simulated, nullptr, 10);
+        for (unsigned long n = 0; n < count; ++n) {
+            if (n % 2 == 0)
+                controllers
+                    .emplace_back(create_simulated_controller(
+                        CorsairH100iProXt::product_id,
+                        rgbctl::SimulatedProtocol::CorsairH100iProXt,
+                        create_effect(1, shader),
+                        registered_modules))
+                    .set_timings(corsair_timings);
+            else
+                controllers
+                    .emplace_back(create_simulated_controller(
+                        AsusX570::product_id,
+                        rgbctl::SimulatedProtocol::AsusX570,
+                        create_effect(0, shader),
+                        registered_modules))
+                    .set_timings(asus_timings);
+
+            controllers.back().set_output(output);
+        }
+    }
+    else if (std::getenv("RGBCTL_CANVAS")) {
+        auto effects = create_canvas_effects(shader, registered_modules);
+        add_controller(AsusX570::product_id, std::move(effects[0]));
+        add_controller(CorsairH100iProXt::product_id, std::move(effects[1]));
+    }
+    else {
+        add_controller(AsusX570::product_id, create_effect(0, shader));
+        add_controller(CorsairH100iProXt::product_id,
+                       create_effect(1, shader));
+    }
+
+    for (auto const& id : plugin_products)
+        add_controller(id, create_effect(0, shader));
+
+    /* Started only once every histogram has been registered...
+     */
+    std::optional<rgbctl::MetricsServer> metrics_server;
+    if (auto const* socket_path = std::getenv("RGBCTL_METRICS_SOCKET"))
+        metrics_server.emplace(socket_path, &histograms);
+
+    using rgbctl::metrics::Counter;
+
+    std::optional<std::chrono::steady_clock::time_point> last_frame;
+    auto const ms_per_loop = static_cast<std::uint32_t>(kFramePeriod.count());
+    rgbctl::loop(ms_per_loop, [&](auto elapsed) {
+        auto const now = std::chrono::steady_clock::now();
+        if (last_frame)
+            loop_period.record(now - *last_frame);
+        last_frame = now;
+
         for (auto& ctrl : controllers)
             ctrl.tick(elapsed);
 
+        /* The loop only calls us once however many frame periods have
+         * passed, so any more than one is a skipped frame...
+         */
+        rgbctl::metrics::add(Counter::FramesRendered);
+        if (elapsed > ms_per_loop)
+            rgbctl::metrics::add(Counter::FramesSkipped,
+                                 elapsed / ms_per_loop - 1);
+
+        if (rgbctl::take_status_request())
+            histograms.dump(std::cerr);
+
         return true;
     });
 
     std::cerr << "Exited loop\n";
+    histograms.dump(std::cerr);
+
+    if (trace_path) {
+        std::ofstream trace { trace_path };
+        rgbctl::trace::write_json(trace);
+    }
 }
 
 auto main() -> int
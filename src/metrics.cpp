@@ -0,0 +1,148 @@
+#include "rgbctl/metrics.hpp"
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace
+{
+
+using rgbctl::metrics::kCounterCount;
+
+/* In the same order as `Counter`...
+ */
+char const* const kCounterNames[kCounterCount] = {
+    "frames_rendered", "frames_skipped", "bytes_written",
+    "bytes_read",      "write_errors",   "read_errors",
+    "shader_workers_abandoned",
+};
+
+/* Each shard gets its own cache line, so threads counting at the same
+ * time never contend for one...
+ */
+struct alignas(64) Shard
+{
+    std::array<std::atomic<std::uint64_t>, kCounterCount> values {};
+};
+
+struct Shards
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Shard>> all;
+};
+
+/* Never destroyed, as threads (e.g. an abandoned shader worker) may
+ * outlive static destruction. Shards outlive their threads, so
+ * nothing that's been counted is lost...
+ */
+auto shards() -> Shards&
+{
+    static auto* shards = new Shards;
+    return *shards;
+}
+
+/* Null if the thread's shard couldn't be allocated, in which case its
+ * counts are dropped until allocating it succeeds...
+ */
+auto local_shard() noexcept -> Shard*
+{
+    thread_local Shard* shard = nullptr;
+    if (shard)
+        return shard;
+
+    try {
+        auto& s = shards();
+        std::lock_guard lock { s.mutex };
+        auto owned = std::make_unique<Shard>();
+        shard = s.all.emplace_back(std::move(owned)).get();
+    }
+    catch (std::exception const&) {
+    }
+
+    return shard;
+}
+
+auto seconds(rgbctl::LatencyHistogram::duration value) -> double
+{
+    return std::chrono::duration<double> { value }.count();
+}
+
+} // namespace
+
+namespace rgbctl::metrics
+{
+
+auto add(Counter counter, std::uint64_t n) noexcept -> void
+{
+    /* Only this thread writes to its shard, so there's no need for an
+     * atomic read-modify-write...
+     */
+    auto* shard = local_shard();
+    if (!shard)
+        return;
+
+    auto& value = shard->values[static_cast<std::size_t>(counter)];
+    value.store(value.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+}
+
+auto snapshot() -> Counters
+{
+    Counters totals {};
+
+    auto& s = shards();
+    std::lock_guard lock { s.mutex };
+    for (auto const& shard : s.all) {
+        for (std::size_t n = 0; n < kCounterCount; ++n)
+            totals[n] += shard->values[n].load(std::memory_order_relaxed);
+    }
+
+    return totals;
+}
+
+auto name(Counter counter) noexcept -> char const*
+{
+    return kCounterNames[static_cast<std::size_t>(counter)];
+}
+
+auto write_prometheus(std::ostream& os, HistogramRegistry const* histograms)
+    -> void
+{
+    auto const counters = snapshot();
+    for (std::size_t n = 0; n < kCounterCount; ++n) {
+        auto const* counter = name(static_cast<Counter>(n));
+        os << "# TYPE rgbctl_" << counter << "_total counter\n"
+           << "rgbctl_" << counter << "_total " << counters[n] << '\n';
+    }
+
+    if (!histograms)
+        return;
+
+    os << "# TYPE rgbctl_latency_seconds summary\n";
+    histograms->for_each([&](auto const& name, auto const& h) {
+        for (auto q : { .5, .9, .99 })
+            os << "rgbctl_latency_seconds{name=\"" << name << "\",quantile=\""
+               << q << "\"} " << seconds(h.percentile(q)) << '\n';
+        os << "rgbctl_latency_seconds_sum{name=\"" << name << "\"} "
+           << seconds(h.sum()) << '\n';
+        os << "rgbctl_latency_seconds_count{name=\"" << name << "\"} "
+           << h.count() << '\n';
+    });
+
+    os << "# TYPE rgbctl_latency_max_seconds gauge\n";
+    histograms->for_each([&](auto const& name, auto const& h) {
+        os << "rgbctl_latency_max_seconds{name=\"" << name << "\"} "
+           << seconds(h.max()) << '\n';
+    });
+
+    os << "# TYPE rgbctl_missed_deadlines_total counter\n";
+    histograms->for_each([&](auto const& name, auto const& h) {
+        os << "rgbctl_missed_deadlines_total{name=\"" << name << "\"} "
+           << h.missed_deadlines() << '\n';
+    });
+}
+
+} // namespace rgbctl::metrics
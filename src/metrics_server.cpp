@@ -0,0 +1,209 @@
+#include "rgbctl/metrics_server.hpp"
+#include "rgbctl/loop.hpp"
+#include "rgbctl/metrics.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+/* How long a client that's stopped reading can hold up the server...
+ */
+int constexpr kSendTimeoutMs = 1000;
+
+auto last_error() -> std::system_error
+{
+    return std::system_error { errno, std::system_category() };
+}
+
+/* Removes a socket left behind by a previous run, so `bind()` can
+ * succeed. Anything else at `path` is left alone, in case it's been
+ * given by mistake...
+ */
+auto remove_stale_socket(fs::path const& path) -> void
+{
+    struct stat status;
+    if (lstat(path.c_str(), &status) < 0) {
+        if (errno == ENOENT)
+            return;
+
+        throw last_error();
+    }
+
+    if (!S_ISSOCK(status.st_mode))
+        throw std::runtime_error { "metrics: " + path.string()
+                                   + " exists and isn't a socket" };
+
+    unlink(path.c_str());
+}
+
+/* Removes the socket at `path`, but only if it's still the one we
+ * bound; another process may have since replaced it with its own...
+ */
+auto remove_bound_socket(fs::path const& path, dev_t device, ino_t inode)
+    -> void
+{
+    struct stat status;
+    if (lstat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)
+        && status.st_dev == device && status.st_ino == inode)
+        unlink(path.c_str());
+}
+
+auto listen_on(fs::path const& path) -> int
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (path.native().size() >= sizeof(address.sun_path))
+        throw std::runtime_error { "metrics: socket path too long" };
+
+    std::strcpy(address.sun_path, path.c_str());
+
+    remove_stale_socket(path);
+
+    auto const fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        throw last_error();
+
+    if (bind(fd, reinterpret_cast<sockaddr const*>(&address), sizeof(address))
+            < 0
+        || listen(fd, 4) < 0) {
+        auto error = last_error();
+        close(fd);
+        throw error;
+    }
+
+    return fd;
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+MetricsServer::MetricsServer(fs::path socket_path,
+                             HistogramRegistry const* histograms)
+    : socket_path_ { std::move(socket_path) }
+    , histograms_ { histograms }
+    , socket_fd_ { listen_on(socket_path_) }
+    , stop_fds_ { -1, -1 }
+{
+    struct stat status;
+    if (lstat(socket_path_.c_str(), &status) < 0) {
+        auto error = last_error();
+        close(socket_fd_);
+        throw error;
+    }
+
+    socket_device_ = status.st_dev;
+    socket_inode_ = status.st_ino;
+
+    if (pipe2(stop_fds_, O_CLOEXEC) < 0) {
+        auto error = last_error();
+        close(socket_fd_);
+        remove_bound_socket(socket_path_, socket_device_, socket_inode_);
+        throw error;
+    }
+
+    thread_ = std::thread { [this] { run(); } };
+}
+
+MetricsServer::~MetricsServer()
+{
+    char const stop = 0;
+    while (write(stop_fds_[1], &stop, 1) < 0 && errno == EINTR)
+        ;
+
+    thread_.join();
+
+    close(stop_fds_[0]);
+    close(stop_fds_[1]);
+    close(socket_fd_);
+    remove_bound_socket(socket_path_, socket_device_, socket_inode_);
+}
+
+auto MetricsServer::socket_path() const noexcept -> fs::path const&
+{
+    return socket_path_;
+}
+
+auto MetricsServer::run() -> void
+{
+    block_loop_signals();
+
+    pollfd fds[] = { { .fd = socket_fd_, .events = POLLIN, .revents = 0 },
+                     { .fd = stop_fds_[0], .events = POLLIN, .revents = 0 } };
+
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+
+            std::cerr << "metrics: " << last_error().what() << '\n';
+            return;
+        }
+
+        if (fds[1].revents)
+            return;
+
+        auto const client = accept4(
+            socket_fd_, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (client < 0)
+            continue;
+
+        serve(client);
+        close(client);
+    }
+}
+
+auto MetricsServer::serve(int client) -> void
+{
+    std::ostringstream text;
+    metrics::write_prometheus(text, histograms_);
+    auto const response = text.str();
+
+    /* `MSG_NOSIGNAL`, so a client that's gone away can't kill us with
+     * SIGPIPE. The client is non-blocking, and waited on along with
+     * the stop pipe, so one that doesn't read can't stall the server,
+     * or its shutdown...
+     */
+    pollfd fds[] = { { .fd = client, .events = POLLOUT, .revents = 0 },
+                     { .fd = stop_fds_[0], .events = POLLIN, .revents = 0 } };
+
+    std::size_t sent = 0;
+    while (sent < response.size()) {
+        auto const result = send(client,
+                                 response.data() + sent,
+                                 response.size() - sent,
+                                 MSG_NOSIGNAL);
+        if (result >= 0) {
+            sent += static_cast<std::size_t>(result);
+            continue;
+        }
+
+        if (errno == EINTR)
+            continue;
+
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+            return;
+
+        auto const ready = poll(fds, 2, kSendTimeoutMs);
+        if (ready < 0 && errno == EINTR)
+            continue;
+
+        if (ready <= 0 || fds[1].revents)
+            return;
+    }
+}
+
+} // namespace rgbctl
@@ -0,0 +1,288 @@
+#include "rgbctl/native_shader_compiler.hpp"
+#include "rgbctl/assert.hpp"
+#include "rgbctl/hash.hpp"
+#include "rgbctl/loop.hpp"
+#include "rgbctl/utils.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <spawn.h>
+#include <sstream>
+#include <string_view>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+char const* const kOptimisationFlags[] = { "-O2", "-march=native" };
+
+/* `$CC` split on whitespace, as make would, so it can carry a wrapper
+ * or flags (e.g. "ccache gcc" or "gcc -m64"), or `cc` if it's unset or
+ * empty...
+ */
+auto compiler() -> std::vector<std::string>
+{
+    auto const* env = std::getenv("CC");
+    std::istringstream cc { env ? env : "" };
+    std::vector<std::string> words;
+    for (std::string word; cc >> word;)
+        words.push_back(std::move(word));
+
+    if (words.empty())
+        words.push_back("cc");
+
+    return words;
+}
+
+/* Which compiler `name` runs: the binary it resolves to through `PATH`
+ * and any symlinks, along with its size and modification time. Those
+ * change when the compiler's upgraded, or `cc` is pointed at another
+ * one. Falls back to the name if it can't be found...
+ */
+auto compiler_identity(std::string const& name) -> std::string
+{
+    std::error_code ec;
+    fs::path binary { name };
+    if (!binary.has_parent_path()) {
+        auto const* path = std::getenv("PATH");
+        std::string_view directories { path ? path : "" };
+        while (!directories.empty()) {
+            auto const end = directories.find(':');
+            auto const candidate
+                = fs::path { directories.substr(0, end) } / name;
+            directories.remove_prefix(
+                end == directories.npos ? directories.size() : end + 1);
+
+            if (access(candidate.c_str(), X_OK) == 0) {
+                binary = candidate;
+                break;
+            }
+        }
+    }
+
+    auto const resolved = fs::canonical(binary, ec);
+    if (ec)
+        return name;
+
+    auto const size = fs::file_size(resolved, ec);
+    auto const modified = fs::last_write_time(resolved, ec);
+    if (ec)
+        return name;
+
+    return resolved.string() + ":" + std::to_string(size) + ":"
+           + std::to_string(modified.time_since_epoch().count());
+}
+
+/* The CPU `-march=native` targets: its vendor, model and the
+ * instruction set extensions it has, from the first processor in
+ * `/proc/cpuinfo`. A cache shared between machines (e.g. a synced
+ * home directory) would otherwise load objects using instructions this
+ * one doesn't have. Read once, as it can't change while we run...
+ */
+auto cpu_identity() -> std::string const&
+{
+    static auto const identity = [] {
+        char const* const keys[] = {
+            "vendor_id",       "cpu family",       "model",
+            "model name",      "flags",            "Features",
+            "CPU implementer", "CPU architecture", "CPU variant",
+            "CPU part",
+        };
+
+        std::string result;
+        std::ifstream cpuinfo { "/proc/cpuinfo" };
+        std::string line;
+        while (std::getline(cpuinfo, line) && !line.empty()) {
+            auto const key = std::string_view { line }.substr(
+                0, line.find_first_of("\t:"));
+            if (std::ranges::find(keys, key) != std::end(keys))
+                result += line + '\n';
+        }
+
+        return result;
+    }();
+
+    return identity;
+}
+
+/* Runs a command to completion, discarding its output. Returns false
+ * if it couldn't be started (e.g. there's no compiler installed), which
+ * is reported, or didn't succeed...
+ */
+auto run_quietly(std::vector<std::string> const& args) -> bool
+{
+    std::vector<char*> argv;
+    for (auto const& arg : args)
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(
+        &actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(
+        &actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    pid_t pid;
+    auto const spawn_result
+        = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (spawn_result != 0) {
+        std::cerr << "native shaders: can't run " << args.front() << ": "
+                  << std::strerror(spawn_result) << '\n';
+        return false;
+    }
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR)
+            return false;
+    }
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+NativeShaderCompiler::NativeShaderCompiler(fs::path cache_directory)
+    : directory_ { std::move(cache_directory) }
+{
+    fs::create_directories(directory_);
+}
+
+NativeShaderCompiler::~NativeShaderCompiler()
+{
+    wait();
+}
+
+auto NativeShaderCompiler::compile(std::string source,
+                                   std::shared_ptr<ShaderSlot> slot) -> void
+{
+    RGBCTL_EXPECTS(slot);
+
+    std::lock_guard lock { workers_mutex_ };
+    reap();
+
+    auto const revision = slot->revision();
+    auto done = std::make_shared<std::atomic_bool>(false);
+    auto worker = [output = path(source),
+                   source = std::move(source),
+                   revision,
+                   slot = std::move(slot),
+                   done] {
+        block_loop_signals();
+
+        try {
+            std::error_code ec;
+            if (fs::exists(output, ec) || compile_library(source, output))
+                slot->replace(load_user_shader_library(output), revision);
+        }
+        catch (...) {
+            /* Falling back to whatever the slot already has...
+             */
+        }
+
+        done->store(true, std::memory_order_release);
+    };
+
+    workers_.push_back(Worker { .thread = std::thread { std::move(worker) },
+                                .done = std::move(done) });
+}
+
+auto NativeShaderCompiler::wait() -> void
+{
+    std::lock_guard lock { workers_mutex_ };
+    for (auto& worker : workers_)
+        worker.thread.join();
+
+    workers_.clear();
+}
+
+auto NativeShaderCompiler::reap() -> void
+{
+    /* Shaders can be recompiled every time they're saved, so don't let
+     * finished workers pile up...
+     */
+    auto finished = std::partition(
+        workers_.begin(), workers_.end(), [](auto const& worker) {
+            return !worker.done->load(std::memory_order_acquire);
+        });
+
+    for (auto pos = finished; pos != workers_.end(); ++pos)
+        pos->thread.join();
+
+    workers_.erase(finished, workers_.end());
+}
+
+auto NativeShaderCompiler::compile_library(std::string const& source,
+                                           fs::path const& output) -> bool
+{
+    auto const library_path = user_shader_temporary_path(output);
+
+    auto source_path = library_path;
+    source_path += ".c";
+
+    {
+        std::ofstream file { source_path };
+        if (!(file << source))
+            return false;
+    }
+
+    auto args = compiler();
+    args.insert(args.end(),
+                std::begin(kOptimisationFlags),
+                std::end(kOptimisationFlags));
+    args.insert(args.end(),
+                { "-fPIC",
+                  "-shared",
+                  "-I" RGBCTL_SHADER_INCLUDE_DIR,
+                  "-o",
+                  library_path.string(),
+                  source_path.string() });
+
+    auto const compiled = run_quietly(args);
+
+    std::error_code ec;
+    fs::remove(source_path, ec);
+
+    if (compiled)
+        fs::rename(library_path, output, ec);
+
+    if (!compiled || ec) {
+        fs::remove(library_path, ec);
+        return false;
+    }
+
+    return true;
+}
+
+auto NativeShaderCompiler::path(std::string const& source) const -> fs::path
+{
+    auto hash = fnv1a(source);
+    auto const cc = compiler();
+    hash = fnv1a(compiler_identity(cc.front()), hash);
+    for (auto const& word : std::span { cc }.subspan(1))
+        hash = fnv1a(word, hash);
+    hash = fnv1a(cpu_identity(), hash);
+    for (auto const* flag : kOptimisationFlags)
+        hash = fnv1a(flag, hash);
+    hash = fnv1a(RGBCTL_STRINGIFY(RGBCTL_SHADER_ABI_VERSION), hash);
+
+    return directory_ / (to_hex(hash) + ".native.so");
+}
+
+} // namespace rgbctl
@@ -0,0 +1,162 @@
+#include "rgbctl/output_stage.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+
+/* Enough LEDs for any zone we know of, in one pass...
+ */
+std::size_t constexpr kBlockSize = 64;
+
+auto sources(rgbctl_channel_order order) -> std::array<std::size_t, 3>
+{
+    switch (order) {
+    case RGBCTL_CHANNEL_ORDER_RGB:
+        return { 0, 1, 2 };
+    case RGBCTL_CHANNEL_ORDER_RBG:
+        return { 0, 2, 1 };
+    case RGBCTL_CHANNEL_ORDER_GRB:
+        return { 1, 0, 2 };
+    case RGBCTL_CHANNEL_ORDER_GBR:
+        return { 1, 2, 0 };
+    case RGBCTL_CHANNEL_ORDER_BRG:
+        return { 2, 0, 1 };
+    case RGBCTL_CHANNEL_ORDER_BGR:
+        return { 2, 1, 0 };
+    }
+
+    throw std::invalid_argument { "output stage: channel order" };
+}
+
+/* NaN and anything below zero come out as zero...
+ */
+auto quantise(float value) noexcept -> std::uint16_t
+{
+    auto constexpr kMax = static_cast<float>(rgbctl::OutputStage::kLutSize - 1);
+    auto const clamped = std::min(std::max(0.f, value), 1.f);
+    return static_cast<std::uint16_t>(
+        static_cast<std::int32_t>(clamped * kMax + .5f));
+}
+
+std::uint8_t constexpr kHalf = 0x80;
+
+auto to_byte(std::uint16_t fixed) noexcept -> std::uint8_t
+{
+    return static_cast<std::uint8_t>((fixed + kHalf) >> 8);
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+OutputStage::OutputStage(OutputOptions const& options,
+                         rgbctl_channel_order order)
+    : options_ { options }
+    , order_ { order }
+    , sources_ { sources(order) }
+    , luts_(3 * kLutSize)
+{
+    for (std::size_t channel = 0; channel < 3; ++channel) {
+        auto const scale
+            = options.brightness * options.white_balance[channel];
+        auto* lut = luts_.data() + channel * kLutSize;
+
+        for (std::size_t n = 0; n < kLutSize; ++n) {
+            auto const x
+                = static_cast<float>(n) / static_cast<float>(kLutSize - 1);
+            auto const y
+                = std::clamp(std::pow(x, options.gamma) * scale, 0.f, 1.f);
+            lut[n] = static_cast<std::uint16_t>(
+                std::lround(y * static_cast<float>(0xff00)));
+        }
+    }
+}
+
+auto OutputStage::options() const noexcept -> OutputOptions const&
+{
+    return options_;
+}
+
+auto OutputStage::channel_order() const noexcept -> rgbctl_channel_order
+{
+    return order_;
+}
+
+/* Done a block at a time, in three passes. Quantising has no branches
+ * or lookups, and neither has rounding or dithering, so the compiler
+ * can vectorise both across the block, a colour's three channels at a
+ * time. Only the lookups themselves, and copying the bytes out, are
+ * done an LED at a time...
+ */
+auto OutputStage::apply(std::span<RgbFloat const> in,
+                        std::span<rgbctl_rgb_value> out) -> std::size_t
+{
+    auto const count = std::min(in.size(), out.size());
+    if (options_.dither && residues_.size() < count * 3)
+        residues_.resize(count * 3, kHalf);
+
+    auto const [red_source, green_source, blue_source] = sources_;
+    auto const* red = luts_.data() + red_source * kLutSize;
+    auto const* green = luts_.data() + green_source * kLutSize;
+    auto const* blue = luts_.data() + blue_source * kLutSize;
+
+    std::array<std::uint16_t, kBlockSize * 3> indices;
+    std::array<std::uint16_t, kBlockSize * 3> fixed;
+    std::array<std::uint8_t, kBlockSize * 3> bytes;
+    for (std::size_t first = 0; first < count; first += kBlockSize) {
+        auto const block = std::min(kBlockSize, count - first);
+
+        for (std::size_t n = 0; n < block; ++n) {
+            auto const& colour = in[first + n];
+            for (std::size_t c = 0; c < 3; ++c)
+                indices[n * 3 + c] = quantise(colour[c]);
+        }
+
+        for (std::size_t n = 0; n < block; ++n) {
+            auto const* index = &indices[n * 3];
+            fixed[n * 3] = red[index[red_source]];
+            fixed[n * 3 + 1] = green[index[green_source]];
+            fixed[n * 3 + 2] = blue[index[blue_source]];
+        }
+
+        if (options_.dither) {
+            dither(fixed.data(),
+                   residues_.data() + first * 3,
+                   bytes.data(),
+                   block);
+        }
+        else {
+            for (std::size_t n = 0; n < block * 3; ++n)
+                bytes[n] = to_byte(fixed[n]);
+        }
+
+        for (std::size_t n = 0; n < block; ++n) {
+            out[first + n] = { .red = bytes[n * 3],
+                               .green = bytes[n * 3 + 1],
+                               .blue = bytes[n * 3 + 2] };
+        }
+    }
+
+    return count;
+}
+
+/* Each channel's fraction of a byte is carried over to the next frame,
+ * so over a few frames the bytes sent average out to the colour asked
+ * for...
+ */
+auto OutputStage::dither(std::uint16_t const* fixed,
+                         std::uint8_t* residues,
+                         std::uint8_t* bytes,
+                         std::size_t count) noexcept -> void
+{
+    for (std::size_t n = 0; n < count * 3; ++n) {
+        auto const sum = fixed[n] + residues[n];
+        bytes[n] = static_cast<std::uint8_t>(sum >> 8);
+        residues[n] = static_cast<std::uint8_t>(sum);
+    }
+}
+
+} // namespace rgbctl
@@ -0,0 +1,183 @@
+#include "rgbctl/plugin_registry.hpp"
+#include "rgbctl/assert.hpp"
+#include "rgbctl/utils.hpp"
+#include <algorithm>
+#include <dlfcn.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+auto plugin_error(fs::path const& path, char const* what) -> std::runtime_error
+{
+    return std::runtime_error { "plugin: " + path.string() + ": " + what };
+}
+
+auto is_plugin_file(fs::directory_entry const& entry) -> bool
+{
+    return entry.is_regular_file() && entry.path().extension() == ".so";
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+auto PluginRegistry::DlDeleter::operator()(void* handle) const noexcept -> void
+{
+    dlclose(handle);
+}
+
+PluginRegistry::PluginRegistry() noexcept = default;
+
+PluginRegistry::PluginRegistry(PluginRegistry&&) noexcept = default;
+
+PluginRegistry::~PluginRegistry() = default;
+
+auto PluginRegistry::operator=(PluginRegistry&&) noexcept
+    -> PluginRegistry& = default;
+
+auto PluginRegistry::scan(fs::path const& directory) -> std::size_t
+{
+    std::error_code ec;
+    fs::directory_iterator entries { directory, ec };
+    if (ec)
+        return 0;
+
+    /* Sort the paths so that, when two plugins advertise the same
+     * product, which one wins doesn't depend on directory order...
+     */
+    std::vector<fs::path> paths;
+    for (auto const& entry : entries) {
+        if (is_plugin_file(entry))
+            paths.push_back(entry.path());
+    }
+
+    std::sort(paths.begin(), paths.end());
+
+    std::size_t added = 0;
+    for (auto const& path : paths) {
+        try {
+            add(path);
+            ++added;
+        }
+        catch (std::exception const& e) {
+            std::cerr << e.what() << '\n';
+        }
+    }
+
+    return added;
+}
+
+auto PluginRegistry::add(fs::path const& path) -> void
+{
+    /* Only resolve what we need to read the product list. The handle
+     * is closed again when we return...
+     */
+    auto handle = open(path, RTLD_LAZY | RTLD_LOCAL);
+    auto const reg = registration(handle.get(), path);
+
+    auto plugin = std::make_unique<Plugin>(
+        Plugin { .path = path, .handle = nullptr, .registration = {} });
+
+    for (std::uint32_t n = 0; n < reg.product_count; ++n) {
+        if (supports(reg.products[n]))
+            continue;
+
+        products_.push_back(reg.products[n]);
+        product_owners_.push_back(plugin.get());
+    }
+
+    plugins_.push_back(std::move(plugin));
+}
+
+auto PluginRegistry::supports(rgbctl_product_id id) const noexcept -> bool
+{
+    return find(id) != nullptr;
+}
+
+auto PluginRegistry::products() const noexcept
+    -> std::span<rgbctl_product_id const>
+{
+    return { products_.data(), products_.size() };
+}
+
+auto PluginRegistry::load(rgbctl_product_id id)
+    -> rgbctl_module_registration const&
+{
+    auto* plugin = find(id);
+    if (!plugin)
+        throw std::runtime_error { "plugin: no plugin supports product" };
+
+    if (!plugin->handle) {
+        auto handle = open(plugin->path, RTLD_NOW | RTLD_LOCAL);
+        plugin->registration = registration(handle.get(), plugin->path);
+        plugin->handle = std::move(handle);
+    }
+
+    return plugin->registration;
+}
+
+auto PluginRegistry::plugin_count() const noexcept -> std::size_t
+{
+    return plugins_.size();
+}
+
+auto PluginRegistry::loaded_count() const noexcept -> std::size_t
+{
+    return static_cast<std::size_t>(
+        std::count_if(plugins_.begin(), plugins_.end(), [](auto const& p) {
+            return p->handle != nullptr;
+        }));
+}
+
+auto PluginRegistry::open(fs::path const& path, int flags) -> DlPtr
+{
+    DlPtr handle { dlopen(path.c_str(), flags) };
+    if (!handle)
+        throw plugin_error(path, dlerror());
+
+    return handle;
+}
+
+auto PluginRegistry::registration(void* handle, fs::path const& path)
+    -> rgbctl_module_registration
+{
+    RGBCTL_EXPECTS(handle);
+
+    auto const* abi_version = reinterpret_cast<std::uint32_t const*>(
+        dlsym(handle, "rgbctl_module_abi_version"));
+    if (!abi_version)
+        throw plugin_error(path, "missing rgbctl_module_abi_version");
+
+    if (*abi_version != RGBCTL_MODULE_ABI_VERSION)
+        throw plugin_error(path, "incompatible ABI version");
+
+    auto init = reinterpret_cast<rgbctl_module_init>(dlsym(handle, "init"));
+    if (!init)
+        throw plugin_error(path, "missing init");
+
+    rgbctl_module_registration reg {};
+    if (init(&reg) != RGBCTL_SUCCESS)
+        throw plugin_error(path, "init failed");
+
+    if (reg.product_count && (!reg.products || !reg.acquire_callback))
+        throw plugin_error(path, "invalid registration");
+
+    return reg;
+}
+
+auto PluginRegistry::find(rgbctl_product_id id) const noexcept -> Plugin*
+{
+    auto pos = std::find(products_.begin(), products_.end(), id);
+    if (pos == products_.end())
+        return nullptr;
+
+    return product_owners_[static_cast<std::size_t>(pos - products_.begin())];
+}
+
+} // namespace rgbctl
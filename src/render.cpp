@@ -0,0 +1,77 @@
+#include "rgbctl/render.hpp"
+#include "rgbctl/trace.hpp"
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace rgbctl
+{
+
+auto RenderStats::frames_per_second() const noexcept -> double
+{
+    if (elapsed.count() <= 0)
+        return 0.0;
+
+    return static_cast<double>(frames)
+           / std::chrono::duration<double> { elapsed }.count();
+}
+
+auto render(std::span<RenderZone> zones,
+            RenderOptions const& options,
+            std::ostream& out) -> RenderStats
+{
+    if (options.frame_period.count() <= 0)
+        throw std::invalid_argument { "render: frame period" };
+
+    auto const frames = static_cast<std::size_t>(
+        std::max(options.duration / options.frame_period,
+                 std::chrono::milliseconds::rep { 0 }));
+    auto const ms_per_frame
+        = static_cast<std::size_t>(options.frame_period.count());
+
+    std::size_t width = 0;
+    for (auto const& zone : zones)
+        width += zone.rgb_count;
+
+    if (options.format == RenderFormat::Ppm)
+        out << "P6\n" << width << ' ' << frames << "\n255\n";
+
+    OutputStage output { options.output };
+    std::vector<RgbFloat> colours(width);
+    std::vector<rgbctl_rgb_value> frame(width);
+    std::vector<unsigned char> row(width * 3);
+
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < frames; ++n) {
+        RGBCTL_TRACE_SCOPE("render::frame");
+
+        std::fill(colours.begin(), colours.end(), RgbFloat {});
+        std::size_t offset = 0;
+        for (auto& zone : zones) {
+            zone.effect.tick(
+                ms_per_frame,
+                std::span { colours }.subspan(offset, zone.rgb_count));
+            offset += zone.rgb_count;
+        }
+
+        output.apply(colours, frame);
+
+        auto byte = row.begin();
+        for (auto const& rgb : frame) {
+            *byte++ = rgb.red;
+            *byte++ = rgb.green;
+            *byte++ = rgb.blue;
+        }
+
+        out.write(reinterpret_cast<char const*>(row.data()),
+                  static_cast<std::streamsize>(row.size()));
+        if (!out)
+            throw std::runtime_error { "render: write frame" };
+    }
+
+    return RenderStats { .frames = frames,
+                         .elapsed = std::chrono::steady_clock::now() - start };
+}
+
+} // namespace rgbctl
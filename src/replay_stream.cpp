@@ -0,0 +1,98 @@
+#include "rgbctl/replay_stream.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace rgbctl
+{
+
+ReplayStream::ReplayStream(std::vector<TrafficRecord> records,
+                           ReplayTiming timing)
+    : records_ { std::move(records) }
+    , next_ { 0 }
+    , divergences_ { 0 }
+    , timing_ { timing }
+    , started_ns_ { trace::now() }
+{ }
+
+auto ReplayStream::read(unsigned char* buffer, std::uint32_t len) noexcept
+    -> rgbctl_errno
+{
+    auto const* record = next(TrafficDirection::Read);
+    if (!record)
+        return -RGBCTL_ERR_READ;
+
+    /* The read must ask for as much as the recorded one did...
+     */
+    if (len != record->requested)
+        ++divergences_;
+
+    auto const n = std::min(record->data.size(), std::size_t { len });
+    std::copy_n(record->data.begin(), n, buffer);
+    wait(*record);
+
+    return record->result < 0 ? record->result : static_cast<rgbctl_errno>(n);
+}
+
+auto ReplayStream::write(unsigned char const* buffer,
+                         std::uint32_t len) noexcept -> rgbctl_errno
+{
+    auto const* record = next(TrafficDirection::Write);
+    if (!record)
+        return -RGBCTL_ERR_WRITE;
+
+    /* The write must ask for as much as the recorded one did. A failed
+     * write records no bytes to compare, and a short one only those
+     * that were accepted...
+     */
+    if (len != record->requested
+        || !std::equal(record->data.begin(), record->data.end(), buffer))
+        ++divergences_;
+
+    wait(*record);
+    return record->result;
+}
+
+auto ReplayStream::divergences() const noexcept -> std::size_t
+{
+    return divergences_;
+}
+
+auto ReplayStream::remaining() const noexcept -> std::size_t
+{
+    return records_.size() - next_;
+}
+
+/* A transfer of the wrong kind takes the place of the recorded one,
+ * so that replay can carry on...
+ */
+auto ReplayStream::next(TrafficDirection direction) noexcept
+    -> TrafficRecord const*
+{
+    if (next_ == records_.size()) {
+        ++divergences_;
+        return nullptr;
+    }
+
+    auto const& record = records_[next_++];
+    if (record.direction != direction) {
+        ++divergences_;
+        return nullptr;
+    }
+
+    return &record;
+}
+
+auto ReplayStream::wait(TrafficRecord const& record) const noexcept -> void
+{
+    if (timing_ != ReplayTiming::Recorded)
+        return;
+
+    auto const now_ns = trace::now();
+    auto const until_ns = std::max(started_ns_ + record.start_ns, now_ns)
+                          + record.duration_ns;
+    std::this_thread::sleep_for(std::chrono::nanoseconds {
+        static_cast<std::chrono::nanoseconds::rep>(until_ns - now_ns) });
+}
+
+} // namespace rgbctl
@@ -0,0 +1,142 @@
+#include "rgbctl/resampler.hpp"
+#include "rgbctl/narrow.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+
+using rgbctl::Resampling;
+
+struct Tap
+{
+    std::size_t index;
+    float weight;
+};
+
+/* The source LEDs that go into target LED `n`, where each target LED
+ * is `scale` source LEDs wide...
+ */
+auto taps_for(std::size_t n,
+              std::size_t source_size,
+              float scale,
+              Resampling resampling) -> std::vector<Tap>
+{
+    auto const last = source_size - 1;
+    auto const centre = (static_cast<float>(n) + .5f) * scale;
+
+    switch (resampling) {
+    case Resampling::Nearest:
+        return { { std::min(static_cast<std::size_t>(centre), last), 1.f } };
+
+    case Resampling::Linear: {
+        auto const x = std::clamp(centre - .5f, 0.f, static_cast<float>(last));
+        auto const left = static_cast<std::size_t>(x);
+        auto const t = x - static_cast<float>(left);
+        return { { left, 1.f - t }, { std::min(left + 1, last), t } };
+    }
+
+    case Resampling::Area:
+    default: {
+        auto const low = static_cast<float>(n) * scale;
+        auto const high = low + scale;
+
+        std::vector<Tap> taps;
+        for (auto i = static_cast<std::size_t>(low);
+             i < source_size && static_cast<float>(i) < high;
+             ++i) {
+            auto const from = std::max(low, static_cast<float>(i));
+            auto const to = std::min(high, static_cast<float>(i + 1));
+            if (to > from)
+                taps.push_back({ i, (to - from) / scale });
+        }
+
+        return taps;
+    }
+    }
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+Resampler::Resampler(std::size_t source_size,
+                     std::size_t target_size,
+                     Resampling resampling)
+    : source_size_ { source_size }
+    , target_size_ { target_size }
+    , resampling_ { resampling }
+    , taps_ { 0 }
+    , indices_ {}
+    , weights_ {}
+{
+    if (!source_size || !target_size)
+        throw std::invalid_argument { "resampler: empty frame" };
+
+    if (!can_narrow<std::uint32_t>(source_size))
+        throw std::invalid_argument { "resampler: frame too large" };
+
+    auto const scale
+        = static_cast<float>(source_size) / static_cast<float>(target_size);
+
+    std::vector<std::vector<Tap>> taps(target_size);
+    for (std::size_t n = 0; n < target_size; ++n) {
+        taps[n] = taps_for(n, source_size, scale, resampling);
+        taps_ = std::max(taps_, taps[n].size());
+    }
+
+    /* LEDs with fewer taps than the most are padded with taps that
+     * weigh nothing...
+     */
+    indices_.resize(taps_ * target_size);
+    weights_.resize(taps_ * target_size);
+    for (std::size_t n = 0; n < target_size; ++n) {
+        for (std::size_t k = 0; k < taps[n].size(); ++k) {
+            indices_[k * target_size + n]
+                = static_cast<std::uint32_t>(taps[n][k].index);
+            weights_[k * target_size + n] = taps[n][k].weight;
+        }
+    }
+}
+
+auto Resampler::source_size() const noexcept -> std::size_t
+{
+    return source_size_;
+}
+
+auto Resampler::target_size() const noexcept -> std::size_t
+{
+    return target_size_;
+}
+
+auto Resampler::resampling() const noexcept -> Resampling
+{
+    return resampling_;
+}
+
+auto Resampler::apply(std::span<RgbFloat const> source,
+                      std::span<RgbFloat> target) const -> std::size_t
+{
+    if (source.size() != source_size_ || target.size() < target_size_)
+        throw std::invalid_argument { "resampler: frame size" };
+
+    std::fill_n(target.begin(), target_size_, RgbFloat {});
+
+    for (std::size_t k = 0; k < taps_; ++k) {
+        auto const* indices = indices_.data() + k * target_size_;
+        auto const* weights = weights_.data() + k * target_size_;
+
+        for (std::size_t n = 0; n < target_size_; ++n) {
+            auto const& from = source[indices[n]];
+            auto& to = target[n];
+            for (std::size_t c = 0; c < 3; ++c)
+                to[c] += from[c] * weights[n];
+        }
+    }
+
+    return target_size_;
+}
+
+} // namespace rgbctl
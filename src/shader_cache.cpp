@@ -0,0 +1,78 @@
+#include "rgbctl/shader_cache.hpp"
+#include "rgbctl/hash.hpp"
+#include "rgbctl/utils.hpp"
+#include <cstdlib>
+
+namespace fs = std::filesystem;
+
+namespace rgbctl
+{
+
+ShaderCache::ShaderCache(fs::path directory)
+    : directory_ { std::move(directory) }
+{
+    fs::create_directories(directory_);
+}
+
+auto ShaderCache::default_directory() -> fs::path
+{
+    auto const* cache_home = std::getenv("XDG_CACHE_HOME");
+    if (cache_home && *cache_home)
+        return fs::path { cache_home } / "rgbctl" / "shaders";
+
+    auto const* home = std::getenv("HOME");
+    if (home && *home)
+        return fs::path { home } / ".cache" / "rgbctl" / "shaders";
+
+    return fs::temp_directory_path() / "rgbctl" / "shaders";
+}
+
+auto ShaderCache::load(std::string const& source) -> UserShader
+{
+    auto const cached = path(source);
+
+    std::error_code ec;
+    if (!fs::exists(cached, ec)) {
+        /* Compile next to the cache entry and rename it into place, so
+         * that a concurrent reader never sees a half written file...
+         */
+        auto const tmp = user_shader_temporary_path(cached);
+
+        try {
+            compile_user_shader_library(source, tmp);
+            fs::rename(tmp, cached);
+        }
+        catch (...) {
+            fs::remove(tmp, ec);
+            throw;
+        }
+    }
+
+    return load_user_shader_library(cached);
+}
+
+auto ShaderCache::load_file(fs::path const& path) -> UserShader
+{
+    return load(read_user_shader_source(path));
+}
+
+auto ShaderCache::key(std::string const& source) const -> std::uint64_t
+{
+    auto hash = fnv1a(source);
+    hash = fnv1a(user_shader_compiler_id(), hash);
+    hash = fnv1a(RGBCTL_STRINGIFY(RGBCTL_SHADER_ABI_VERSION), hash);
+
+    return hash;
+}
+
+auto ShaderCache::path(std::string const& source) const -> fs::path
+{
+    return directory_ / (to_hex(key(source)) + ".so");
+}
+
+auto ShaderCache::directory() const noexcept -> fs::path const&
+{
+    return directory_;
+}
+
+} // namespace rgbctl
@@ -0,0 +1,60 @@
+#include "rgbctl/shader_slot.hpp"
+
+namespace rgbctl
+{
+
+ShaderSlot::ShaderSlot(UserShader initial) noexcept
+    : current_ { std::move(initial) }
+    , pending_ { nullptr }
+    , generation_ { 0 }
+    , revision_ { 0 }
+{ }
+
+auto ShaderSlot::publish(UserShader shader) -> void
+{
+    std::lock_guard lock { publish_mutex_ };
+    revision_.fetch_add(1, std::memory_order_release);
+    store(std::move(shader));
+}
+
+auto ShaderSlot::replace(UserShader shader, std::uint32_t revision) -> bool
+{
+    /* Only publishers take the lock; the animation thread never waits
+     * on it...
+     */
+    std::lock_guard lock { publish_mutex_ };
+    if (revision_.load(std::memory_order_relaxed) != revision)
+        return false;
+
+    store(std::move(shader));
+    return true;
+}
+
+auto ShaderSlot::acquire() noexcept -> UserShader const&
+{
+    /* The previous shader is released here, on the animation thread,
+     * once nothing can still be running it...
+     */
+    if (auto next = pending_.exchange(nullptr))
+        current_ = std::move(*next);
+
+    return current_;
+}
+
+auto ShaderSlot::generation() const noexcept -> std::uint32_t
+{
+    return generation_.load(std::memory_order_acquire);
+}
+
+auto ShaderSlot::revision() const noexcept -> std::uint32_t
+{
+    return revision_.load(std::memory_order_acquire);
+}
+
+auto ShaderSlot::store(UserShader shader) -> void
+{
+    pending_.store(std::make_shared<UserShader>(std::move(shader)));
+    generation_.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace rgbctl
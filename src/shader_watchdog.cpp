@@ -0,0 +1,256 @@
+#include "rgbctl/shader_watchdog.hpp"
+#include "rgbctl/assert.hpp"
+#include "rgbctl/loop.hpp"
+#include "rgbctl/metrics.hpp"
+#include "rgbctl/narrow.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+/* Shared by every watchdog. Incremented when a worker is abandoned,
+ * and decremented by the worker itself if its shader ever returns...
+ */
+std::atomic<std::uint32_t> abandoned_worker_count = 0;
+
+} // namespace
+
+namespace rgbctl
+{
+
+/* Everything the worker touches lives here, and the worker shares
+ * ownership of it, so an abandoned worker never refers back to the
+ * watchdog...
+ */
+struct ShaderWatchdog::Job
+{
+    enum class State
+    {
+        Idle,
+        Pending,
+        Done
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    State state = State::Idle;
+    bool stop = false;
+    bool abandoned = false;
+
+    /* Only touched by the worker while `state` is `Pending`, and by
+     * the watchdog otherwise...
+     */
+    UserShader shader;
+    std::shared_ptr<Texture const> texture;
+    std::vector<float> u;
+    std::vector<float> v;
+    std::vector<rgbctl_rgb_float_value> out;
+    float stage = 0.f;
+    std::uint32_t elapsed_ms = 0;
+    std::chrono::nanoseconds duration {};
+};
+
+auto ShaderWatchdog::work(std::shared_ptr<Job> job) -> void
+{
+    block_loop_signals();
+
+    std::unique_lock lock { job->mutex };
+    while (true) {
+        job->cv.wait(lock, [&] {
+            return job->stop || job->state == Job::State::Pending;
+        });
+
+        if (job->stop) {
+            if (job->abandoned)
+                abandoned_worker_count.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+
+        lock.unlock();
+
+        rgbctl_shader_input const input {
+            .u = job->u.data(),
+            .v = job->v.data(),
+            .count = narrow_cast<std::uint32_t>(job->u.size()),
+            .stage = job->stage,
+            .elapsed_ms = job->elapsed_ms,
+            .texture = job->texture.get(),
+        };
+
+        auto const started = Clock::now();
+        job->shader(input, job->out);
+        auto const duration = Clock::now() - started;
+
+        lock.lock();
+        job->duration = duration;
+        job->state = Job::State::Done;
+        job->cv.notify_all();
+    }
+}
+
+ShaderWatchdog::ShaderWatchdog(ShaderBudget budget)
+    : budget_ { budget }
+    , consecutive_overruns_ { 0 }
+    , demoted_ { false }
+    , timings_ {}
+{ }
+
+ShaderWatchdog::~ShaderWatchdog()
+{
+    if (job_)
+        abandon();
+}
+
+auto ShaderWatchdog::run(UserShader const& shader,
+                         rgbctl_shader_input const& input,
+                         std::shared_ptr<Texture const> const& texture,
+                         std::span<rgbctl_rgb_float_value> out) -> bool
+{
+    RGBCTL_EXPECTS(shader);
+    RGBCTL_EXPECTS(out.size() >= input.count);
+
+    if (demoted_)
+        return false;
+
+    timings_.frames++;
+
+    if (!budget_.per_frame.count()) {
+        auto const started = Clock::now();
+        shader(input, out);
+        timings_.last = Clock::now() - started;
+        timings_.max = std::max(timings_.max, timings_.last);
+        return true;
+    }
+
+    if (!job_) {
+        if (abandoned_worker_count.load(std::memory_order_relaxed)
+            >= kMaxAbandonedShaderWorkers) {
+            std::cerr << "shader watchdog: too many shaders stuck running, "
+                         "not starting another\n";
+            demoted_ = true;
+            return false;
+        }
+
+        start();
+    }
+
+    auto& job = *job_;
+    std::unique_lock lock { job.mutex };
+
+    if (job.state == Job::State::Pending) {
+        lock.unlock();
+        return overrun();
+    }
+
+    job.shader = shader;
+    job.texture = texture;
+    job.u.assign(input.u, input.u + input.count);
+    job.v.assign(input.v, input.v + input.count);
+    job.out.resize(input.count);
+    job.stage = input.stage;
+    job.elapsed_ms = input.elapsed_ms;
+    job.state = Job::State::Pending;
+    job.cv.notify_all();
+
+    auto const deadline = Clock::now() + budget_.per_frame;
+    if (!job.cv.wait_until(
+            lock, deadline, [&] { return job.state == Job::State::Done; })) {
+        lock.unlock();
+        return overrun();
+    }
+
+    std::copy(job.out.begin(), job.out.end(), out.begin());
+    job.state = Job::State::Idle;
+
+    timings_.last = job.duration;
+    timings_.max = std::max(timings_.max, timings_.last);
+    consecutive_overruns_ = 0;
+
+    return true;
+}
+
+auto ShaderWatchdog::reset() -> void
+{
+    /* Whatever's still running belongs to the old shader...
+     */
+    if (job_)
+        abandon();
+
+    consecutive_overruns_ = 0;
+    demoted_ = false;
+}
+
+auto ShaderWatchdog::demoted() const noexcept -> bool
+{
+    return demoted_;
+}
+
+auto ShaderWatchdog::timings() const noexcept -> ShaderTimings const&
+{
+    return timings_;
+}
+
+auto ShaderWatchdog::abandoned_workers() noexcept -> std::uint32_t
+{
+    return abandoned_worker_count.load(std::memory_order_relaxed);
+}
+
+auto ShaderWatchdog::start() -> void
+{
+    job_ = std::make_shared<Job>();
+    worker_ = std::thread { work, job_ };
+}
+
+auto ShaderWatchdog::overrun() -> bool
+{
+    timings_.overruns++;
+
+    if (++consecutive_overruns_ >= std::max(budget_.max_overruns, 1u)) {
+        demoted_ = true;
+        abandon();
+    }
+
+    return false;
+}
+
+auto ShaderWatchdog::abandon() -> void
+{
+    RGBCTL_EXPECTS(job_);
+
+    bool running;
+    {
+        std::lock_guard lock { job_->mutex };
+        job_->stop = true;
+        running = job_->state == Job::State::Pending;
+        job_->cv.notify_all();
+
+        /* Counted while the worker can't yet see `stop`, so it can
+         * never uncount itself first...
+         */
+        if (running) {
+            job_->abandoned = true;
+            abandoned_worker_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /* There's no safe way of stopping a shader part way through, so a
+     * worker that's still running one is left to finish on its own...
+     */
+    if (running) {
+        metrics::add(metrics::Counter::ShaderWorkersAbandoned);
+        worker_.detach();
+    }
+    else
+        worker_.join();
+
+    job_.reset();
+}
+
+} // namespace rgbctl
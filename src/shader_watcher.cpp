@@ -0,0 +1,168 @@
+#include "rgbctl/shader_watcher.hpp"
+#include "rgbctl/assert.hpp"
+#include "rgbctl/loop.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr std::uint32_t kWatchEvents = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+auto last_error() -> std::system_error
+{
+    return std::system_error { errno, std::system_category() };
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+ShaderWatcher::ShaderWatcher(NativeShaderCompiler* native_compiler)
+    : native_compiler_ { native_compiler }
+    , inotify_fd_ { inotify_init1(IN_NONBLOCK | IN_CLOEXEC) }
+    , stop_fds_ { -1, -1 }
+    , reloads_ { 0 }
+{
+    if (inotify_fd_ < 0)
+        throw last_error();
+
+    if (pipe2(stop_fds_, O_CLOEXEC) < 0) {
+        auto error = last_error();
+        close(inotify_fd_);
+        throw error;
+    }
+
+    thread_ = std::thread { [this] { run(); } };
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+    char const stop = 0;
+    while (write(stop_fds_[1], &stop, 1) < 0 && errno == EINTR)
+        ;
+
+    thread_.join();
+
+    close(stop_fds_[0]);
+    close(stop_fds_[1]);
+    close(inotify_fd_);
+}
+
+auto ShaderWatcher::watch(fs::path const& source,
+                          std::shared_ptr<ShaderSlot> slot) -> void
+{
+    RGBCTL_EXPECTS(slot);
+
+    auto path = fs::absolute(source);
+    auto const descriptor = inotify_add_watch(
+        inotify_fd_, path.parent_path().c_str(), kWatchEvents);
+    if (descriptor < 0)
+        throw last_error();
+
+    std::lock_guard lock { watches_mutex_ };
+    watches_.push_back(Watch { .descriptor = descriptor,
+                               .source = std::move(path),
+                               .slot = std::move(slot) });
+}
+
+auto ShaderWatcher::reload_count() const noexcept -> std::uint32_t
+{
+    return reloads_.load(std::memory_order_acquire);
+}
+
+auto ShaderWatcher::run() -> void
+{
+    block_loop_signals();
+
+    pollfd fds[] = { { .fd = inotify_fd_, .events = POLLIN, .revents = 0 },
+                     { .fd = stop_fds_[0], .events = POLLIN, .revents = 0 } };
+
+    alignas(inotify_event) char buffer[4096];
+
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+
+            std::cerr << "shader watcher: " << last_error().what() << '\n';
+            return;
+        }
+
+        if (fds[1].revents)
+            return;
+
+        /* Drain everything that's queued before reloading, so that a
+         * burst of events for one save only compiles the shader once...
+         */
+        std::vector<Watch> reloads;
+        ssize_t bytes_read;
+        while ((bytes_read = read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+            for (auto const* pos = buffer; pos < buffer + bytes_read;) {
+                auto const* event
+                    = reinterpret_cast<inotify_event const*>(pos);
+                pos += sizeof(inotify_event) + event->len;
+
+                if (!event->len)
+                    continue;
+
+                for (auto& watch : changed(event->wd, event->name)) {
+                    auto const pending = std::any_of(
+                        reloads.begin(), reloads.end(), [&](auto const& w) {
+                            return w.slot == watch.slot;
+                        });
+                    if (!pending)
+                        reloads.push_back(std::move(watch));
+                }
+            }
+        }
+
+        for (auto const& watch : reloads)
+            reload(watch);
+    }
+}
+
+auto ShaderWatcher::changed(int descriptor, char const* name)
+    -> std::vector<Watch>
+{
+    std::vector<Watch> result;
+
+    std::lock_guard lock { watches_mutex_ };
+    for (auto const& watch : watches_) {
+        if (watch.descriptor == descriptor
+            && watch.source.filename() == name)
+            result.push_back(watch);
+    }
+
+    return result;
+}
+
+auto ShaderWatcher::reload(Watch const& watch) -> void
+{
+    /* Compiling happens here, on the watcher's thread. The animation
+     * thread only ever sees the finished shader...
+     */
+    try {
+        auto source = read_user_shader_source(watch.source);
+        watch.slot->publish(compile_user_shader(source));
+
+        if (native_compiler_)
+            native_compiler_->compile(std::move(source), watch.slot);
+    }
+    catch (std::exception const& e) {
+        std::cerr << watch.source.string() << ": " << e.what() << '\n';
+    }
+
+    reloads_.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace rgbctl
@@ -0,0 +1,255 @@
+#include "rgbctl/simulated_device_stream.hpp"
+#include "./builtins/builtins.hpp"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+
+using namespace rgbctl::modules::builtin;
+
+/* Corsair reports are `{ report number, 0x3f, sequence << 3 | command,
+ * data[61], checksum }`, with the checksum taken over everything after
+ * the prefix. Colour reports carry 3 bytes per LED. Responses are a
+ * byte shorter, having no report number...
+ */
+std::size_t constexpr kCorsairReportSize = 65;
+std::size_t constexpr kCorsairSequenceCommand = 2;
+std::size_t constexpr kCorsairData = 3;
+std::uint8_t constexpr kCorsairColourCommand = 0x04;
+std::size_t constexpr kCorsairLedCount = 16;
+
+std::size_t constexpr kAsusLedCount = 4;
+
+template <typename T>
+auto bytes_of(T const& value) -> std::vector<unsigned char>
+{
+    auto const* first = reinterpret_cast<unsigned char const*>(&value);
+    return { first, first + sizeof(value) };
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+auto SimulatedDeviceLimits::usb_full_speed() noexcept -> SimulatedDeviceLimits
+{
+    return { .response_latency = std::chrono::milliseconds { 1 },
+             .bytes_per_second = 64'000 };
+}
+
+SimulatedDeviceStream::SimulatedDeviceStream(SimulatedProtocol protocol,
+                                             SimulatedDeviceLimits limits)
+    : protocol_ { protocol }
+    , limits_ { limits }
+    , stats_ {}
+    , report_ {}
+    , responses_ {}
+    , leds_(protocol == SimulatedProtocol::CorsairH100iProXt
+                ? kCorsairLedCount
+                : kAsusLedCount)
+    , busy_until_ {}
+    , last_sequence_ { 0 }
+{
+    report_.reserve(report_size());
+}
+
+auto SimulatedDeviceStream::protocol() const noexcept -> SimulatedProtocol
+{
+    return protocol_;
+}
+
+auto SimulatedDeviceStream::stats() const noexcept
+    -> SimulatedDeviceStats const&
+{
+    return stats_;
+}
+
+auto SimulatedDeviceStream::leds() const noexcept
+    -> std::span<rgbctl_rgb_value const>
+{
+    return leds_;
+}
+
+auto SimulatedDeviceStream::read(unsigned char* buffer,
+                                 std::uint32_t len) noexcept -> rgbctl_errno
+{
+    /* A real device would never answer, and we'd block forever...
+     */
+    if (responses_.empty())
+        return -RGBCTL_ERR_READ;
+
+    auto& response = responses_.front();
+    std::this_thread::sleep_until(response.ready_at);
+
+    auto& data = response.data;
+    auto const n = std::min(static_cast<std::size_t>(len), data.size());
+    std::copy_n(data.begin(), n, buffer);
+    data.erase(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(n));
+    if (data.empty())
+        responses_.pop_front();
+
+    stats_.bytes_read += n;
+    return static_cast<rgbctl_errno>(n);
+}
+
+auto SimulatedDeviceStream::write(unsigned char const* buffer,
+                                  std::uint32_t len) noexcept -> rgbctl_errno
+{
+    /* The bus takes one write at a time, so a write has to wait for
+     * the last to finish as well as take its own time...
+     */
+    auto written_at = Clock::now();
+    if (limits_.bytes_per_second) {
+        busy_until_ = std::max(written_at, busy_until_)
+                      + std::chrono::microseconds {
+                            std::uint64_t { len } * 1'000'000
+                            / limits_.bytes_per_second
+                        };
+        std::this_thread::sleep_until(busy_until_);
+        written_at = busy_until_;
+    }
+
+    try {
+        for (std::uint32_t n = 0; n < len; ++n) {
+            report_.push_back(buffer[n]);
+            if (report_.size() == report_size()) {
+                on_report(written_at);
+                report_.clear();
+            }
+        }
+    }
+    catch (std::exception const&) {
+        return -RGBCTL_ERR_WRITE;
+    }
+
+    stats_.bytes_written += len;
+    return static_cast<rgbctl_errno>(len);
+}
+
+auto SimulatedDeviceStream::report_size() const noexcept -> std::size_t
+{
+    if (protocol_ == SimulatedProtocol::CorsairH100iProXt)
+        return kCorsairReportSize;
+
+    return asus::kAsusAuraReportSize;
+}
+
+auto SimulatedDeviceStream::on_report(Clock::time_point written_at) -> void
+{
+    ++stats_.reports;
+
+    auto response = protocol_ == SimulatedProtocol::CorsairH100iProXt
+                        ? on_corsair_report()
+                        : on_asus_report();
+
+    if (!response.empty())
+        respond(written_at, std::move(response));
+}
+
+/* Every report gets a response, which echoes the report's sequence and
+ * command. The device is never busy, and its liquid is always 30.5C...
+ */
+auto SimulatedDeviceStream::on_corsair_report() -> std::vector<unsigned char>
+{
+    if (report_[0] != 0x00 || report_[1] != 0x3f)
+        ++stats_.protocol_errors;
+
+    auto const checksum = corsair::compute_checksum(
+        report_.begin() + kCorsairSequenceCommand, report_.end() - 1);
+    if (checksum != report_.back())
+        ++stats_.checksum_errors;
+
+    auto const sequence_command = report_[kCorsairSequenceCommand];
+    auto const sequence = static_cast<std::uint8_t>(sequence_command >> 3);
+    if (sequence == 0 || sequence == last_sequence_)
+        ++stats_.sequence_errors;
+    last_sequence_ = sequence;
+
+    auto const command = sequence_command & 0x07;
+    if (command == kCorsairColourCommand) {
+        std::memcpy(leds_.data(),
+                    report_.data() + kCorsairData,
+                    leds_.size() * sizeof(rgbctl_rgb_value));
+        ++stats_.frames;
+    }
+    else if (command < 1 || command > 3) {
+        ++stats_.protocol_errors;
+    }
+
+    corsair::Response response {};
+    response.prefix = 0xff;
+    response.sequence = sequence_command;
+    response.firmware_1 = 0x01;
+    response.firmware_2 = 0x01;
+    response.liquid_temp_lsb = 0x80;
+    response.liquid_temp_msb = 0x1e;
+
+    auto const* first = reinterpret_cast<unsigned char const*>(&response);
+    response.checksum = corsair::compute_checksum(
+        first + 1, first + sizeof(response) - 1);
+
+    return bytes_of(response);
+}
+
+/* Only the config and firmware requests are answered...
+ */
+auto SimulatedDeviceStream::on_asus_report() -> std::vector<unsigned char>
+{
+    if (report_[0] != asus::kAsusAuraMagicNumber) {
+        ++stats_.protocol_errors;
+        return {};
+    }
+
+    switch (report_[1]) {
+    case asus::kAsusAuraConfigReportId: {
+        asus::ConfigData config {};
+        config.channel_count = 1;
+        config.led_count = static_cast<std::uint8_t>(leds_.size());
+        config.rgb_header_count = 1;
+        return bytes_of(asus::make_report(report_[1], config));
+    }
+    case asus::kAsusAuraFirmwareReportId: {
+        asus::FirmwareData firmware {};
+        std::strcpy(firmware.firmware_string.data(), "AULA3-AR32-0207");
+        return bytes_of(asus::make_report(report_[1], firmware));
+    }
+    case asus::kAsusSetModeReportId:
+        return {};
+    case asus::kAsusControlDirectReportId: {
+        asus::Report<asus::RgbData> rpt;
+        std::memcpy(&rpt, report_.data(), sizeof(rpt));
+
+        auto const& rgb_data = rpt.report_data;
+        if ((rgb_data.channel_rw & 0x7f) != asus::kAsusAuraDirectChannel
+            || rgb_data.start_led >= leds_.size()) {
+            ++stats_.protocol_errors;
+            return {};
+        }
+
+        auto const count = std::min<std::size_t>(
+            { rgb_data.led_count,
+              leds_.size() - rgb_data.start_led,
+              std::size(rgb_data.rgbs) });
+        std::copy_n(std::begin(rgb_data.rgbs),
+                    count,
+                    leds_.begin() + rgb_data.start_led);
+        ++stats_.frames;
+        return {};
+    }
+    default:
+        ++stats_.protocol_errors;
+        return {};
+    }
+}
+
+auto SimulatedDeviceStream::respond(Clock::time_point written_at,
+                                    std::vector<unsigned char> data) -> void
+{
+    responses_.push_back(
+        { written_at + limits_.response_latency, std::move(data) });
+}
+
+} // namespace rgbctl
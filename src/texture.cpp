@@ -1,34 +1,318 @@
 #include "rgbctl/texture.hpp"
 #include "rgbctl/vec.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <type_traits>
+#include <iterator>
+#include <stdexcept>
 
 using namespace rgbctl;
 
+namespace
+{
+
+/* Texel `index` of a source axis, and how much of it goes into one
+ * texel of the downsampled axis...
+ */
+struct Tap
+{
+    std::size_t index;
+    float weight;
+};
+
+auto sinc(float x) noexcept -> float
+{
+    auto constexpr kPi = 3.14159265358979f;
+    return x == 0.f ? 1.f : std::sin(kPi * x) / (kPi * x);
+}
+
+/* Source texel `i` of `count`, which may be past either edge...
+ */
+auto tap_index(std::ptrdiff_t i, std::ptrdiff_t count, Addressing addressing)
+    -> std::size_t
+{
+    switch (addressing) {
+    case Addressing::Clamp:
+        i = std::clamp(i, std::ptrdiff_t { 0 }, count - 1);
+        break;
+    case Addressing::Mirror:
+        i = i < 0 ? -i - 1 : i >= count ? 2 * count - i - 1 : i;
+        i = std::clamp(i, std::ptrdiff_t { 0 }, count - 1);
+        break;
+    case Addressing::Wrap:
+    default:
+        i = ((i % count) + count) % count;
+        break;
+    }
+
+    return static_cast<std::size_t>(i);
+}
+
+/* The taps for each texel of an axis shrunk from `size` to `new_size`.
+ * A box takes the source texels under the new texel, weighted by how
+ * much of each is covered. Lanczos reaches two new texels either side,
+ * past the edges as sampling would...
+ */
+auto taps(std::size_t size,
+          std::size_t new_size,
+          Mipmaps filter,
+          Addressing addressing) -> std::vector<std::vector<Tap>>
+{
+    auto const scale = static_cast<float>(size) / static_cast<float>(new_size);
+    std::vector<std::vector<Tap>> result(new_size);
+
+    for (std::size_t n = 0; n < new_size; ++n) {
+        auto& texel = result[n];
+        auto const low = static_cast<float>(n) * scale;
+        auto const high = low + scale;
+
+        if (filter == Mipmaps::Box) {
+            for (auto i = static_cast<std::size_t>(low);
+                 static_cast<float>(i) < high && i < size;
+                 ++i) {
+                auto const from = std::max(low, static_cast<float>(i));
+                auto const to = std::min(high, static_cast<float>(i + 1));
+                texel.push_back({ i, to - from });
+            }
+        }
+        else {
+            auto const centre = (low + high) / 2;
+            auto const first
+                = static_cast<std::ptrdiff_t>(std::floor(centre - 2 * scale));
+            auto const last
+                = static_cast<std::ptrdiff_t>(std::ceil(centre + 2 * scale));
+            auto const count = static_cast<std::ptrdiff_t>(size);
+
+            for (auto i = first; i <= last; ++i) {
+                auto const x
+                    = (static_cast<float>(i) + .5f - centre) / scale;
+                if (std::abs(x) >= 2.f)
+                    continue;
+
+                texel.push_back({ tap_index(i, count, addressing),
+                                  sinc(x) * sinc(x / 2) });
+            }
+        }
+
+        auto total = 0.f;
+        for (auto const& tap : texel)
+            total += tap.weight;
+
+        for (auto& tap : texel)
+            tap.weight /= total;
+    }
+
+    return result;
+}
+
+auto to_texel(RgbFloat const& texel) noexcept -> RgbFloat
+{
+    return texel;
+}
+
+auto to_texel(RgbUint8 const& texel) noexcept -> RgbFloat
+{
+    return { static_cast<float>(texel[0]) / 255.f,
+             static_cast<float>(texel[1]) / 255.f,
+             static_cast<float>(texel[2]) / 255.f };
+}
+
+/* Halves a level in each direction, down to one texel, a row and then
+ * a column at a time...
+ */
+auto downsample(RgbFloat const* texels,
+                std::size_t width,
+                std::size_t height,
+                Mipmaps filter,
+                Addressing addressing) -> std::vector<RgbFloat>
+{
+    auto const new_width = std::max(width / 2, std::size_t { 1 });
+    auto const new_height = std::max(height / 2, std::size_t { 1 });
+
+    std::vector<RgbFloat> rows(new_width * height);
+    auto const across = taps(width, new_width, filter, addressing);
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < new_width; ++x) {
+            RgbFloat sum { 0.f, 0.f, 0.f };
+            for (auto const& tap : across[x])
+                sum += texels[y * width + tap.index] * tap.weight;
+
+            rows[y * new_width + x] = sum;
+        }
+    }
+
+    std::vector<RgbFloat> result(new_width * new_height);
+    auto const down = taps(height, new_height, filter, addressing);
+    for (std::size_t y = 0; y < new_height; ++y) {
+        for (std::size_t x = 0; x < new_width; ++x) {
+            RgbFloat sum { 0.f, 0.f, 0.f };
+            for (auto const& tap : down[y])
+                sum += rows[tap.index * new_width + x] * tap.weight;
+
+            result[y * new_width + x] = sum;
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
 rgbctl_texture::rgbctl_texture(std::span<RgbFloat const> texels,
-                               std::size_t width)
-    : texels_ { texels.begin(), texels.end() }
-    , width_ { width == one_row ? texels_.size() : width }
-{ }
+                               std::size_t width,
+                               ColourSpace colour_space,
+                               Mipmaps mipmaps,
+                               Addressing addressing)
+    : storage_ {}
+    , texels_ {}
+    , bytes_ {}
+    , levels_ {}
+    , colour_space_ { colour_space }
+    , addressing_ { addressing }
+{
+    build({ texels.begin(), texels.end() }, width, mipmaps);
+}
+
+rgbctl_texture::rgbctl_texture(std::shared_ptr<TextureFile const> file,
+                               ColourSpace colour_space,
+                               Mipmaps mipmaps,
+                               Addressing addressing)
+    : storage_ {}
+    , texels_ {}
+    , bytes_ {}
+    , levels_ {}
+    , colour_space_ { colour_space }
+    , addressing_ { addressing }
+{
+    if (!file)
+        throw std::invalid_argument { "texture: no file" };
+
+    if (colour_space_ == ColourSpace::Srgb && mipmaps == Mipmaps::None) {
+        texels_ = file->texels();
+        bytes_ = file->bytes();
+        levels_.push_back({ 0,
+                            file->width(),
+                            file->height(),
+                            std::has_single_bit(file->width())
+                                && std::has_single_bit(file->height()) });
+        storage_ = std::move(file);
+        return;
+    }
+
+    std::vector<RgbFloat> texels { file->texels().begin(),
+                                   file->texels().end() };
+    std::transform(file->bytes().begin(),
+                   file->bytes().end(),
+                   std::back_inserter(texels),
+                   [](auto const& texel) { return to_texel(texel); });
+
+    build(std::move(texels), file->width(), mipmaps);
+}
+
+auto rgbctl_texture::build(std::vector<RgbFloat> texels,
+                           std::size_t width,
+                           Mipmaps mipmaps) -> void
+{
+    if (width == one_row)
+        width = texels.size();
+
+    if (!width || texels.size() % width)
+        throw std::invalid_argument { "texture: bad dimensions" };
+
+    from_srgb(colour_space_, texels);
+
+    levels_.push_back({ 0,
+                        width,
+                        texels.size() / width,
+                        std::has_single_bit(width)
+                            && std::has_single_bit(texels.size() / width) });
+
+    /* Levels are built from the one before, in the texture's colour
+     * space, so linear textures average light...
+     */
+    while (mipmaps != Mipmaps::None
+           && (levels_.back().width > 1 || levels_.back().height > 1)) {
+        auto const last = levels_.back();
+        auto const next
+            = downsample(texels.data() + last.offset,
+                         last.width,
+                         last.height,
+                         mipmaps,
+                         addressing_);
+
+        auto const width = std::max(last.width / 2, std::size_t { 1 });
+        auto const height = std::max(last.height / 2, std::size_t { 1 });
+        levels_.push_back({ texels.size(),
+                            width,
+                            height,
+                            std::has_single_bit(width)
+                                && std::has_single_bit(height) });
+        texels.insert(texels.end(), next.begin(), next.end());
+    }
+
+    auto owned
+        = std::make_shared<std::vector<RgbFloat> const>(std::move(texels));
+    texels_ = *owned;
+    storage_ = std::move(owned);
+}
 
 auto rgbctl_texture::width() const noexcept -> std::size_t
 {
-    return width_;
+    return levels_.front().width;
 }
 
 auto rgbctl_texture::height() const noexcept -> std::size_t
 {
-    return texels_.size() / width_;
+    return levels_.front().height;
+}
+
+auto rgbctl_texture::levels() const noexcept -> std::size_t
+{
+    return levels_.size();
+}
+
+auto rgbctl_texture::width(std::size_t n) const noexcept -> std::size_t
+{
+    return level(n).width;
+}
+
+auto rgbctl_texture::level_for(std::size_t sample_count) const noexcept
+    -> std::size_t
+{
+    std::size_t n = 0;
+    while (n + 1 < levels_.size() && levels_[n + 1].width >= sample_count)
+        ++n;
+
+    return n;
+}
+
+auto rgbctl_texture::level(std::size_t n) const noexcept -> Level const&
+{
+    return levels_[std::min(n, levels_.size() - 1)];
+}
+
+auto rgbctl_texture::colour_space() const noexcept -> ColourSpace
+{
+    return colour_space_;
+}
+
+auto rgbctl_texture::addressing() const noexcept -> Addressing
+{
+    return addressing_;
 }
 
 auto rgbctl_texture::sample(Vec<float, 2> const& coord,
-                            Filtering required_filtering) const noexcept
-    -> RgbFloat
+                            Filtering required_filtering,
+                            std::size_t n) const noexcept -> RgbFloat
 {
     switch (required_filtering) {
     case Filtering::Nearest:
-        return sample(coord, texture_filtering_nearest);
+        return sample(coord, texture_filtering_nearest, n);
     case Filtering::Linear:
     default:
-        return sample(coord, texture_filtering_linear);
+        return sample(coord, texture_filtering_linear, n);
     }
 }
 
@@ -50,98 +334,161 @@ constexpr auto wrap_around(Vec<float, 2> const& coord) noexcept -> Vec<float, 2>
     return tmp;
 }
 
-constexpr auto constrain_wrap(Vec<float, 2> const& coord) noexcept
-    -> Vec<float, 2>
+namespace
 {
-    return {
-        coord[0] > 0.f ? std::fmod(coord[0], 1.f)
-                       : 1.f - std::fmod(std::abs(coord[0]), 1.f),
-        coord[1] > 0.f ? std::fmod(coord[1], 1.f)
-                       : 1.f - std::fmod(std::abs(coord[1]), 1.f),
-    };
-}
 
-constexpr auto constrain_clamp(Vec<float, 2> const& coord) noexcept
-    -> Vec<float, 2>
+/* Where a sample falls along one axis of a level: the texel it's in,
+ * the one after, and how far it is from the first to the second...
+ */
+struct Neighbours
 {
-    return {
-        std::clamp(coord[0], 0.f, 1.f),
-        std::clamp(coord[1], 0.f, 1.f),
-    };
-}
-
-auto rgbctl_texture::sample(Vec<float, 2> const& pos,
-                            NearestFiltering) const noexcept -> RgbFloat
+    std::size_t first;
+    std::size_t second;
+    float weight;
+};
+
+/* Only the fraction of a wrapped coordinate matters, and `x - floor(x)`
+ * takes it with no branching. Once it's scaled to the axis the texel
+ * index can only overrun by rounding up to `size`, so a power of two
+ * masks it and anything else takes a select...
+ */
+template <Addressing Mode, bool PowerOfTwo>
+auto neighbours(float coord, std::size_t size) noexcept -> Neighbours
 {
-    //
-    using std::begin;
-    using std::distance;
-    using std::end;
-    using std::min;
-    using std::next;
-    using std::size;
-
-    using distance_type = decltype(distance(begin(texels_), end(texels_)));
-
-    auto const coord = constrain_wrap(pos);
+    auto const last = size - 1;
 
-    distance_type u
-        = static_cast<distance_type>(coord[0] * static_cast<float>(width()))
-          % static_cast<distance_type>(width());
-    distance_type v
-        = static_cast<distance_type>(coord[1] * static_cast<float>(height()))
-          % static_cast<distance_type>(height());
+    if constexpr (Mode == Addressing::Wrap) {
+        auto const t = (coord - std::floor(coord)) * static_cast<float>(size);
+        auto const i = static_cast<std::size_t>(t);
+        auto const weight = t - static_cast<float>(i);
 
-    auto texel_pos = v * static_cast<distance_type>(width()) + u;
+        if constexpr (PowerOfTwo)
+            return { i & last, (i + 1) & last, weight };
 
-    return *next(begin(texels_), texel_pos);
+        auto const first = i < size ? i : 0;
+        return { first, first < last ? first + 1 : 0, weight };
+    }
+    else {
+        /* Mirroring reflects the coordinate into 0 to 1 first, and
+         * then both clamp...
+         */
+        if constexpr (Mode == Addressing::Mirror) {
+            auto const period = coord - 2.f * std::floor(coord * .5f);
+            coord = 1.f - std::abs(1.f - period);
+        }
+
+        auto const t = std::clamp(coord, 0.f, 1.f) * static_cast<float>(size);
+        auto const i = std::min(static_cast<std::size_t>(t), last);
+
+        return { i, std::min(i + 1, last), t - static_cast<float>(i) };
+    }
 }
 
-auto rgbctl_texture::sample(Vec<float, 2> const& pos,
-                            LinearFiltering) const noexcept -> RgbFloat
+/* Picks the addressing once per sample, rather than per axis or
+ * texel...
+ */
+template <typename Sample>
+auto dispatch(Addressing addressing, bool power_of_two, Sample&& sample)
+    -> RgbFloat
 {
-    //
-    using std::begin;
-    using std::distance;
-    using std::end;
-    using std::min;
-    using std::next;
-    using std::size;
-
-    using distance_type = decltype(distance(begin(texels_), end(texels_)));
-
-    auto const coord = constrain_wrap(pos);
-
-    float u = coord[0] * static_cast<float>(width());
-    float v = coord[1] * static_cast<float>(height());
-    float u_dist = u - std::floor(u);
-    float v_dist = v - std::floor(v);
+    using Wrap = std::integral_constant<Addressing, Addressing::Wrap>;
+    using Clamp = std::integral_constant<Addressing, Addressing::Clamp>;
+    using Mirror = std::integral_constant<Addressing, Addressing::Mirror>;
+
+    switch (addressing) {
+    case Addressing::Clamp:
+        return sample(Clamp {}, std::false_type {});
+    case Addressing::Mirror:
+        return sample(Mirror {}, std::false_type {});
+    case Addressing::Wrap:
+    default:
+        return power_of_two ? sample(Wrap {}, std::true_type {})
+                            : sample(Wrap {}, std::false_type {});
+    }
+}
 
-    distance_type const u_index
-        = static_cast<distance_type>(u) % static_cast<distance_type>(width());
+/* Samples a `width` by `height` level starting at `first`, whether its
+ * texels are floats or bytes...
+ */
+template <Addressing Mode, bool PowerOfTwo, typename Texel>
+auto sample_nearest(std::integral_constant<Addressing, Mode>,
+                    std::bool_constant<PowerOfTwo>,
+                    Texel const* first,
+                    std::size_t width,
+                    std::size_t height,
+                    Vec<float, 2> const& pos) noexcept -> RgbFloat
+{
+    auto const u = neighbours<Mode, PowerOfTwo>(pos[0], width).first;
+    auto const v = neighbours<Mode, PowerOfTwo>(pos[1], height).first;
 
-    distance_type const v_index
-        = static_cast<distance_type>(v) % static_cast<distance_type>(height());
+    return to_texel(first[v * width + u]);
+}
 
-    auto c0_pos = v_index * static_cast<distance_type>(width()) + u_index;
+template <Addressing Mode, bool PowerOfTwo, typename Texel>
+auto sample_linear(std::integral_constant<Addressing, Mode>,
+                   std::bool_constant<PowerOfTwo>,
+                   Texel const* first,
+                   std::size_t width,
+                   std::size_t height,
+                   Vec<float, 2> const& pos) noexcept -> RgbFloat
+{
+    auto const u = neighbours<Mode, PowerOfTwo>(pos[0], width);
+    auto const v = neighbours<Mode, PowerOfTwo>(pos[1], height);
 
-    auto c1_pos = v_index * static_cast<distance_type>(width())
-                  + ((u_index + 1) % static_cast<distance_type>(width()));
+    auto c0 = to_texel(first[v.first * width + u.first]);
+    auto c1 = to_texel(first[v.first * width + u.second]);
+    auto c2 = to_texel(first[v.second * width + u.first]);
+    auto c3 = to_texel(first[v.second * width + u.second]);
 
-    auto c2_pos = (((v_index + 1) % static_cast<distance_type>(height()))
-                   * static_cast<distance_type>(width()))
-                  + u_index;
+    return lerp(lerp(c0, c1, u.weight), lerp(c2, c3, u.weight), v.weight);
+}
 
-    auto c3_pos = (((v_index + 1) % static_cast<distance_type>(height()))
-                   * static_cast<distance_type>(width()))
-                  + ((u_index + 1) % static_cast<distance_type>(width()));
+} // namespace
 
-    auto c0 = *next(begin(texels_), c0_pos);
-    auto c1 = *next(begin(texels_), c1_pos);
-    auto c2 = *next(begin(texels_), c2_pos);
-    auto c3 = *next(begin(texels_), c3_pos);
+auto rgbctl_texture::sample(Vec<float, 2> const& pos,
+                            NearestFiltering,
+                            std::size_t n) const noexcept -> RgbFloat
+{
+    auto const& mip = level(n);
+    return dispatch(addressing_, mip.power_of_two, [&](auto mode, auto pow2) {
+        if (!bytes_.empty())
+            return sample_nearest(mode,
+                                  pow2,
+                                  bytes_.data() + mip.offset,
+                                  mip.width,
+                                  mip.height,
+                                  pos);
+
+        return sample_nearest(mode,
+                              pow2,
+                              texels_.data() + mip.offset,
+                              mip.width,
+                              mip.height,
+                              pos);
+    });
+}
 
-    return lerp(lerp(c0, c1, u_dist), lerp(c2, c3, u_dist), v_dist);
+auto rgbctl_texture::sample(Vec<float, 2> const& pos,
+                            LinearFiltering,
+                            std::size_t n) const noexcept -> RgbFloat
+{
+    auto const& mip = level(n);
+    return dispatch(addressing_, mip.power_of_two, [&](auto mode, auto pow2) {
+        if (!bytes_.empty())
+            return sample_linear(mode,
+                                 pow2,
+                                 bytes_.data() + mip.offset,
+                                 mip.width,
+                                 mip.height,
+                                 pos);
+
+        return sample_linear(mode,
+                             pow2,
+                             texels_.data() + mip.offset,
+                             mip.width,
+                             mip.height,
+                             pos);
+    });
 }
 
 auto to_rgb_float_value(Vec<float, 3> const& vec) noexcept
@@ -157,12 +504,51 @@ rgbctl_rgb_float_value rgb_sample_texture(rgbctl_texture const* texture,
                                           float y,
                                           int filtering)
 {
+    auto const space = texture->colour_space();
+    switch (filtering) {
+    case RGBCTL_SAMPLE_NEAREST:
+        return to_rgb_float_value(to_srgb(
+            space,
+            texture->sample(to_vec<float>(x, y), texture_filtering_nearest)));
+    default:
+        return to_rgb_float_value(to_srgb(
+            space,
+            texture->sample(to_vec<float>(x, y), texture_filtering_linear)));
+    }
+}
+
+void rgb_sample_texture_n(rgbctl_texture const* texture,
+                          float const* x,
+                          float const* y,
+                          std::uint32_t n,
+                          int filtering,
+                          rgbctl_rgb_float_value* out)
+{
+    /* Hoist the filtering decision out of the loop, rather than going
+     * through `rgb_sample_texture` for every texel, and convert back
+     * to sRGB a block of samples at a time...
+     */
+    std::uint32_t constexpr kBlockSize = 64;
+    std::array<RgbFloat, kBlockSize> block;
+    auto const sample_all = [&](auto filter) {
+        for (std::uint32_t first = 0; first < n; first += kBlockSize) {
+            auto const size = std::min(kBlockSize, n - first);
+            for (std::uint32_t i = 0; i < size; ++i)
+                block[i] = texture->sample(
+                    to_vec<float>(x[first + i], y[first + i]), filter);
+
+            to_srgb(texture->colour_space(), std::span { block.data(), size });
+            for (std::uint32_t i = 0; i < size; ++i)
+                out[first + i] = to_rgb_float_value(block[i]);
+        }
+    };
+
     switch (filtering) {
     case RGBCTL_SAMPLE_NEAREST:
-        return to_rgb_float_value(
-            texture->sample(to_vec<float>(x, y), texture_filtering_nearest));
+        sample_all(texture_filtering_nearest);
+        break;
     default:
-        return to_rgb_float_value(
-            texture->sample(to_vec<float>(x, y), texture_filtering_linear));
+        sample_all(texture_filtering_linear);
+        break;
     }
 }
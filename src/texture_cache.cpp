@@ -0,0 +1,148 @@
+#include "rgbctl/texture_cache.hpp"
+#include "rgbctl/hash.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+using namespace rgbctl;
+
+namespace
+{
+
+auto file_texels(TextureFile const& file) noexcept
+    -> std::span<std::byte const>
+{
+    return file.format() == TexelFormat::Float ? std::as_bytes(file.texels())
+                                               : std::as_bytes(file.bytes());
+}
+
+/* A texture converted from a file doesn't need it once it's built, but
+ * the cache compares against the file on a hit, so the texture it hands
+ * out keeps the file alive, and only that long...
+ */
+struct FileTexture
+{
+    FileTexture(std::shared_ptr<TextureFile const> const& source,
+                ColourSpace colour_space,
+                Mipmaps mipmaps,
+                Addressing addressing)
+        : file { source }
+        , texture { source, colour_space, mipmaps, addressing }
+    { }
+
+    std::shared_ptr<TextureFile const> file;
+    Texture texture;
+};
+
+} // namespace
+
+namespace rgbctl
+{
+
+auto TextureCache::get(std::span<RgbFloat const> texels,
+                       std::size_t width,
+                       ColourSpace colour_space,
+                       Mipmaps mipmaps,
+                       Addressing addressing)
+    -> std::shared_ptr<Texture const>
+{
+    if (width == Texture::one_row)
+        width = texels.size();
+
+    return intern({ static_cast<std::uint64_t>(TexelFormat::Float),
+                    width,
+                    static_cast<std::uint64_t>(colour_space),
+                    static_cast<std::uint64_t>(mipmaps),
+                    static_cast<std::uint64_t>(addressing) },
+                  std::as_bytes(texels),
+                  nullptr,
+                  [&] {
+                      return std::make_shared<Texture const>(
+                          texels, width, colour_space, mipmaps, addressing);
+                  });
+}
+
+auto TextureCache::get(std::shared_ptr<TextureFile const> file,
+                       ColourSpace colour_space,
+                       Mipmaps mipmaps,
+                       Addressing addressing)
+    -> std::shared_ptr<Texture const>
+{
+    if (!file)
+        throw std::invalid_argument { "texture cache: no file" };
+
+    auto const texels = file_texels(*file);
+
+    return intern({ static_cast<std::uint64_t>(file->format()),
+                    file->width(),
+                    static_cast<std::uint64_t>(colour_space),
+                    static_cast<std::uint64_t>(mipmaps),
+                    static_cast<std::uint64_t>(addressing) },
+                  texels,
+                  file,
+                  [&] {
+                      auto const owner = std::make_shared<FileTexture const>(
+                          file, colour_space, mipmaps, addressing);
+                      return std::shared_ptr<Texture const> {
+                          owner, &owner->texture
+                      };
+                  });
+}
+
+auto TextureCache::size() const -> std::size_t
+{
+    std::lock_guard lock { mutex_ };
+    return static_cast<std::size_t>(
+        std::count_if(entries_.begin(), entries_.end(), [](auto const& entry) {
+            return !entry.second.texture.expired();
+        }));
+}
+
+/* Textures are built under the lock, so two zones asking for the same
+ * texture at once don't both build it. Entries only hold weak
+ * references, so a file is unmapped as soon as the last texture built
+ * from it is freed. Entries that have expired are dropped on the next
+ * call...
+ */
+template <typename Create>
+auto TextureCache::intern(Parameters const& parameters,
+                          std::span<std::byte const> texels,
+                          std::shared_ptr<TextureFile const> file,
+                          Create&& create) -> std::shared_ptr<Texture const>
+{
+    auto const key
+        = fnv1a(std::as_bytes(std::span { parameters }), fnv1a(texels));
+
+    std::lock_guard lock { mutex_ };
+    std::erase_if(entries_, [](auto const& entry) {
+        return entry.second.texture.expired();
+    });
+
+    if (auto const entry = entries_.find(key); entry != entries_.end()) {
+        auto texture = entry->second.texture.lock();
+        auto const source = entry->second.file.lock();
+        auto const source_texels = source ? file_texels(*source)
+                                          : std::span<std::byte const> {
+                                                entry->second.texels
+                                            };
+        if (texture && entry->second.parameters == parameters
+            && std::ranges::equal(source_texels, texels))
+            return texture;
+
+        /* A different texture with the same hash. It's built, but not
+         * shared...
+         */
+        return create();
+    }
+
+    auto texture = create();
+    Entry entry { texture, parameters, {}, file };
+    if (!file)
+        entry.texels.assign(texels.begin(), texels.end());
+
+    entries_.emplace(key, std::move(entry));
+
+    return texture;
+}
+
+} // namespace rgbctl
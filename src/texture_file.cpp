@@ -0,0 +1,229 @@
+#include "rgbctl/texture_file.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+using namespace rgbctl;
+
+namespace
+{
+
+static_assert(sizeof(RgbFloat) == 3 * sizeof(float),
+              "float texels must be mapped in place");
+static_assert(sizeof(RgbUint8) == 3, "byte texels must be mapped in place");
+
+auto texel_size(TexelFormat format) noexcept -> std::size_t
+{
+    return format == TexelFormat::Float ? sizeof(RgbFloat) : sizeof(RgbUint8);
+}
+
+auto get_u32(unsigned char const* data) noexcept -> std::uint32_t
+{
+    return std::uint32_t { data[0] } | std::uint32_t { data[1] } << 8
+           | std::uint32_t { data[2] } << 16 | std::uint32_t { data[3] } << 24;
+}
+
+auto put_u32(std::vector<unsigned char>& out, std::size_t value) -> void
+{
+    for (unsigned shift = 0; shift < 32; shift += 8)
+        out.push_back(static_cast<unsigned char>(value >> shift));
+}
+
+auto to_byte(float value) noexcept -> std::uint8_t
+{
+    return static_cast<std::uint8_t>(
+        std::lround(std::clamp(value, 0.f, 1.f) * 255.f));
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+auto TextureFileHeader::frame_size() const noexcept -> std::size_t
+{
+    return width * height * texel_size(format);
+}
+
+auto parse_texture_file_header(std::span<unsigned char const> header)
+    -> TextureFileHeader
+{
+    if (header.size() < kTextureFileHeaderSize)
+        throw std::runtime_error { "texture file: truncated" };
+
+    if (!std::equal(std::begin(kTextureFileMagic),
+                    std::end(kTextureFileMagic),
+                    header.begin()))
+        throw std::runtime_error { "texture file: bad magic number" };
+
+    auto const* fields = header.data() + std::size(kTextureFileMagic);
+    TextureFileHeader result { get_u32(fields),
+                               get_u32(fields + 4),
+                               static_cast<TexelFormat>(fields[8]),
+                               std::max(get_u32(fields + 12),
+                                        std::uint32_t { 1 }) };
+
+    if (result.format != TexelFormat::Float
+        && result.format != TexelFormat::Uint8)
+        throw std::runtime_error { "texture file: bad format" };
+
+    if (!result.width || !result.height)
+        throw std::runtime_error { "texture file: empty" };
+
+    if (result.width > SIZE_MAX / result.height / sizeof(RgbFloat)
+        || result.frames > (SIZE_MAX - kTextureFileHeaderSize)
+                               / result.frame_size())
+        throw std::runtime_error { "texture file: too large" };
+
+    if (result.format == TexelFormat::Float
+        && std::endian::native != std::endian::little)
+        throw std::runtime_error { "texture file: big endian host" };
+
+    return result;
+}
+
+TextureFile::TextureFile(std::filesystem::path const& path)
+    : mapping_ { MAP_FAILED }
+    , mapped_size_ { 0 }
+    , header_ {}
+{
+    auto const fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::system_error { errno, std::system_category() };
+
+    struct stat status;
+    if (fstat(fd, &status) < 0) {
+        auto const error = errno;
+        close(fd);
+        throw std::system_error { error, std::system_category() };
+    }
+
+    mapped_size_ = static_cast<std::size_t>(status.st_size);
+    if (mapped_size_ < kTextureFileHeaderSize) {
+        close(fd);
+        throw std::runtime_error { "texture file: truncated" };
+    }
+
+    /* The mapping outlives the descriptor...
+     */
+    mapping_ = mmap(nullptr, mapped_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    auto const error = errno;
+    close(fd);
+    if (mapping_ == MAP_FAILED)
+        throw std::system_error { error, std::system_category() };
+
+    try {
+        header_ = parse_texture_file_header(
+            { static_cast<unsigned char const*>(mapping_), mapped_size_ });
+
+        auto const frame_size = header_.frame_size();
+        if ((mapped_size_ - kTextureFileHeaderSize) % frame_size
+            || (mapped_size_ - kTextureFileHeaderSize) / frame_size
+                   != header_.frames)
+            throw std::runtime_error { "texture file: bad length" };
+    }
+    catch (...) {
+        munmap(mapping_, mapped_size_);
+        throw;
+    }
+}
+
+TextureFile::~TextureFile()
+{
+    munmap(mapping_, mapped_size_);
+}
+
+auto TextureFile::width() const noexcept -> std::size_t
+{
+    return header_.width;
+}
+
+auto TextureFile::height() const noexcept -> std::size_t
+{
+    return header_.height;
+}
+
+auto TextureFile::format() const noexcept -> TexelFormat
+{
+    return header_.format;
+}
+
+auto TextureFile::frames() const noexcept -> std::size_t
+{
+    return header_.frames;
+}
+
+auto TextureFile::texels() const noexcept -> std::span<RgbFloat const>
+{
+    if (header_.format != TexelFormat::Float)
+        return {};
+
+    return { reinterpret_cast<RgbFloat const*>(
+                 static_cast<unsigned char const*>(mapping_)
+                 + kTextureFileHeaderSize),
+             header_.width * header_.height };
+}
+
+auto TextureFile::bytes() const noexcept -> std::span<RgbUint8 const>
+{
+    if (header_.format != TexelFormat::Uint8)
+        return {};
+
+    return { reinterpret_cast<RgbUint8 const*>(
+                 static_cast<unsigned char const*>(mapping_)
+                 + kTextureFileHeaderSize),
+             header_.width * header_.height };
+}
+
+auto write_texture_file(std::filesystem::path const& path,
+                        std::span<RgbFloat const> texels,
+                        std::size_t width,
+                        TexelFormat format,
+                        std::size_t frames) -> void
+{
+    if (!width || !frames || texels.empty()
+        || texels.size() % (width * frames) || width > UINT32_MAX
+        || texels.size() / width / frames > UINT32_MAX || frames > UINT32_MAX)
+        throw std::invalid_argument { "texture file: bad dimensions" };
+
+    std::vector<unsigned char> contents { std::begin(kTextureFileMagic),
+                                          std::end(kTextureFileMagic) };
+    put_u32(contents, width);
+    put_u32(contents, texels.size() / width / frames);
+    contents.push_back(static_cast<unsigned char>(format));
+    contents.resize(contents.size() + 3);
+    put_u32(contents, frames);
+
+    contents.reserve(kTextureFileHeaderSize
+                     + texels.size() * texel_size(format));
+    for (auto const& texel : texels) {
+        for (auto channel : texel) {
+            if (format == TexelFormat::Uint8) {
+                contents.push_back(to_byte(channel));
+                continue;
+            }
+
+            auto const bits = std::bit_cast<std::uint32_t>(channel);
+            put_u32(contents, bits);
+        }
+    }
+
+    std::ofstream file { path, std::ios::binary | std::ios::trunc };
+    file.write(reinterpret_cast<char const*>(contents.data()),
+               static_cast<std::streamsize>(contents.size()));
+    if (!file)
+        throw std::runtime_error { "texture file: couldn't write" };
+}
+
+} // namespace rgbctl
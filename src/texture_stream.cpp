@@ -0,0 +1,245 @@
+#include "rgbctl/texture_stream.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+using namespace rgbctl;
+
+namespace
+{
+
+auto read_all(int fd, void* data, std::size_t len, off_t offset) -> void
+{
+    auto* pos = static_cast<unsigned char*>(data);
+    while (len) {
+        auto const n = pread(fd, pos, len, offset);
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n < 0)
+            throw std::system_error { errno, std::system_category() };
+
+        if (n == 0)
+            throw std::runtime_error { "texture file: truncated" };
+
+        pos += n;
+        offset += n;
+        len -= static_cast<std::size_t>(n);
+    }
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+TextureStream::TextureStream(std::filesystem::path const& path,
+                             ColourSpace colour_space,
+                             Mipmaps mipmaps,
+                             std::size_t read_ahead)
+    : file_no_ { open(path.c_str(), O_RDONLY | O_CLOEXEC) }
+    , header_ {}
+    , colour_space_ { colour_space }
+    , mipmaps_ { mipmaps }
+    , ring_(read_ahead)
+    , first_ { 0 }
+    , count_ { 0 }
+    , current_ {}
+    , next_ { 0 }
+    , generation_ { 0 }
+    , late_ { 0 }
+    , error_ {}
+    , stop_ { false }
+{
+    if (file_no_ < 0)
+        throw std::system_error { errno, std::system_category() };
+
+    try {
+        if (!read_ahead)
+            throw std::invalid_argument { "texture stream: no read ahead" };
+
+        std::array<unsigned char, kTextureFileHeaderSize> header;
+        read_all(file_no_, header.data(), header.size(), 0);
+        header_ = parse_texture_file_header(header);
+
+        struct stat status;
+        if (fstat(file_no_, &status) < 0)
+            throw std::system_error { errno, std::system_category() };
+
+        if (static_cast<std::size_t>(status.st_size)
+            != kTextureFileHeaderSize + header_.frames * header_.frame_size())
+            throw std::runtime_error { "texture file: bad length" };
+    }
+    catch (...) {
+        close(file_no_);
+        throw;
+    }
+
+    /* Frames are read in order, so let the kernel read ahead of the
+     * reader too...
+     */
+    posix_fadvise(file_no_, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    thread_ = std::thread { [this] { run(); } };
+}
+
+TextureStream::~TextureStream()
+{
+    {
+        std::lock_guard lock { mutex_ };
+        stop_ = true;
+    }
+
+    changed_.notify_all();
+    thread_.join();
+    close(file_no_);
+}
+
+auto TextureStream::width() const noexcept -> std::size_t
+{
+    return header_.width;
+}
+
+auto TextureStream::height() const noexcept -> std::size_t
+{
+    return header_.height;
+}
+
+auto TextureStream::frames() const noexcept -> std::size_t
+{
+    return header_.frames;
+}
+
+auto TextureStream::frame(std::size_t frame) -> std::shared_ptr<Texture const>
+{
+    std::unique_lock lock { mutex_ };
+
+    /* Going back means starting again, discarding whatever's been read
+     * ahead, and whatever the reader is decoding now...
+     */
+    if (current_.texture && frame < current_.frame) {
+        count_ = 0;
+        next_ = frame;
+        current_ = {};
+        ++generation_;
+        changed_.notify_all();
+    }
+
+    consume(frame);
+
+    /* A reader that's fallen behind skips to the frame being shown,
+     * rather than decoding frames that would never be...
+     */
+    if (!count_ && next_ < frame) {
+        next_ = frame;
+        changed_.notify_all();
+    }
+
+    changed_.wait(lock, [&] {
+        consume(frame);
+        return current_.texture || error_;
+    });
+
+    if (error_)
+        std::rethrow_exception(error_);
+
+    if (current_.frame != frame)
+        ++late_;
+
+    return current_.texture;
+}
+
+auto TextureStream::late() const -> std::size_t
+{
+    std::lock_guard lock { mutex_ };
+    return late_;
+}
+
+auto TextureStream::buffered() const -> std::size_t
+{
+    std::lock_guard lock { mutex_ };
+    return count_;
+}
+
+/* Takes every decoded frame up to `frame` off the ring, keeping the
+ * latest. Must be called with the lock held...
+ */
+auto TextureStream::consume(std::size_t frame) -> void
+{
+    while (count_ && ring_[first_].frame <= frame) {
+        current_ = std::move(ring_[first_]);
+        first_ = (first_ + 1) % ring_.size();
+        --count_;
+        changed_.notify_all();
+    }
+}
+
+auto TextureStream::run() -> void
+{
+    std::unique_lock lock { mutex_ };
+    while (true) {
+        changed_.wait(lock, [&] {
+            return stop_ || (count_ < ring_.size() && !error_);
+        });
+
+        if (stop_)
+            return;
+
+        auto const frame = next_++;
+        auto const generation = generation_;
+        lock.unlock();
+
+        std::shared_ptr<Texture const> texture;
+        std::exception_ptr error;
+        try {
+            texture = decode(frame % header_.frames);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        if (generation != generation_)
+            continue;
+
+        if (error)
+            error_ = error;
+        else
+            ring_[(first_ + count_++) % ring_.size()] = { frame,
+                                                          std::move(texture) };
+
+        changed_.notify_all();
+    }
+}
+
+auto TextureStream::decode(std::size_t frame) -> std::shared_ptr<Texture const>
+{
+    auto const count = header_.width * header_.height;
+    auto const offset = static_cast<off_t>(kTextureFileHeaderSize
+                                           + frame * header_.frame_size());
+
+    std::vector<RgbFloat> texels(count);
+    if (header_.format == TexelFormat::Float) {
+        read_all(file_no_, texels.data(), header_.frame_size(), offset);
+    }
+    else {
+        std::vector<RgbUint8> bytes(count);
+        read_all(file_no_, bytes.data(), header_.frame_size(), offset);
+        std::transform(
+            bytes.begin(), bytes.end(), texels.begin(), [](auto const& b) {
+                return RgbFloat { static_cast<float>(b[0]) / 255.f,
+                                  static_cast<float>(b[1]) / 255.f,
+                                  static_cast<float>(b[2]) / 255.f };
+            });
+    }
+
+    return std::make_shared<Texture const>(
+        texels, header_.width, colour_space_, mipmaps_);
+}
+
+} // namespace rgbctl
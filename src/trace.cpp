@@ -0,0 +1,170 @@
+#include "rgbctl/trace.hpp"
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+struct Event
+{
+    char const* name;
+    std::uint64_t start_ns;
+    std::uint64_t end_ns;
+};
+
+/* Only ever written by the thread that owns it. Once full, the oldest
+ * events are overwritten...
+ */
+struct Buffer
+{
+    Buffer(std::size_t capacity, std::uint32_t thread_id)
+        : events(capacity)
+        , head { 0 }
+        , thread_id { thread_id }
+    { }
+
+    std::vector<Event> events;
+    std::atomic<std::uint64_t> head;
+    std::uint32_t thread_id;
+};
+
+struct Buffers
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Buffer>> all;
+};
+
+std::atomic_bool tracing_enabled = false;
+std::atomic_size_t events_per_thread = 0;
+
+/* Never destroyed, for the same reason as the metrics' shards...
+ */
+auto buffers() -> Buffers&
+{
+    static auto* buffers = new Buffers;
+    return *buffers;
+}
+
+/* Null if the thread's buffer couldn't be allocated, in which case its
+ * events are dropped until allocating it succeeds...
+ */
+auto local_buffer() noexcept -> Buffer*
+{
+    thread_local Buffer* buffer = nullptr;
+    if (buffer)
+        return buffer;
+
+    try {
+        auto& b = buffers();
+        std::lock_guard lock { b.mutex };
+        auto owned = std::make_unique<Buffer>(
+            events_per_thread.load(),
+            static_cast<std::uint32_t>(b.all.size() + 1));
+        buffer = b.all.emplace_back(std::move(owned)).get();
+    }
+    catch (std::exception const&) {
+    }
+
+    return buffer;
+}
+
+auto microseconds(std::uint64_t ns) -> double
+{
+    return static_cast<double>(ns) / 1000.0;
+}
+
+} // namespace
+
+namespace rgbctl::trace
+{
+
+auto enable(std::size_t events) -> void
+{
+    if (!events)
+        return;
+
+    events_per_thread = events;
+    tracing_enabled = true;
+}
+
+auto enabled() noexcept -> bool
+{
+    return tracing_enabled.load(std::memory_order_relaxed);
+}
+
+auto now() noexcept -> std::uint64_t
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+auto record(char const* name,
+            std::uint64_t start_ns,
+            std::uint64_t end_ns) noexcept -> void
+{
+    if (!enabled())
+        return;
+
+    auto* buffer = local_buffer();
+    if (!buffer)
+        return;
+
+    auto const head = buffer->head.load(std::memory_order_relaxed);
+    buffer->events[head % buffer->events.size()] = { name, start_ns, end_ns };
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+auto write_json(std::ostream& os) -> void
+{
+    auto const flags = os.flags();
+    auto const precision = os.precision();
+    auto const pid = getpid();
+
+    os << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+
+    auto first = true;
+    auto& b = buffers();
+    std::lock_guard lock { b.mutex };
+    for (auto const& buffer : b.all) {
+        auto const head = buffer->head.load(std::memory_order_acquire);
+        auto const capacity = buffer->events.size();
+        auto const begin = head > capacity ? head - capacity : 0;
+
+        for (auto n = begin; n < head; ++n) {
+            auto const& event = buffer->events[n % capacity];
+            os << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name
+               << "\",\"ph\":\"X\",\"ts\":" << microseconds(event.start_ns)
+               << ",\"dur\":" << microseconds(event.end_ns - event.start_ns)
+               << ",\"pid\":" << pid << ",\"tid\":" << buffer->thread_id
+               << '}';
+            first = false;
+        }
+    }
+
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+Scope::Scope(char const* name) noexcept
+    : name_ { enabled() ? name : nullptr }
+    , start_ns_ { name_ ? now() : 0 }
+{ }
+
+Scope::~Scope()
+{
+    if (name_)
+        record(name_, start_ns_, now());
+}
+
+} // namespace rgbctl::trace
@@ -0,0 +1,245 @@
+#include "rgbctl/traffic_log.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+namespace
+{
+
+std::size_t constexpr kFlushThreshold = 64 * 1024;
+unsigned char constexpr kFailed = 0x80;
+
+auto put_varint(std::vector<unsigned char>& out, std::uint64_t value) -> void
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+struct Reader
+{
+    std::vector<unsigned char> const& data;
+    std::size_t pos = 0;
+
+    auto done() const noexcept -> bool
+    {
+        return pos == data.size();
+    }
+
+    auto byte() -> unsigned char
+    {
+        if (done())
+            throw std::runtime_error { "traffic log: truncated" };
+
+        return data[pos++];
+    }
+
+    auto varint() -> std::uint64_t
+    {
+        std::uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            auto const b = byte();
+            value |= std::uint64_t { b & 0x7fu } << shift;
+            if (!(b & 0x80))
+                return value;
+        }
+
+        throw std::runtime_error { "traffic log: bad varint" };
+    }
+};
+
+auto read_file(std::filesystem::path const& path) -> std::vector<unsigned char>
+{
+    auto const fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::system_error { errno, std::system_category() };
+
+    std::vector<unsigned char> contents;
+    unsigned char buffer[4096];
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) != 0) {
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n < 0) {
+            auto const error = errno;
+            close(fd);
+            throw std::system_error { error, std::system_category() };
+        }
+
+        contents.insert(contents.end(), buffer, buffer + n);
+    }
+
+    close(fd);
+    return contents;
+}
+
+auto write_all(int fd, unsigned char const* data, std::size_t len) noexcept
+    -> bool
+{
+    while (len) {
+        auto const n = write(fd, data, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n < 0)
+            return false;
+
+        data += n;
+        len -= static_cast<std::size_t>(n);
+    }
+
+    return true;
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+TrafficRecorder::TrafficRecorder(std::filesystem::path const& path)
+    : file_no_ { open(path.c_str(),
+                      O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                      0644) }
+    , last_start_ns_ { trace::now() }
+    , dropped_ { 0 }
+    , buffered_ { 0 }
+    , buffer_ {}
+{
+    if (file_no_ < 0)
+        throw std::system_error { errno, std::system_category() };
+
+    buffer_.reserve(kFlushThreshold * 2);
+    buffer_.assign(std::begin(kTrafficLogMagic), std::end(kTrafficLogMagic));
+}
+
+TrafficRecorder::~TrafficRecorder()
+{
+    flush();
+    close(file_no_);
+}
+
+auto TrafficRecorder::record(TrafficDirection direction,
+                             std::uint64_t start_ns,
+                             std::uint64_t end_ns,
+                             std::uint32_t requested,
+                             rgbctl_errno result,
+                             unsigned char const* data) noexcept -> void
+{
+    auto const failed = result < 0;
+    auto const size = buffer_.size();
+
+    try {
+        buffer_.push_back(static_cast<unsigned char>(direction)
+                          | (failed ? kFailed : 0));
+        put_varint(buffer_, start_ns - std::min(start_ns, last_start_ns_));
+        put_varint(buffer_, end_ns - std::min(end_ns, start_ns));
+        put_varint(buffer_, requested);
+
+        if (failed) {
+            put_varint(buffer_, static_cast<std::uint64_t>(-result));
+        }
+        else {
+            put_varint(buffer_, static_cast<std::uint64_t>(result));
+            buffer_.insert(buffer_.end(), data, data + result);
+        }
+    }
+    catch (std::exception const&) {
+        buffer_.resize(size);
+        ++dropped_;
+        return;
+    }
+
+    last_start_ns_ = start_ns;
+    ++buffered_;
+    if (buffer_.size() >= kFlushThreshold)
+        flush();
+}
+
+auto TrafficRecorder::flush() noexcept -> void
+{
+    if (!write_all(file_no_, buffer_.data(), buffer_.size()))
+        dropped_ += buffered_;
+
+    buffer_.clear();
+    buffered_ = 0;
+}
+
+auto TrafficRecorder::dropped() const noexcept -> std::uint64_t
+{
+    return dropped_;
+}
+
+auto read_traffic_log(std::filesystem::path const& path)
+    -> std::vector<TrafficRecord>
+{
+    auto const contents = read_file(path);
+    if (contents.size() < std::size(kTrafficLogMagic)
+        || !std::equal(std::begin(kTrafficLogMagic),
+                       std::end(kTrafficLogMagic),
+                       contents.begin()))
+        throw std::runtime_error { "traffic log: bad magic number" };
+
+    Reader reader { contents, std::size(kTrafficLogMagic) };
+    std::vector<TrafficRecord> records;
+    std::uint64_t start_ns = 0;
+
+    while (!reader.done()) {
+        auto const kind = reader.byte();
+        auto const direction
+            = static_cast<TrafficDirection>(kind & ~kFailed);
+        if (direction != TrafficDirection::Read
+            && direction != TrafficDirection::Write)
+            throw std::runtime_error { "traffic log: bad record" };
+
+        start_ns += reader.varint();
+        auto const duration_ns = reader.varint();
+        auto const requested = reader.varint();
+        if (requested > UINT32_MAX)
+            throw std::runtime_error { "traffic log: bad length" };
+
+        auto& record = records.emplace_back(
+            TrafficRecord { direction,
+                            start_ns,
+                            duration_ns,
+                            static_cast<std::uint32_t>(requested),
+                            0,
+                            {} });
+
+        auto const value = reader.varint();
+        if (value > static_cast<std::uint64_t>(
+                std::numeric_limits<rgbctl_errno>::max()))
+            throw std::runtime_error { "traffic log: bad length" };
+
+        if (kind & kFailed) {
+            record.result = -static_cast<rgbctl_errno>(value);
+            continue;
+        }
+
+        /* A device can't transfer more than was asked for...
+         */
+        if (value > record.requested)
+            throw std::runtime_error { "traffic log: bad length" };
+
+        if (value > contents.size() - reader.pos)
+            throw std::runtime_error { "traffic log: truncated" };
+
+        record.result = static_cast<rgbctl_errno>(value);
+        auto const first
+            = contents.begin() + static_cast<std::ptrdiff_t>(reader.pos);
+        record.data.assign(first, first + record.result);
+        reader.pos += value;
+    }
+
+    return records;
+}
+
+} // namespace rgbctl
@@ -0,0 +1,216 @@
+#include "rgbctl/user_shader.hpp"
+#include "rgbctl/assert.hpp"
+#include <atomic>
+#include <dlfcn.h>
+#include <fstream>
+#include <libtcc.h>
+#include <sstream>
+#include <unistd.h>
+
+namespace
+{
+
+struct TCCStateDeleter
+{
+    auto operator()(TCCState* state) const noexcept -> void
+    {
+        tcc_delete(state);
+    }
+};
+
+using TCCStatePtr = std::unique_ptr<TCCState, TCCStateDeleter>;
+
+struct DlDeleter
+{
+    auto operator()(void* handle) const noexcept -> void
+    {
+        dlclose(handle);
+    }
+};
+
+auto append_error(void* opaque, char const* msg) -> void
+{
+    auto& errors = *reinterpret_cast<std::string*>(opaque);
+    if (!errors.empty())
+        errors += '\n';
+
+    errors += msg;
+}
+
+auto compile(std::string const& source, int output_type, std::string& errors)
+    -> TCCStatePtr
+{
+    using rgbctl::ShaderCompileError;
+
+    TCCStatePtr state { tcc_new() };
+    if (!state)
+        throw ShaderCompileError { "shader: tcc_new" };
+
+    tcc_set_error_func(state.get(), &errors, append_error);
+
+    if (tcc_set_output_type(state.get(), output_type) < 0)
+        throw ShaderCompileError { "shader: output type: " + errors };
+
+    tcc_add_include_path(state.get(), RGBCTL_SHADER_INCLUDE_DIR);
+
+    if (tcc_compile_string(state.get(), source.c_str()) < 0)
+        throw ShaderCompileError { "shader: compile: " + errors };
+
+    tcc_add_library(state.get(), "m");
+
+    return state;
+}
+
+} // namespace
+
+namespace rgbctl
+{
+
+ShaderCompileError::ShaderCompileError(std::string const& msg)
+    : std::runtime_error { msg }
+{ }
+
+UserShader::UserShader() noexcept
+    : entry_ { nullptr }
+{ }
+
+UserShader::UserShader(rgbctl_shader entry,
+                       std::shared_ptr<void const> code) noexcept
+    : entry_ { entry }
+    , code_ { std::move(code) }
+{ }
+
+auto UserShader::operator()(rgbctl_shader_input const& input,
+                            std::span<rgbctl_rgb_float_value> out) const
+    -> void
+{
+    RGBCTL_EXPECTS(entry_);
+    RGBCTL_EXPECTS(out.size() >= input.count);
+    entry_(&input, out.data());
+}
+
+UserShader::operator bool() const noexcept
+{
+    return entry_ != nullptr;
+}
+
+auto compile_user_shader(std::string const& source) -> UserShader
+{
+    std::string errors;
+    auto state = compile(source, TCC_OUTPUT_MEMORY, errors);
+
+    /* Shaders only see the texture API we hand them here, plus libm...
+     */
+    tcc_add_symbol(state.get(),
+                   "rgb_sample_texture",
+                   reinterpret_cast<void const*>(&rgb_sample_texture));
+    tcc_add_symbol(state.get(),
+                   "rgb_sample_texture_n",
+                   reinterpret_cast<void const*>(&rgb_sample_texture_n));
+
+    if (tcc_relocate(state.get(), TCC_RELOCATE_AUTO) < 0)
+        throw ShaderCompileError { "shader: relocate: " + errors };
+
+    auto entry = reinterpret_cast<rgbctl_shader>(
+        tcc_get_symbol(state.get(), RGBCTL_SHADER_ENTRY_POINT));
+    if (!entry)
+        throw ShaderCompileError { "shader: missing entry point "
+                                   RGBCTL_SHADER_ENTRY_POINT };
+
+    /* The relocated code lives inside the TCC state, so the state
+     * is what keeps the shader alive...
+     */
+    std::shared_ptr<void const> code { state.release(), TCCStateDeleter {} };
+
+    return UserShader { entry, std::move(code) };
+}
+
+auto compile_user_shader_library(std::string const& source,
+                                 std::filesystem::path const& output) -> void
+{
+    std::string errors;
+    auto state = compile(source, TCC_OUTPUT_DLL, errors);
+
+    /* The texture API is left undefined, to be resolved against the
+     * host program when the library is loaded...
+     */
+    if (tcc_output_file(state.get(), output.c_str()) < 0)
+        throw ShaderCompileError { "shader: output: " + errors };
+}
+
+auto load_user_shader_library(std::filesystem::path const& path)
+    -> UserShader
+{
+    auto* raw_handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!raw_handle)
+        throw ShaderCompileError { std::string { "shader: load: " }
+                                   + dlerror() };
+
+    std::shared_ptr<void const> handle { raw_handle, DlDeleter {} };
+
+    auto entry = reinterpret_cast<rgbctl_shader>(
+        dlsym(raw_handle, RGBCTL_SHADER_ENTRY_POINT));
+    if (!entry)
+        throw ShaderCompileError { "shader: missing entry point "
+                                   RGBCTL_SHADER_ENTRY_POINT };
+
+    return UserShader { entry, std::move(handle) };
+}
+
+auto user_shader_temporary_path(std::filesystem::path const& output)
+    -> std::filesystem::path
+{
+    static std::atomic<std::uint64_t> count { 0 };
+
+    auto path = output;
+    path += ".tmp." + std::to_string(getpid()) + "."
+            + std::to_string(count.fetch_add(1, std::memory_order_relaxed));
+
+    return path;
+}
+
+auto user_shader_compiler_id() -> std::string const&
+{
+    /* `__TINYC__` holds TCC's version number, which is the only way
+     * of asking libtcc which version it is...
+     */
+    static std::string const id = [] {
+        std::string errors;
+        auto state = compile("int const rgbctl_tinyc = __TINYC__;",
+                             TCC_OUTPUT_MEMORY,
+                             errors);
+
+        if (tcc_relocate(state.get(), TCC_RELOCATE_AUTO) < 0)
+            throw ShaderCompileError { "shader: relocate: " + errors };
+
+        auto const* version = reinterpret_cast<int const*>(
+            tcc_get_symbol(state.get(), "rgbctl_tinyc"));
+        if (!version)
+            throw ShaderCompileError { "shader: compiler version" };
+
+        return "tcc-" + std::to_string(*version);
+    }();
+
+    return id;
+}
+
+auto compile_user_shader_file(std::filesystem::path const& path)
+    -> UserShader
+{
+    return compile_user_shader(read_user_shader_source(path));
+}
+
+auto read_user_shader_source(std::filesystem::path const& path)
+    -> std::string
+{
+    std::ifstream file { path };
+    if (!file)
+        throw ShaderCompileError { "shader: open: " + path.string() };
+
+    std::ostringstream source;
+    source << file.rdbuf();
+
+    return source.str();
+}
+
+} // namespace rgbctl
@@ -0,0 +1,170 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include "texture_testing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+using rgbctl::Addressing;
+using rgbctl::RgbFloat;
+using rgbctl::Texture;
+using rgbctl::Vec;
+
+auto gradient(std::size_t count) -> std::vector<RgbFloat>
+{
+    std::vector<RgbFloat> texels;
+    for (std::size_t n = 0; n < count; ++n) {
+        auto const t = static_cast<float>(n) / static_cast<float>(count);
+        texels.push_back({ t, 1.f - t, t * t });
+    }
+
+    return texels;
+}
+
+/* Sampling as it was before addressing modes: the coordinate wrapped
+ * with `fmod`, and each texel's index with `%`. Wrapping must still
+ * match it exactly, including the cases in `shader_tests.cpp`...
+ */
+struct PreviousSampler
+{
+    std::vector<RgbFloat> const& texels;
+    std::ptrdiff_t width;
+    std::ptrdiff_t height;
+
+    static auto wrap(float x) noexcept -> float
+    {
+        return x > 0.f ? std::fmod(x, 1.f) : 1.f - std::fmod(std::abs(x), 1.f);
+    }
+
+    auto at(std::ptrdiff_t u, std::ptrdiff_t v) const -> RgbFloat
+    {
+        return texels[static_cast<std::size_t>((v % height) * width
+                                               + (u % width))];
+    }
+
+    auto nearest(Vec<float, 2> const& pos) const -> RgbFloat
+    {
+        auto const u = wrap(pos[0]) * static_cast<float>(width);
+        auto const v = wrap(pos[1]) * static_cast<float>(height);
+        return at(static_cast<std::ptrdiff_t>(u),
+                  static_cast<std::ptrdiff_t>(v));
+    }
+
+    auto linear(Vec<float, 2> const& pos) const -> RgbFloat
+    {
+        auto const u = wrap(pos[0]) * static_cast<float>(width);
+        auto const v = wrap(pos[1]) * static_cast<float>(height);
+        auto const u_dist = u - std::floor(u);
+        auto const v_dist = v - std::floor(v);
+        auto const x = static_cast<std::ptrdiff_t>(u) % width;
+        auto const y = static_cast<std::ptrdiff_t>(v) % height;
+
+        auto const top = rgbctl::lerp(at(x, y), at(x + 1, y), u_dist);
+        auto const bottom
+            = rgbctl::lerp(at(x, y + 1), at(x + 1, y + 1), u_dist);
+        return rgbctl::lerp(top, bottom, v_dist);
+    }
+};
+
+auto should_wrap_as_before() -> void
+{
+    for (auto const& [width, height] : { std::pair { 4, 1 },
+                                         std::pair { 7, 1 },
+                                         std::pair { 8, 8 },
+                                         std::pair { 5, 3 } }) {
+        auto const texels = gradient(static_cast<std::size_t>(width * height));
+        Texture const texture { texels, static_cast<std::size_t>(width) };
+        PreviousSampler const previous { texels, width, height };
+
+        auto difference = 0.f;
+        for (auto n = -400; n <= 400; ++n) {
+            Vec<float, 2> const uv { static_cast<float>(n) / 64.f,
+                                     static_cast<float>(n) / -37.f };
+            difference = std::max(
+                { difference,
+                  max_difference(
+                      texture.sample(uv, rgbctl::texture_filtering_nearest),
+                      previous.nearest(uv)),
+                  max_difference(
+                      texture.sample(uv, rgbctl::texture_filtering_linear),
+                      previous.linear(uv)) });
+        }
+
+        EXPECT(difference == 0.f);
+    }
+}
+
+auto should_clamp_to_edges() -> void
+{
+    auto const texels = gradient(4);
+    Texture const texture {
+        texels, 4, rgbctl::ColourSpace::Srgb, rgbctl::Mipmaps::None,
+        Addressing::Clamp
+    };
+    EXPECT(texture.addressing() == Addressing::Clamp);
+
+    auto const sample = [&](float u) {
+        return texture.sample({ u, 0.f }, rgbctl::texture_filtering_linear);
+    };
+
+    EXPECT(max_difference(sample(-3.f), texels[0]) == 0.f);
+    EXPECT(max_difference(sample(0.f), texels[0]) == 0.f);
+    EXPECT(max_difference(sample(.9f), texels[3]) == 0.f);
+    EXPECT(max_difference(sample(1.f), texels[3]) == 0.f);
+    EXPECT(max_difference(sample(5.f), texels[3]) == 0.f);
+    EXPECT(max_difference(sample(.375f),
+                          rgbctl::lerp(texels[1], texels[2], .5f))
+           < 1e-6f);
+}
+
+auto should_mirror_every_other_repeat() -> void
+{
+    auto const texels = gradient(4);
+    Texture const texture {
+        texels, 4, rgbctl::ColourSpace::Srgb, rgbctl::Mipmaps::None,
+        Addressing::Mirror
+    };
+
+    auto const sample = [&](float u) {
+        return texture.sample({ u, 0.f }, rgbctl::texture_filtering_nearest);
+    };
+
+    EXPECT(max_difference(sample(.1f), texels[0]) == 0.f);
+    EXPECT(max_difference(sample(1.1f), texels[3]) == 0.f);
+    EXPECT(max_difference(sample(1.9f), texels[0]) == 0.f);
+    EXPECT(max_difference(sample(2.1f), texels[0]) == 0.f);
+    EXPECT(max_difference(sample(-.1f), texels[0]) == 0.f);
+    EXPECT(max_difference(sample(-.9f), texels[3]) == 0.f);
+}
+
+auto should_filter_mipmaps_as_addressed() -> void
+{
+    std::vector<RgbFloat> texels(8, RgbFloat { 0.f, 0.f, 0.f });
+    std::fill_n(texels.begin(), 4, RgbFloat { 1.f, 1.f, 1.f });
+
+    auto const first = [&](Addressing addressing) {
+        Texture const texture { texels,
+                                8,
+                                rgbctl::ColourSpace::Srgb,
+                                rgbctl::Mipmaps::Lanczos,
+                                addressing };
+        return texture.sample(
+            { 0.f, 0.f }, rgbctl::texture_filtering_nearest, 1)[0];
+    };
+
+    /* Wrapping brings in the black end of the texture...
+     */
+    EXPECT(first(Addressing::Clamp) > first(Addressing::Wrap));
+    EXPECT(first(Addressing::Mirror) > first(Addressing::Wrap));
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_wrap_as_before),
+        TEST(should_clamp_to_edges),
+        TEST(should_mirror_every_other_repeat),
+        TEST(should_filter_mipmaps_as_addressed),
+    });
+}
@@ -0,0 +1,151 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using rgbctl::Canvas;
+using rgbctl::CanvasSampler;
+using rgbctl::RgbFloat;
+
+/* Fills the canvas with a ramp from black to white, counting ticks...
+ */
+struct RampEffect
+{
+    std::size_t* ticks;
+
+    auto zone_index() const noexcept -> std::size_t
+    {
+        return 0;
+    }
+
+    auto rgb_count() const noexcept -> std::size_t
+    {
+        return 0;
+    }
+
+    auto duration() const noexcept -> std::size_t
+    {
+        return 1000;
+    }
+
+    auto remaining() const noexcept -> std::size_t
+    {
+        return 1000;
+    }
+
+    auto tick(std::size_t, std::span<RgbFloat> out) -> std::size_t
+    {
+        ++*ticks;
+        auto const last = static_cast<float>(out.size() - 1);
+        for (std::size_t n = 0; n < out.size(); ++n) {
+            auto const v = static_cast<float>(n) / last;
+            out[n] = { v, v, v };
+        }
+
+        return out.size();
+    }
+};
+
+auto is_close(RgbFloat const& a, float v) noexcept -> bool
+{
+    return std::abs(a[0] - v) < 1e-5f && std::abs(a[1] - v) < 1e-5f
+           && std::abs(a[2] - v) < 1e-5f;
+}
+
+auto should_lay_out_lines_and_rings() -> void
+{
+    auto const line = rgbctl::led_line(5, { 0.f, .5f }, { 1.f, .5f });
+    EXPECT(line.positions.size() == 5);
+    EXPECT(line.positions[0][0] == 0.f);
+    EXPECT(line.positions[2][0] == .5f);
+    EXPECT(line.positions[4][0] == 1.f);
+
+    auto const ring = rgbctl::led_ring(4, { .5f, .5f }, .25f);
+    EXPECT(ring.positions.size() == 4);
+    EXPECT(std::abs(ring.positions[0][1] - .25f) < 1e-6f);
+    EXPECT(std::abs(ring.positions[1][0] - .75f) < 1e-6f);
+    EXPECT(std::abs(ring.positions[2][1] - .75f) < 1e-6f);
+}
+
+auto should_render_once_per_frame() -> void
+{
+    std::size_t ticks = 0;
+    auto canvas = std::make_shared<Canvas>(
+        rgbctl::AnyEffect { RampEffect { &ticks } }, 8);
+
+    CanvasSampler left { 0, canvas, rgbctl::led_line(4, { 0.f, 0.f },
+                                                     { .5f, 0.f }) };
+    CanvasSampler right { 1, canvas, rgbctl::led_line(4, { .5f, 0.f },
+                                                      { 1.f, 0.f }) };
+
+    std::array<RgbFloat, 4> frame;
+    for (int n = 0; n < 10; ++n) {
+        EXPECT(left.tick(33, frame) == 4);
+        EXPECT(right.tick(33, frame) == 4);
+    }
+
+    EXPECT(ticks == 10);
+    EXPECT(canvas->renders() == 10);
+}
+
+auto should_sample_led_positions() -> void
+{
+    std::size_t ticks = 0;
+    auto canvas = std::make_shared<Canvas>(
+        rgbctl::AnyEffect { RampEffect { &ticks } }, 5);
+
+    /* Pixel centres are at 0.1, 0.3...0.9, and positions past the
+     * first and last are held at them...
+     */
+    rgbctl::LedLayout const layout { { { 0.f, 0.f },
+                                       { .1f, 0.f },
+                                       { .2f, 0.f },
+                                       { .5f, 0.f },
+                                       { 1.f, 1.f } } };
+    CanvasSampler sampler { 0, canvas, layout };
+    EXPECT(sampler.rgb_count() == 5);
+
+    std::array<RgbFloat, 7> frame;
+    frame.fill({ 1.f, 1.f, 1.f });
+    EXPECT(sampler.tick(33, frame) == 5);
+
+    EXPECT(is_close(frame[0], 0.f));
+    EXPECT(is_close(frame[1], 0.f));
+    EXPECT(is_close(frame[2], .125f));
+    EXPECT(is_close(frame[3], .5f));
+    EXPECT(is_close(frame[4], 1.f));
+
+    /* Past the end of the layout...
+     */
+    EXPECT(is_close(frame[5], 0.f));
+    EXPECT(is_close(frame[6], 0.f));
+}
+
+auto should_sample_two_dimensions() -> void
+{
+    std::size_t ticks = 0;
+    auto canvas = std::make_shared<Canvas>(
+        rgbctl::AnyEffect { RampEffect { &ticks } }, 2, 2);
+
+    /* The ramp runs 0, 1/3, 2/3, 1 across the rows, so the middle of
+     * the canvas is their average...
+     */
+    CanvasSampler sampler { 0, canvas, { { { .5f, .5f }, { .25f, .75f } } } };
+    std::array<RgbFloat, 2> frame;
+    sampler.tick(33, frame);
+
+    EXPECT(is_close(frame[0], .5f));
+    EXPECT(is_close(frame[1], 2.f / 3));
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_lay_out_lines_and_rings),
+        TEST(should_render_once_per_frame),
+        TEST(should_sample_led_positions),
+        TEST(should_sample_two_dimensions),
+    });
+}
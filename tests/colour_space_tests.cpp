@@ -0,0 +1,135 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include "texture_testing.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using rgbctl::ColourSpace;
+using rgbctl::RgbFloat;
+
+/* More than one block's worth, crossing the linear segment of the sRGB
+ * curve...
+ */
+auto ramp() -> std::vector<RgbFloat>
+{
+    std::vector<RgbFloat> colours;
+    for (int n = 0; n <= 1000; ++n) {
+        auto const v = static_cast<float>(n) / 1000.f;
+        colours.push_back({ v, 1.f - v, v * v });
+    }
+
+    return colours;
+}
+
+auto should_parse_colour_spaces() -> void
+{
+    EXPECT(rgbctl::parse_colour_space("srgb") == ColourSpace::Srgb);
+    EXPECT(rgbctl::parse_colour_space("linear") == ColourSpace::LinearRgb);
+    EXPECT(rgbctl::parse_colour_space("oklab") == ColourSpace::Oklab);
+    EXPECT(!rgbctl::parse_colour_space("lab"));
+}
+
+auto should_match_reference_values() -> void
+{
+    auto const grey
+        = rgbctl::from_srgb(ColourSpace::LinearRgb, RgbFloat { .5f, 0.f, 1.f });
+    EXPECT(max_difference(grey, { .214041f, 0.f, 1.f }) < 1e-5f);
+
+    auto const white
+        = rgbctl::from_srgb(ColourSpace::Oklab, RgbFloat { 1.f, 1.f, 1.f });
+    EXPECT(max_difference(white, { 1.f, 0.f, 0.f }) < 1e-4f);
+
+    auto const red
+        = rgbctl::from_srgb(ColourSpace::Oklab, RgbFloat { 1.f, 0.f, 0.f });
+    EXPECT(max_difference(red, { .627955f, .224863f, .125846f }) < 1e-4f);
+}
+
+auto should_round_trip() -> void
+{
+    for (auto space : { ColourSpace::Srgb,
+                        ColourSpace::LinearRgb,
+                        ColourSpace::Oklab }) {
+        auto const expected = ramp();
+        auto colours = expected;
+        rgbctl::from_srgb(space, colours);
+        rgbctl::to_srgb(space, colours);
+
+        for (std::size_t n = 0; n < colours.size(); ++n)
+            EXPECT(max_difference(colours[n], expected[n]) < 1e-4f);
+    }
+}
+
+auto should_interpolate_in_colour_space() -> void
+{
+    std::array<RgbFloat, 2> const texels { { { 1.f, 0.f, 0.f },
+                                             { 0.f, 1.f, 0.f } } };
+    rgbctl::Vec<float, 2> const halfway { .25f, 0.f };
+
+    rgbctl::Texture const srgb { texels };
+    auto const mixed = srgb.sample(halfway, rgbctl::texture_filtering_linear);
+    EXPECT(max_difference(mixed, { .5f, .5f, 0.f }) < 1e-6f);
+
+    /* Half the light of each, rather than half the encoded value...
+     */
+    rgbctl::Texture const linear { texels,
+                                   rgbctl::Texture::one_row,
+                                   ColourSpace::LinearRgb };
+    EXPECT(linear.colour_space() == ColourSpace::LinearRgb);
+    auto const blended = rgbctl::to_srgb(
+        ColourSpace::LinearRgb,
+        linear.sample(halfway, rgbctl::texture_filtering_linear));
+    EXPECT(max_difference(blended, { .735357f, .735357f, 0.f }) < 1e-4f);
+}
+
+auto should_sample_srgb_through_c_api() -> void
+{
+    std::array<RgbFloat, 2> const texels { { { .2f, .4f, .6f },
+                                             { .2f, .4f, .6f } } };
+    rgbctl::Texture const texture { texels,
+                                    rgbctl::Texture::one_row,
+                                    ColourSpace::Oklab };
+
+    auto const one = rgb_sample_texture(&texture, .3f, 0.f, 0);
+    EXPECT(max_difference({ one.red, one.green, one.blue }, texels[0])
+           < 1e-4f);
+
+    /* More than one block of samples...
+     */
+    std::array<float, 100> x;
+    for (std::size_t n = 0; n < x.size(); ++n)
+        x[n] = static_cast<float>(n) / static_cast<float>(x.size());
+
+    std::array<float, 100> const y {};
+    std::array<rgbctl_rgb_float_value, 100> out {};
+    rgb_sample_texture_n(
+        &texture, x.data(), y.data(), 100, RGBCTL_SAMPLE_LINEAR, out.data());
+    for (auto const& colour : out)
+        EXPECT(max_difference({ colour.red, colour.green, colour.blue },
+                              texels[0])
+               < 1e-4f);
+}
+
+auto should_reject_fixed_point_colour_spaces() -> void
+{
+    EXPECT_THROWS((rgbctl::effects::Rotate { 0,
+                                             1000,
+                                             { { { 1.f, 0.f, 0.f } } },
+                                             rgbctl::TexturePrecision::Fixed,
+                                             ColourSpace::Oklab }),
+                  std::invalid_argument);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_parse_colour_spaces),
+        TEST(should_match_reference_values),
+        TEST(should_round_trip),
+        TEST(should_interpolate_in_colour_space),
+        TEST(should_sample_srgb_through_c_api),
+        TEST(should_reject_fixed_point_colour_spaces),
+    });
+}
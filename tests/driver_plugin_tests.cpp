@@ -2,34 +2,32 @@
 #include "rgbctl/rgbctl.hpp"
 #include "testing.hpp"
 #include <array>
-#include <dlfcn.h>
-#include <iostream>
-#include <memory>
 
-struct DlDeleter
+rgbctl_product_id constexpr kTestDriverProduct = { 0xffff, 0x0001 };
+
+TEST_WITH_CONTEXT(should_scan_without_loading_plugin)
 {
-    auto operator()(void* handle) const noexcept -> void
-    {
-        dlclose(handle);
-    }
-};
+    EXPECT(test_context.argc == 1);
 
-using DlPtr = std::unique_ptr<void, DlDeleter>;
-using Init = auto (*)(rgbctl_module_registration*) -> rgbctl_errno;
+    rgbctl::PluginRegistry plugins;
+    EXPECT(plugins.scan(*test_context.argv) == 1);
 
-auto should_load_plugin()
-{
-    DlPtr handle { dlopen("/home/greg/.local/tmp/test_plugin.so", RTLD_LAZY) };
-    if (!handle.get())
-        std::cerr << dlerror() << '\n';
+    EXPECT(plugins.plugin_count() == 1);
+    EXPECT(plugins.loaded_count() == 0);
+    EXPECT(plugins.supports(kTestDriverProduct));
+    EXPECT(!plugins.supports(rgbctl_product_id { 0xffff, 0x0002 }));
+}
 
-    EXPECT(handle.get());
+TEST_WITH_CONTEXT(should_load_plugin)
+{
+    EXPECT(test_context.argc == 1);
 
-    Init init = reinterpret_cast<Init>(dlsym(handle.get(), "init"));
-    EXPECT(init);
+    rgbctl::PluginRegistry plugins;
+    plugins.scan(*test_context.argv);
 
-    rgbctl_module_registration reg {};
-    EXPECT(init(&reg) == RGBCTL_SUCCESS);
+    auto const& reg = plugins.load(kTestDriverProduct);
+    EXPECT(plugins.loaded_count() == 1);
+    EXPECT(reg.product_count == 1);
 
     std::array<unsigned char, 16> write_buffer {};
     std::array<unsigned char const, 16> read_buffer {};
@@ -38,17 +36,33 @@ auto should_load_plugin()
                                  { write_buffer.data(), write_buffer.size() } };
     rgbctl::DeviceContext<MockReadWriteStream> ctx { std::move(stream) };
 
-    auto mod
-        = rgbctl::acquire_module(ctx, reg.products[0], reg.acquire_callback);
+    auto mod = rgbctl::acquire_module(
+        ctx, kTestDriverProduct, reg.acquire_callback, reg.user_data);
+
+    EXPECT(mod.query_zones(ctx).size() == 1);
 
     rgbctl_rgb_value const kData[] = { { 0, 0, 0 } };
     mod.send_rgb_data(
         ctx, 0, kData, rgbctl::narrow_cast<std::uint32_t>(std::size(kData)));
 }
 
-auto main() -> int
+TEST_WITH_CONTEXT(should_fail_to_load_unsupported_product)
+{
+    rgbctl::PluginRegistry plugins;
+    plugins.scan(*test_context.argv);
+
+    EXPECT_THROWS(plugins.load(rgbctl_product_id { 0xffff, 0x0002 }),
+                  std::runtime_error);
+}
+
+auto main(int argc, char const** argv) -> int
 {
-    return rgbctl::testing::run({
-        IGNORE(should_load_plugin, "external module"),
-    });
+    return rgbctl::testing::run_with_context(
+        argc,
+        argv,
+        {
+            TEST(should_scan_without_loading_plugin),
+            TEST(should_load_plugin),
+            TEST(should_fail_to_load_unsupported_product),
+        });
 }
@@ -18,18 +18,19 @@ auto linear_should_return_correct_val() -> void
         0, 2, 1000, { inputs.data(), inputs.size() }
     };
 
-    std::array<rgbctl_rgb_value, 2> result;
+    std::array<rgbctl::RgbFloat, 2> result;
     auto num = effect.tick(1000, { result.data(), result.size() });
 
     EXPECT(num == result.size());
 
+    auto out = rgbctl::to_rgb_uint8(result[0]);
     std::cerr << std::hex << std::setfill('0') << std::setw(2)
-              << (int)result[0].red << std::setw(2) << (int)result[0].green
-              << std::setw(2) << (int)result[0].blue << '\n';
+              << (int)out.red << std::setw(2) << (int)out.green
+              << std::setw(2) << (int)out.blue << '\n';
 
-    EXPECT(result[0].red == 0x00);
-    EXPECT(result[0].green == 0x00);
-    EXPECT(result[0].blue == 0xff);
+    EXPECT(out.red == 0x00);
+    EXPECT(out.green == 0x00);
+    EXPECT(out.blue == 0xff);
 }
 
 auto rotate_should_return_correct_val() -> void
@@ -44,24 +45,25 @@ auto rotate_should_return_correct_val() -> void
                                      1000,
                                      { inputs.data(), inputs.size() } };
 
-    std::array<rgbctl_rgb_value, inputs.size()> result;
+    std::array<rgbctl::RgbFloat, inputs.size()> result;
     auto num = effect.tick(1000, { result.data(), result.size() });
 
     EXPECT(num == result.size());
 
+    auto out = rgbctl::to_rgb_uint8(result[0]);
     std::cerr << std::hex << std::setfill('0') << std::setw(2)
-              << (int)result[0].red << std::setw(2) << (int)result[0].green
-              << std::setw(2) << (int)result[0].blue << '\n';
+              << (int)out.red << std::setw(2) << (int)out.green
+              << std::setw(2) << (int)out.blue << '\n';
 
-    EXPECT(result[0].red == 0xff);
-    EXPECT(result[0].green == 0x00);
-    EXPECT(result[0].blue == 0x00);
+    EXPECT(out.red == 0xff);
+    EXPECT(out.green == 0x00);
+    EXPECT(out.blue == 0x00);
 }
 
 auto rotate_should_have_correct_step_values() -> void
 {
     std::array<rgbctl::RgbFloat, 4> inputs {};
-    std::array<rgbctl_rgb_value, inputs.size()> result;
+    std::array<rgbctl::RgbFloat, inputs.size()> result;
 
     auto rgb = inputs.begin();
     EXPECT(hex_string_to_rgb_float("ff0000", *rgb++));
@@ -76,35 +78,38 @@ auto rotate_should_have_correct_step_values() -> void
     auto num = effect.tick(250, { result.data(), result.size() });
     EXPECT(num == result.size());
 
+    auto out = rgbctl::to_rgb_uint8(result[0]);
     std::cerr << std::hex << std::setfill('0') << std::setw(2)
-              << (int)result[0].red << std::setw(2) << (int)result[0].green
-              << std::setw(2) << (int)result[0].blue << '\n';
+              << (int)out.red << std::setw(2) << (int)out.green
+              << std::setw(2) << (int)out.blue << '\n';
 
-    EXPECT(result[0].red == 0x00);
-    EXPECT(result[0].green == 0x00);
-    EXPECT(result[0].blue == 0x00);
+    EXPECT(out.red == 0x00);
+    EXPECT(out.green == 0x00);
+    EXPECT(out.blue == 0x00);
 
     num = effect.tick(250, { result.data(), result.size() });
     EXPECT(num == result.size());
 
+    out = rgbctl::to_rgb_uint8(result[0]);
     std::cerr << std::hex << std::setfill('0') << std::setw(2)
-              << (int)result[0].red << std::setw(2) << (int)result[0].green
-              << std::setw(2) << (int)result[0].blue << '\n';
+              << (int)out.red << std::setw(2) << (int)out.green
+              << std::setw(2) << (int)out.blue << '\n';
 
-    EXPECT(result[0].red == 0x00);
-    EXPECT(result[0].green == 0x00);
-    EXPECT(result[0].blue == 0xff);
+    EXPECT(out.red == 0x00);
+    EXPECT(out.green == 0x00);
+    EXPECT(out.blue == 0xff);
 
     num = effect.tick(250, { result.data(), result.size() });
     EXPECT(num == result.size());
 
+    out = rgbctl::to_rgb_uint8(result[0]);
     std::cerr << std::hex << std::setfill('0') << std::setw(2)
-              << (int)result[0].red << std::setw(2) << (int)result[0].green
-              << std::setw(2) << (int)result[0].blue << '\n';
+              << (int)out.red << std::setw(2) << (int)out.green
+              << std::setw(2) << (int)out.blue << '\n';
 
-    EXPECT(result[0].red == 0x00);
-    EXPECT(result[0].green == 0xff);
-    EXPECT(result[0].blue == 0x00);
+    EXPECT(out.red == 0x00);
+    EXPECT(out.green == 0xff);
+    EXPECT(out.blue == 0x00);
 }
 
 auto should_be_compatible_with_effect_concept() -> void
@@ -114,7 +119,7 @@ auto should_be_compatible_with_effect_concept() -> void
     using rgbctl::effects::Rotate;
 
     std::array<rgbctl::RgbFloat, 3> inputs {};
-    std::array<rgbctl_rgb_value, inputs.size()> result;
+    std::array<rgbctl::RgbFloat, inputs.size()> result;
 
     auto rgb = inputs.begin();
     EXPECT(hex_string_to_rgb_float("ff0000", *rgb++));
@@ -0,0 +1,187 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include "texture_testing.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using rgbctl::FixedTexture;
+using rgbctl::RgbFloat;
+using rgbctl::Texture;
+using rgbctl::Vec;
+
+std::array<RgbFloat, 12> const kTexels { {
+    { 1.f, 0.f, 0.f },
+    { 0.f, 1.f, 0.f },
+    { 0.f, 0.f, 1.f },
+    { .5f, .25f, .125f },
+    { .1f, .2f, .3f },
+    { .9f, .8f, .7f },
+    { 0.f, 0.f, 0.f },
+    { 1.f, 1.f, 1.f },
+    { .33f, .66f, .99f },
+    { .75f, .5f, .25f },
+    { .2f, .4f, .6f },
+    { .6f, .4f, .2f },
+} };
+
+template <typename T, std::size_t N>
+auto is_same(Vec<T, N> const& a, Vec<T, N> const& b) noexcept -> bool
+{
+    return std::equal(a.begin(), a.end(), b.begin());
+}
+
+auto should_round_trip_channels() -> void
+{
+    for (int n = 0; n <= 1000; ++n) {
+        auto const v = static_cast<float>(n) / 1000.f;
+        RgbFloat const colour { v, 1.f - v, v / 2 };
+        auto const fixed = rgbctl::to_rgb_fixed(colour);
+        EXPECT(max_difference(rgbctl::to_rgb_float(fixed), colour)
+               <= 1.f / 65535.f);
+    }
+}
+
+auto should_wrap_coordinates() -> void
+{
+    using rgbctl::to_fixed_coord;
+
+    using rgbctl::FixedCoord;
+
+    EXPECT(is_same(to_fixed_coord({ -.25f, 1.5f }),
+                   to_fixed_coord({ .75f, .5f })));
+    EXPECT(is_same(to_fixed_coord({ 3.f, -1.f }), FixedCoord { 0u, 0u }));
+    EXPECT(is_same(to_fixed_coord({ .5f, .25f }),
+                   FixedCoord { 0x8000u, 0x4000u }));
+}
+
+auto should_sample_nearest_like_float() -> void
+{
+    Texture const texture { kTexels, 4 };
+    FixedTexture const fixed { kTexels, 4 };
+
+    EXPECT(fixed.width() == 4);
+    EXPECT(fixed.height() == 3);
+
+    for (int y = 0; y < 3; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            Vec<float, 2> const centre { (static_cast<float>(x) + .5f) / 4.f,
+                                         (static_cast<float>(y) + .5f) / 3.f };
+            EXPECT(is_same(fixed.sample(rgbctl::to_fixed_coord(centre),
+                                        rgbctl::texture_filtering_nearest),
+                           rgbctl::to_rgb_fixed(texture.sample(
+                               centre, rgbctl::texture_filtering_nearest))));
+        }
+    }
+}
+
+auto should_sample_linear_close_to_float() -> void
+{
+    Texture const texture { kTexels, 4 };
+    FixedTexture const fixed { kTexels, 4 };
+
+    /* Steps that don't divide the texture evenly, crossing every texel
+     * edge, including the ones that wrap...
+     */
+    auto error = 0.f;
+    for (int y = -37; y < 37; ++y) {
+        for (int x = -53; x < 53; ++x) {
+            Vec<float, 2> const coord { static_cast<float>(x) / 53.f * 1.3f,
+                                        static_cast<float>(y) / 37.f * 1.1f };
+            auto const expected
+                = texture.sample(coord, rgbctl::texture_filtering_linear);
+            auto const actual = rgbctl::to_rgb_float(
+                fixed.sample(rgbctl::to_fixed_coord(coord),
+                             rgbctl::texture_filtering_linear));
+            error = std::max(error, max_difference(expected, actual));
+        }
+    }
+
+    EXPECT(error < 0.001f);
+}
+
+auto should_match_float_effects() -> void
+{
+    using rgbctl::TexturePrecision;
+    using rgbctl::effects::Linear;
+    using rgbctl::effects::Rotate;
+
+    Rotate rotate { 0, 1000, kTexels };
+    Rotate fixed_rotate { 0, 1000, kTexels, TexturePrecision::Fixed };
+    Linear linear { 0, 4, 1000, kTexels };
+    Linear fixed_linear { 0, 4, 1000, kTexels, TexturePrecision::Fixed };
+
+    std::array<RgbFloat, 10> expected;
+    std::array<RgbFloat, 10> actual;
+    auto error = 0.f;
+    for (int tick = 0; tick < 40; ++tick) {
+        EXPECT(rotate.tick(33, expected) == 10);
+        EXPECT(fixed_rotate.tick(33, actual) == 10);
+        for (std::size_t n = 0; n < expected.size(); ++n)
+            error = std::max(error, max_difference(expected[n], actual[n]));
+
+        EXPECT(linear.tick(33, expected) == 10);
+        EXPECT(fixed_linear.tick(33, actual) == 10);
+        for (std::size_t n = 0; n < expected.size(); ++n)
+            error = std::max(error, max_difference(expected[n], actual[n]));
+    }
+
+    EXPECT(error < 0.001f);
+}
+
+auto should_reject_empty_texture() -> void
+{
+    EXPECT_THROWS(FixedTexture { std::span<RgbFloat const> {} },
+                  std::invalid_argument);
+}
+
+auto should_reject_bad_widths() -> void
+{
+    EXPECT_THROWS((FixedTexture { kTexels, 0 }), std::invalid_argument);
+    EXPECT_THROWS((FixedTexture { kTexels, 5 }), std::invalid_argument);
+}
+
+auto should_make_either_precision() -> void
+{
+    using rgbctl::ColourSpace;
+    using rgbctl::Mipmaps;
+    using rgbctl::TexturePrecision;
+
+    auto const texture
+        = rgbctl::make_texture(kTexels, 4, TexturePrecision::Float);
+    EXPECT(std::get<0>(texture)->width() == 4);
+
+    auto const fixed
+        = rgbctl::make_texture(kTexels, 4, TexturePrecision::Fixed);
+    EXPECT(std::get<1>(fixed)->width() == 4);
+
+    /* Both effects get the same checks...
+     */
+    EXPECT_THROWS(rgbctl::make_texture(kTexels,
+                                       4,
+                                       TexturePrecision::Fixed,
+                                       ColourSpace::Oklab),
+                  std::invalid_argument);
+    EXPECT_THROWS(rgbctl::make_texture(kTexels,
+                                       4,
+                                       TexturePrecision::Fixed,
+                                       ColourSpace::Srgb,
+                                       Mipmaps::Box),
+                  std::invalid_argument);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_round_trip_channels),
+        TEST(should_wrap_coordinates),
+        TEST(should_sample_nearest_like_float),
+        TEST(should_sample_linear_close_to_float),
+        TEST(should_match_float_effects),
+        TEST(should_reject_empty_texture),
+        TEST(should_reject_bad_widths),
+        TEST(should_make_either_precision),
+    });
+}
@@ -0,0 +1,117 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include <chrono>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using rgbctl::LatencyHistogram;
+
+auto should_bucket_values_within_precision() -> void
+{
+    auto const precision = 1.0 / LatencyHistogram::kSubBuckets;
+
+    for (std::uint64_t value = 1; value < (std::uint64_t { 1 } << 62);
+         value = value * 3 + 1) {
+        auto const index = LatencyHistogram::bucket_index(value);
+        EXPECT(index < LatencyHistogram::kBucketCount);
+
+        auto const upper = LatencyHistogram::bucket_upper_bound(index);
+        EXPECT(upper >= value);
+        EXPECT(static_cast<double>(upper - value)
+               <= static_cast<double>(value) * precision);
+
+        if (index > 0)
+            EXPECT(LatencyHistogram::bucket_upper_bound(index - 1) < value);
+    }
+
+    EXPECT(LatencyHistogram::bucket_index(
+               std::numeric_limits<std::uint64_t>::max())
+           == LatencyHistogram::kBucketCount - 1);
+}
+
+auto should_report_percentiles() -> void
+{
+    LatencyHistogram histogram;
+    for (auto n = 1; n <= 1000; ++n)
+        histogram.record(std::chrono::microseconds { n });
+
+    EXPECT(histogram.count() == 1000);
+    EXPECT(histogram.max() == 1000us);
+    EXPECT(histogram.sum() == 500500us);
+
+    auto const p50 = histogram.percentile(.5);
+    EXPECT(p50 >= 500us && p50 <= 500us + 500us / 16);
+
+    auto const p99 = histogram.percentile(.99);
+    EXPECT(p99 >= 990us && p99 <= 1000us);
+
+    EXPECT(histogram.percentile(1.) == histogram.max());
+}
+
+auto should_count_missed_deadlines() -> void
+{
+    LatencyHistogram histogram { 10ms };
+    histogram.record(5ms);
+    histogram.record(10ms);
+    histogram.record(11ms);
+    histogram.record(-1ms);
+
+    EXPECT(histogram.count() == 4);
+    EXPECT(histogram.missed_deadlines() == 1);
+    EXPECT(histogram.percentile(0.) == 0ns);
+
+    histogram.reset();
+    EXPECT(histogram.count() == 0);
+    EXPECT(histogram.missed_deadlines() == 0);
+    EXPECT(histogram.max() == 0ns);
+    EXPECT(histogram.sum() == 0ns);
+}
+
+auto should_record_from_many_threads() -> void
+{
+    LatencyHistogram histogram;
+
+    std::vector<std::thread> threads;
+    for (auto t = 0; t < 4; ++t)
+        threads.emplace_back([&, t] {
+            for (auto n = 0; n < 10000; ++n)
+                histogram.record(std::chrono::nanoseconds { n + t });
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT(histogram.count() == 40000);
+    EXPECT(histogram.max() == 10002ns);
+}
+
+auto should_keep_registered_histograms() -> void
+{
+    rgbctl::HistogramRegistry registry;
+    auto& first = registry.histogram("first");
+    for (auto n = 0; n < 100; ++n)
+        registry.histogram("other." + std::to_string(n));
+
+    first.record(1ms);
+    EXPECT(registry.size() == 101);
+    EXPECT(first.count() == 1);
+
+    std::ostringstream output;
+    registry.dump(output);
+    EXPECT(output.str().find("first") != std::string::npos);
+    EXPECT(output.str().find("1000.0") != std::string::npos);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_bucket_values_within_precision),
+        TEST(should_report_percentiles),
+        TEST(should_count_missed_deadlines),
+        TEST(should_record_from_many_threads),
+        TEST(should_keep_registered_histograms),
+    });
+}
@@ -0,0 +1,176 @@
+#include "mock_read_write_stream.hpp"
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using rgbctl::metrics::Counter;
+
+auto counter(Counter c) -> std::uint64_t
+{
+    return rgbctl::metrics::snapshot()[static_cast<std::size_t>(c)];
+}
+
+auto should_sum_counters_across_threads() -> void
+{
+    auto const before = counter(Counter::FramesRendered);
+
+    std::vector<std::thread> threads;
+    for (auto t = 0; t < 4; ++t)
+        threads.emplace_back([] {
+            for (auto n = 0; n < 1000; ++n)
+                rgbctl::metrics::add(Counter::FramesRendered);
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT(counter(Counter::FramesRendered) - before == 4000);
+}
+
+auto should_count_device_io() -> void
+{
+    auto const written = counter(Counter::BytesWritten);
+    auto const read = counter(Counter::BytesRead);
+
+    std::array<unsigned char, 4> const read_buffer { 1, 2, 3, 4 };
+    std::array<unsigned char, 8> write_buffer {};
+    rgbctl::DeviceContext<MockReadWriteStream> ctx { MockReadWriteStream {
+        { read_buffer.data(), read_buffer.size() },
+        { write_buffer.data(), write_buffer.size() } } };
+
+    std::array<unsigned char, 6> data {};
+    EXPECT(rgbctl_write(&ctx, data.data(), 6) == 6);
+    EXPECT(rgbctl_read(&ctx, data.data(), 6) == 4);
+
+    EXPECT(counter(Counter::BytesWritten) - written == 6);
+    EXPECT(counter(Counter::BytesRead) - read == 4);
+}
+
+auto should_write_prometheus_text() -> void
+{
+    rgbctl::HistogramRegistry histograms;
+    auto& loop_period = histograms.histogram("loop.period");
+    loop_period.record(std::chrono::milliseconds { 33 });
+
+    std::ostringstream text;
+    rgbctl::metrics::write_prometheus(text, &histograms);
+
+    auto const output = text.str();
+    EXPECT(output.find("# TYPE rgbctl_frames_rendered_total counter\n")
+           != std::string::npos);
+    EXPECT(output.find(
+               "rgbctl_latency_seconds_sum{name=\"loop.period\"} 0.033\n")
+           != std::string::npos);
+    EXPECT(output.find(
+               "rgbctl_latency_seconds_count{name=\"loop.period\"} 1\n")
+           != std::string::npos);
+    EXPECT(output.find(
+               "rgbctl_latency_max_seconds{name=\"loop.period\"} 0.033")
+           != std::string::npos);
+}
+
+auto should_serve_metrics_over_socket() -> void
+{
+    auto const path = std::filesystem::temp_directory_path()
+                      / ("rgbctl_metrics_tests." + std::to_string(getpid()));
+
+    rgbctl::HistogramRegistry histograms;
+    rgbctl::MetricsServer server { path, &histograms };
+
+    auto const fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    EXPECT(fd >= 0);
+
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    EXPECT(connect(fd,
+                   reinterpret_cast<sockaddr const*>(&address),
+                   sizeof(address))
+           == 0);
+
+    std::string response;
+    std::array<char, 256> buffer;
+    ssize_t n;
+    while ((n = read(fd, buffer.data(), buffer.size())) > 0)
+        response.append(buffer.data(), static_cast<std::size_t>(n));
+    close(fd);
+
+    EXPECT(response.find("rgbctl_bytes_written_total ") != std::string::npos);
+}
+
+auto should_stop_with_a_stalled_client() -> void
+{
+    using namespace std::chrono_literals;
+
+    auto const path = std::filesystem::temp_directory_path()
+                      / ("rgbctl_metrics_tests.stalled."
+                         + std::to_string(getpid()));
+
+    /* Enough histograms that the response can't fit in the socket's
+     * buffer...
+     */
+    rgbctl::HistogramRegistry histograms;
+    for (auto n = 0; n < 2000; ++n)
+        histograms.histogram("stalled." + std::to_string(n));
+
+    auto const fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    EXPECT(fd >= 0);
+
+    auto const start = std::chrono::steady_clock::now();
+    {
+        rgbctl::MetricsServer server { path, &histograms };
+
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, path.c_str());
+        EXPECT(connect(fd,
+                       reinterpret_cast<sockaddr const*>(&address),
+                       sizeof(address))
+               == 0);
+
+        std::this_thread::sleep_for(50ms);
+    }
+
+    close(fd);
+    EXPECT(std::chrono::steady_clock::now() - start < 500ms);
+}
+
+auto should_not_replace_other_files() -> void
+{
+    auto const path = std::filesystem::temp_directory_path()
+                      / ("rgbctl_metrics_tests.file."
+                         + std::to_string(getpid()));
+    {
+        std::ofstream file { path };
+        file << "not a socket";
+    }
+
+    rgbctl::HistogramRegistry histograms;
+    EXPECT_THROWS((rgbctl::MetricsServer { path, &histograms }),
+                  std::runtime_error);
+    EXPECT(std::filesystem::is_regular_file(path));
+    std::filesystem::remove(path);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_sum_counters_across_threads),
+        TEST(should_count_device_io),
+        TEST(should_write_prometheus_text),
+        TEST(should_serve_metrics_over_socket),
+        TEST(should_stop_with_a_stalled_client),
+        TEST(should_not_replace_other_files),
+    });
+}
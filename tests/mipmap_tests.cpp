@@ -0,0 +1,134 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include "texture_testing.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+using rgbctl::Mipmaps;
+using rgbctl::RgbFloat;
+using rgbctl::Texture;
+
+/* Black and white texels in turn, which a zone much shorter than the
+ * texture aliases...
+ */
+auto stripes(std::size_t count) -> std::vector<RgbFloat>
+{
+    std::vector<RgbFloat> texels;
+    for (std::size_t n = 0; n < count; ++n) {
+        auto const v = static_cast<float>(n % 2);
+        texels.push_back({ v, v, v });
+    }
+
+    return texels;
+}
+
+auto should_build_levels_down_to_one_texel() -> void
+{
+    Texture const row { stripes(64),
+                        Texture::one_row,
+                        rgbctl::ColourSpace::Srgb,
+                        Mipmaps::Box };
+    EXPECT(row.levels() == 7);
+    EXPECT(row.width(0) == 64);
+    EXPECT(row.width(6) == 1);
+
+    Texture const odd { stripes(18),
+                        6,
+                        rgbctl::ColourSpace::Srgb,
+                        Mipmaps::Lanczos };
+    EXPECT(odd.levels() == 3);
+    EXPECT(odd.width(1) == 3);
+    EXPECT(odd.width(2) == 1);
+    EXPECT(odd.width() == 6);
+    EXPECT(odd.height() == 3);
+
+    Texture const plain { stripes(64) };
+    EXPECT(plain.levels() == 1);
+}
+
+auto should_average_levels() -> void
+{
+    for (auto filter : { Mipmaps::Box, Mipmaps::Lanczos }) {
+        Texture const texture { stripes(64),
+                                Texture::one_row,
+                                rgbctl::ColourSpace::Srgb,
+                                filter };
+
+        for (std::size_t level = 1; level < texture.levels(); ++level) {
+            for (int n = 0; n < 16; ++n) {
+                rgbctl::Vec<float, 2> const coord {
+                    static_cast<float>(n) / 16.f, 0.f
+                };
+                auto const sample = texture.sample(
+                    coord, rgbctl::texture_filtering_nearest, level);
+                EXPECT(max_difference(sample, { .5f, .5f, .5f }) < .05f);
+            }
+        }
+    }
+}
+
+auto should_keep_flat_colours() -> void
+{
+    std::vector<RgbFloat> const texels(36, RgbFloat { .2f, .4f, .6f });
+    Texture const texture { texels,
+                            6,
+                            rgbctl::ColourSpace::Srgb,
+                            Mipmaps::Lanczos };
+
+    for (std::size_t level = 0; level < texture.levels(); ++level)
+        EXPECT(max_difference(texture.sample({ .3f, .7f },
+                                             rgbctl::texture_filtering_linear,
+                                             level),
+                              texels[0])
+               < 1e-5f);
+}
+
+auto should_choose_level_for_zone() -> void
+{
+    Texture const texture { stripes(256),
+                            Texture::one_row,
+                            rgbctl::ColourSpace::Srgb,
+                            Mipmaps::Box };
+
+    EXPECT(texture.width(texture.level_for(4)) == 4);
+    EXPECT(texture.width(texture.level_for(5)) == 8);
+    EXPECT(texture.level_for(256) == 0);
+    EXPECT(texture.level_for(1000) == 0);
+    EXPECT(Texture { stripes(256) }.level_for(4) == 0);
+
+    /* A level past the last samples the last...
+     */
+    auto const last
+        = texture.sample({ .1f, 0.f }, rgbctl::texture_filtering_linear, 99);
+    EXPECT(max_difference(last, { .5f, .5f, .5f }) < 1e-5f);
+}
+
+auto should_not_alias_short_zones() -> void
+{
+    rgbctl::effects::Rotate effect { 0,
+                                     1000,
+                                     stripes(64),
+                                     rgbctl::TexturePrecision::Float,
+                                     rgbctl::ColourSpace::Srgb,
+                                     Mipmaps::Box };
+
+    std::array<RgbFloat, 4> frame;
+    for (int tick = 0; tick < 50; ++tick) {
+        EXPECT(effect.tick(7, frame) == frame.size());
+        for (auto const& led : frame)
+            EXPECT(max_difference(led, { .5f, .5f, .5f }) < 1e-5f);
+    }
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_build_levels_down_to_one_texel),
+        TEST(should_average_levels),
+        TEST(should_keep_flat_colours),
+        TEST(should_choose_level_for_zone),
+        TEST(should_not_alias_short_zones),
+    });
+}
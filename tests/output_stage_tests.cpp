@@ -0,0 +1,179 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using rgbctl::OutputStage;
+using rgbctl::RgbFloat;
+
+/* A frame of one LED, from a stage that hasn't converted anything...
+ */
+auto convert(OutputStage stage, RgbFloat colour) -> rgbctl_rgb_value
+{
+    rgbctl_rgb_value out {};
+    EXPECT(stage.apply({ &colour, 1 }, { &out, 1 }) == 1);
+    return out;
+}
+
+auto is_rgb(rgbctl_rgb_value const& val,
+            std::uint8_t r,
+            std::uint8_t g,
+            std::uint8_t b) noexcept -> bool
+{
+    return val.red == r && val.green == g && val.blue == b;
+}
+
+auto should_round_trip_every_byte() -> void
+{
+    OutputStage stage;
+
+    std::vector<RgbFloat> colours;
+    for (int n = 0; n < 256; ++n) {
+        auto const v = static_cast<float>(n) / 255.f;
+        colours.push_back({ v, v, 1.f - v });
+    }
+
+    /* More than one block's worth...
+     */
+    std::vector<rgbctl_rgb_value> out(colours.size());
+    EXPECT(stage.apply(colours, out) == out.size());
+
+    for (std::size_t n = 0; n < out.size(); ++n) {
+        auto const byte = static_cast<std::uint8_t>(n);
+        EXPECT(is_rgb(out[n], byte, byte, static_cast<std::uint8_t>(255 - n)));
+    }
+}
+
+auto should_apply_channel_order() -> void
+{
+    OutputStage bgr { {}, RGBCTL_CHANNEL_ORDER_BGR };
+    OutputStage grb { {}, RGBCTL_CHANNEL_ORDER_GRB };
+    RgbFloat const colour { 1.f, 128.f / 255.f, 0.f };
+
+    EXPECT(is_rgb(convert(bgr, colour), 0x00, 0x80, 0xff));
+    EXPECT(is_rgb(convert(grb, colour), 0x80, 0xff, 0x00));
+}
+
+auto should_cap_brightness_and_balance_white() -> void
+{
+    OutputStage stage { { .brightness = .5f,
+                          .white_balance = { 1.f, .5f, 2.f } } };
+
+    EXPECT(is_rgb(convert(stage, { 1.f, 1.f, 1.f }), 0x80, 0x40, 0xff));
+    EXPECT(is_rgb(convert(stage, { 0.f, 0.f, .25f }), 0x00, 0x00, 0x40));
+}
+
+auto should_apply_gamma() -> void
+{
+    OutputStage stage { { .gamma = 2.2f } };
+
+    EXPECT(is_rgb(convert(stage, { 0.f, 1.f, 0.f }), 0x00, 0xff, 0x00));
+
+    auto const mid = convert(stage, { .5f, .5f, .5f });
+    auto const expected
+        = static_cast<std::uint8_t>(std::lround(std::pow(.5f, 2.2f) * 255));
+    EXPECT(mid.red == expected || mid.red == expected + 1);
+
+    /* Never any brighter for a brighter input...
+     */
+    std::vector<RgbFloat> ramp;
+    for (int n = 0; n <= 1000; ++n)
+        ramp.push_back(RgbFloat { 1.f, 1.f, 1.f } * (static_cast<float>(n)
+                                                     / 1000.f));
+
+    std::vector<rgbctl_rgb_value> out(ramp.size());
+    stage.apply(ramp, out);
+    for (std::size_t n = 1; n < out.size(); ++n)
+        EXPECT(out[n].red >= out[n - 1].red);
+}
+
+auto should_dither_over_frames() -> void
+{
+    OutputStage stage;
+    RgbFloat const colour { 100.25f / 255.f, 100.f / 255.f, 0.f };
+
+    std::size_t red = 0;
+    std::size_t green = 0;
+    std::size_t const frames = 1000;
+    for (std::size_t n = 0; n < frames; ++n) {
+        rgbctl_rgb_value out {};
+        stage.apply({ &colour, 1 }, { &out, 1 });
+        EXPECT(out.red == 100 || out.red == 101);
+        red += out.red;
+        green += out.green;
+    }
+
+    /* Only as accurate as the lookup tables...
+     */
+    auto const mean = static_cast<double>(red) / frames;
+    EXPECT(mean > 100.24 && mean < 100.27);
+    EXPECT(green == 100 * frames);
+}
+
+auto should_start_dithering_from_rounded() -> void
+{
+    OutputStage dithered;
+    OutputStage rounded { { .dither = false } };
+
+    std::vector<RgbFloat> colours;
+    for (int n = 0; n <= 100; ++n)
+        colours.push_back(RgbFloat { 1.f, .5f, .25f }
+                          * (static_cast<float>(n) / 100.f));
+
+    std::vector<rgbctl_rgb_value> first(colours.size());
+    std::vector<rgbctl_rgb_value> second(colours.size());
+    dithered.apply(colours, first);
+    rounded.apply(colours, second);
+    for (std::size_t n = 0; n < colours.size(); ++n)
+        EXPECT(is_rgb(
+            first[n], second[n].red, second[n].green, second[n].blue));
+
+    /* Without dithering, every frame is the same...
+     */
+    RgbFloat const colour { 100.25f / 255.f, 0.f, 0.f };
+    for (auto n = 0; n < 8; ++n) {
+        rgbctl_rgb_value out {};
+        rounded.apply({ &colour, 1 }, { &out, 1 });
+        EXPECT(out.red == 100);
+    }
+}
+
+auto should_clamp_out_of_range() -> void
+{
+    OutputStage stage;
+    auto const nan = std::numeric_limits<float>::quiet_NaN();
+
+    EXPECT(is_rgb(convert(stage, { -1.f, 2.f, nan }), 0x00, 0xff, 0x00));
+}
+
+auto should_convert_no_more_than_fits() -> void
+{
+    OutputStage stage;
+    std::array<RgbFloat, 4> colours {};
+    std::array<rgbctl_rgb_value, 2> out {};
+
+    EXPECT(stage.apply(colours, out) == 2);
+}
+
+auto should_reject_bad_channel_order() -> void
+{
+    EXPECT_THROWS((OutputStage { {}, static_cast<rgbctl_channel_order>(7) }),
+                  std::invalid_argument);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_round_trip_every_byte),
+        TEST(should_apply_channel_order),
+        TEST(should_cap_brightness_and_balance_white),
+        TEST(should_apply_gamma),
+        TEST(should_dither_over_frames),
+        TEST(should_start_dithering_from_rounded),
+        TEST(should_clamp_out_of_range),
+        TEST(should_convert_no_more_than_fits),
+        TEST(should_reject_bad_channel_order),
+    });
+}
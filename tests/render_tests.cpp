@@ -0,0 +1,124 @@
+#include "rgbctl/rgbctl.hpp"
+#include "rgbctl/render.hpp"
+#include "testing.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/* Fills its zone with the simulated time it's seen, so frames can be
+ * told apart...
+ */
+struct ClockEffect
+{
+    std::size_t elapsed_ms = 0;
+
+    auto zone_index() const noexcept -> std::size_t
+    {
+        return 0;
+    }
+
+    auto rgb_count() const noexcept -> std::size_t
+    {
+        return 2;
+    }
+
+    auto duration() const noexcept -> std::size_t
+    {
+        return 0;
+    }
+
+    auto remaining() const noexcept -> std::size_t
+    {
+        return 0;
+    }
+
+    auto tick(std::size_t ms, std::span<rgbctl::RgbFloat> out_frame)
+        -> std::size_t
+    {
+        elapsed_ms += ms;
+        auto const n = std::min(out_frame.size(), rgb_count());
+        for (std::size_t i = 0; i < n; ++i)
+            out_frame[i] = { static_cast<float>(elapsed_ms) / 255.f,
+                             static_cast<float>(i) / 255.f,
+                             1.f };
+        return n;
+    }
+};
+
+auto make_zones() -> std::vector<rgbctl::RenderZone>
+{
+    std::vector<rgbctl::RenderZone> zones;
+    zones.push_back({ rgbctl::AnyEffect { ClockEffect {} }, 2 });
+    zones.push_back({ rgbctl::AnyEffect { ClockEffect {} }, 3 });
+    return zones;
+}
+
+auto should_render_raw_frames() -> void
+{
+    auto zones = make_zones();
+    std::ostringstream out;
+    auto const stats = rgbctl::render(
+        zones, { .duration = 100ms, .frame_period = 10ms }, out);
+
+    EXPECT(stats.frames == 10);
+
+    auto const bytes = out.str();
+    EXPECT(bytes.size() == 10 * 5 * 3);
+
+    /* Frame 3: zone 0's LEDs, zone 1's LEDs, then zone 1's last LED,
+     * which its effect doesn't fill...
+     */
+    auto const* frame = bytes.data() + 2 * 5 * 3;
+    EXPECT(frame[0] == 30 && frame[1] == 0 && frame[2] == '\xff');
+    EXPECT(frame[3] == 30 && frame[4] == 1 && frame[5] == '\xff');
+    EXPECT(frame[6] == 30 && frame[7] == 0 && frame[8] == '\xff');
+    EXPECT(frame[9] == 30 && frame[10] == 1 && frame[11] == '\xff');
+    EXPECT(frame[12] == 0 && frame[13] == 0 && frame[14] == 0);
+}
+
+auto should_render_ppm_strip() -> void
+{
+    auto zones = make_zones();
+    std::ostringstream out;
+    rgbctl::render(zones,
+                   { .duration = 1s,
+                     .frame_period = 33ms,
+                     .format = rgbctl::RenderFormat::Ppm },
+                   out);
+
+    std::string const header = "P6\n5 30\n255\n";
+    auto const bytes = out.str();
+    EXPECT(bytes.starts_with(header));
+    EXPECT(bytes.size() == header.size() + 30 * 5 * 3);
+}
+
+auto should_render_builtin_effect() -> void
+{
+    std::vector<rgbctl::RgbFloat> texture(4);
+    rgbctl::hex_string_to_rgb_float("3f00ff", texture[3]);
+
+    std::vector<rgbctl::RenderZone> zones;
+    zones.push_back(
+        { rgbctl::AnyEffect { rgbctl::effects::Rotate { 0, 5000, texture } },
+          16 });
+
+    std::ostringstream out;
+    auto const stats
+        = rgbctl::render(zones, { .duration = 5s, .frame_period = 33ms }, out);
+
+    EXPECT(stats.frames == 151);
+    EXPECT(stats.frames_per_second() > 0.0);
+    EXPECT(out.str().size() == 151 * 16 * 3);
+    EXPECT(out.str().find_first_not_of('\0') != std::string::npos);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_render_raw_frames),
+        TEST(should_render_ppm_strip),
+        TEST(should_render_builtin_effect),
+    });
+}
@@ -1,111 +1,21 @@
-#include "rgbctl/rgb.hpp"
+#include "rgbctl/rgbctl.hpp"
 #include "testing.hpp"
 #include <array>
-#include <cassert>
-#include <iterator>
-#include <span>
+#include <cmath>
+#include <stdexcept>
 #include <vector>
 
 using rgbctl::hex_string_to_rgb_float;
+using rgbctl::Resampler;
+using rgbctl::Resampling;
 using rgbctl::RgbFloat;
 
-namespace rgbctl
+auto is_close(RgbFloat const& a, RgbFloat const& b) noexcept -> bool
 {
-
-template <typename InputIt>
-struct ResolutionScaler
-{
-    ResolutionScaler(InputIt first,
-                     InputIt last,
-                     std::size_t target_size) noexcept
-        : input_first_ { first }
-        , input_last_ { last }
-        , target_size_ { target_size }
-        , factor_ { static_cast<float>(std::distance(input_first_, input_last_))
-                    / static_cast<float>(target_size_) }
-    {
-        assert(target_size_);
-    }
-
-    struct ScalingIterator
-    {
-        using iterator_category = std::forward_iterator_tag;
-        using difference_type = std::ptrdiff_t;
-        using value_type
-            = std::remove_reference_t<decltype(*std::declval<InputIt>())>;
-        using pointer = value_type*;
-        using reference = value_type&;
-
-        auto operator++() noexcept -> ScalingIterator&
-        {
-            ++current_;
-            return *this;
-        }
-
-        auto operator++(int) noexcept -> ScalingIterator
-        {
-            auto tmp { *this };
-            ++(*this);
-            return tmp;
-        }
-
-        auto operator*() noexcept
-            -> std::remove_reference_t<decltype(*std::declval<InputIt>())>&
-        {
-            auto pos = std::next(parent_->input_first_,
-                                 static_cast<std::ptrdiff_t>(
-                                     float(current_) * parent_->factor_));
-            assert(pos != parent_->input_last_);
-            return *pos;
-        }
-
-        auto operator->() noexcept
-            -> std::remove_reference_t<decltype(*std::declval<InputIt>())>*
-        {
-            return &*(*this);
-        }
-
-        friend auto operator==(ScalingIterator const& lhs,
-                               ScalingIterator const& rhs) noexcept
-        {
-            return lhs.current_ == rhs.current_;
-        }
-
-        friend auto operator!=(ScalingIterator const& lhs,
-                               ScalingIterator const& rhs) noexcept
-        {
-            return !(lhs == rhs);
-        }
-
-        ResolutionScaler* parent_;
-        std::size_t current_;
-    };
-
-    auto begin() noexcept -> ScalingIterator
-    {
-        return { this, 0 };
-    }
-
-    auto end() noexcept -> ScalingIterator
-    {
-        return { this, target_size_ };
-    }
-
-private:
-    InputIt input_first_;
-    InputIt input_last_;
-    std::size_t target_size_;
-    float factor_;
-};
-
-template <typename InputIt>
-auto resolution_scaler(InputIt first, InputIt last, std::size_t target_size)
-{
-    return ResolutionScaler<InputIt> { first, last, target_size };
+    return std::abs(a[0] - b[0]) < 1e-5f && std::abs(a[1] - b[1]) < 1e-5f
+           && std::abs(a[2] - b[2]) < 1e-5f;
 }
 
-} // namespace rgbctl
-
 auto should_scale_down() -> void
 {
     std::array<RgbFloat, 8> from {};
@@ -120,13 +30,24 @@ auto should_scale_down() -> void
     EXPECT(hex_string_to_rgb_float("ff0000", *pos++));
     EXPECT(hex_string_to_rgb_float("00ff00", *pos++));
 
-    std::vector<RgbFloat> to;
-
-    auto scaler = rgbctl::resolution_scaler(begin(from), pos, 3);
-
-    std::copy(std::begin(scaler), std::end(scaler), std::back_inserter(to));
+    std::vector<RgbFloat> to(3);
+    for (auto resampling :
+         { Resampling::Nearest, Resampling::Linear, Resampling::Area }) {
+        Resampler const resampler { from.size(), to.size(), resampling };
+        EXPECT(resampler.apply(from, to) == 3);
+    }
 
-    EXPECT(to.size() == 3);
+    /* Each LED covers 8/3 of the source...
+     */
+    Resampler const area { from.size(), to.size(), Resampling::Area };
+    area.apply(from, to);
+    EXPECT(is_close(to[0], { .75f, .25f, 0.f }));
+
+    Resampler const nearest { from.size(), to.size(), Resampling::Nearest };
+    nearest.apply(from, to);
+    EXPECT(is_close(to[0], from[1]));
+    EXPECT(is_close(to[1], from[4]));
+    EXPECT(is_close(to[2], from[6]));
 }
 
 auto should_scale_up() -> void
@@ -136,13 +57,66 @@ auto should_scale_up() -> void
 
     EXPECT(hex_string_to_rgb_float("ff0000", *pos++));
 
-    std::vector<RgbFloat> to;
+    std::vector<RgbFloat> to(16);
+    for (auto resampling :
+         { Resampling::Nearest, Resampling::Linear, Resampling::Area }) {
+        Resampler const resampler { from.size(), to.size(), resampling };
+        EXPECT(resampler.apply(from, to) == 16);
+        for (auto const& led : to)
+            EXPECT(is_close(led, from[0]));
+    }
+}
 
-    auto scaler = rgbctl::resolution_scaler(begin(from), pos, 16);
+auto should_blend_linearly() -> void
+{
+    std::array<RgbFloat, 2> const from { { { 0.f, 0.f, 0.f },
+                                           { 1.f, 1.f, 1.f } } };
+    std::array<RgbFloat, 4> to {};
+
+    Resampler const resampler { from.size(), to.size(), Resampling::Linear };
+    resampler.apply(from, to);
+
+    /* The ends are held rather than wrapped...
+     */
+    EXPECT(is_close(to[0], { 0.f, 0.f, 0.f }));
+    EXPECT(is_close(to[1], { .25f, .25f, .25f }));
+    EXPECT(is_close(to[2], { .75f, .75f, .75f }));
+    EXPECT(is_close(to[3], { 1.f, 1.f, 1.f }));
+}
+
+auto should_keep_brightness_when_averaging() -> void
+{
+    std::vector<RgbFloat> from;
+    for (int n = 0; n < 37; ++n) {
+        auto const v = static_cast<float>(n % 2);
+        from.push_back({ v, 1.f - v, .5f });
+    }
 
-    std::copy(std::begin(scaler), std::end(scaler), std::back_inserter(to));
+    std::vector<RgbFloat> to(5);
+    Resampler const resampler { from.size(), to.size(), Resampling::Area };
+    resampler.apply(from, to);
+
+    RgbFloat from_total { 0.f, 0.f, 0.f };
+    for (auto const& led : from)
+        from_total += led;
+
+    RgbFloat to_total { 0.f, 0.f, 0.f };
+    for (auto const& led : to)
+        to_total += led;
+
+    auto const ratio
+        = static_cast<float>(from.size()) / static_cast<float>(to.size());
+    EXPECT(std::abs(to_total[0] * ratio - from_total[0]) < 1e-4f);
+    EXPECT(std::abs(to_total[2] * ratio - from_total[2]) < 1e-4f);
+}
+
+auto should_reject_wrong_frame_size() -> void
+{
+    Resampler const resampler { 4, 2 };
+    std::array<RgbFloat, 3> from {};
+    std::array<RgbFloat, 2> to {};
 
-    EXPECT(to.size() == 16);
+    EXPECT_THROWS(resampler.apply(from, to), std::invalid_argument);
 }
 
 auto main() -> int
@@ -150,5 +124,8 @@ auto main() -> int
     return rgbctl::testing::run({
         TEST(should_scale_down),
         TEST(should_scale_up),
+        TEST(should_blend_linearly),
+        TEST(should_keep_brightness_when_averaging),
+        TEST(should_reject_wrong_frame_size),
     });
 }
@@ -0,0 +1,202 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+std::atomic_bool slow_shader_released = false;
+
+auto red_shader(rgbctl_shader_input const* in, rgbctl_rgb_float_value* out)
+    -> void
+{
+    for (std::uint32_t n = 0; n < in->count; ++n)
+        out[n] = { .red = 1.f, .green = 0.f, .blue = 0.f };
+}
+
+auto blue_shader(rgbctl_shader_input const* in, rgbctl_rgb_float_value* out)
+    -> void
+{
+    for (std::uint32_t n = 0; n < in->count; ++n)
+        out[n] = { .red = 0.f, .green = 0.f, .blue = 1.f };
+}
+
+/* Behaves like a shader stuck in a loop, until the test lets it go...
+ */
+auto slow_shader(rgbctl_shader_input const* in, rgbctl_rgb_float_value* out)
+    -> void
+{
+    while (!slow_shader_released)
+        std::this_thread::sleep_for(1ms);
+
+    blue_shader(in, out);
+}
+
+auto texture() -> std::shared_ptr<rgbctl::Texture const>
+{
+    std::array<rgbctl::RgbFloat, 1> const data {};
+    return std::make_shared<rgbctl::Texture const>(
+        std::span { data.data(), data.size() });
+}
+
+auto input(rgbctl::Texture const& texture) -> rgbctl_shader_input
+{
+    static std::array<float, 4> const uv {};
+
+    return { .u = uv.data(),
+             .v = uv.data(),
+             .count = static_cast<std::uint32_t>(uv.size()),
+             .stage = 0.f,
+             .elapsed_ms = 0,
+             .texture = &texture };
+}
+
+auto is_rgb(rgbctl::RgbFloat const& colour,
+            std::uint8_t r,
+            std::uint8_t g,
+            std::uint8_t b) noexcept -> bool
+{
+    auto const val = rgbctl::to_rgb_uint8(colour);
+    return val.red == r && val.green == g && val.blue == b;
+}
+
+auto should_run_shader_within_budget() -> void
+{
+    rgbctl::ShaderWatchdog watchdog { { .per_frame = 1s, .max_overruns = 1 } };
+
+    auto const tex = texture();
+    std::array<rgbctl_rgb_float_value, 4> out {};
+    EXPECT(watchdog.run(
+        { red_shader, nullptr }, input(*tex), tex, { out.data(), out.size() }));
+
+    EXPECT(out[3].red == 1.f);
+    EXPECT(!watchdog.demoted());
+    EXPECT(watchdog.timings().frames == 1);
+    EXPECT(watchdog.timings().overruns == 0);
+}
+
+auto should_run_shader_inline_without_budget() -> void
+{
+    rgbctl::ShaderWatchdog watchdog { {} };
+
+    auto const tex = texture();
+    std::array<rgbctl_rgb_float_value, 4> out {};
+    EXPECT(watchdog.run(
+        { red_shader, nullptr }, input(*tex), tex, { out.data(), out.size() }));
+
+    EXPECT(out[0].red == 1.f);
+    EXPECT(watchdog.timings().frames == 1);
+}
+
+auto should_demote_overrunning_shader() -> void
+{
+    slow_shader_released = false;
+    rgbctl::ShaderWatchdog watchdog { { .per_frame = 50ms,
+                                        .max_overruns = 2 } };
+
+    auto const tex = texture();
+    std::array<rgbctl_rgb_float_value, 4> out {};
+    rgbctl::UserShader const slow { slow_shader, nullptr };
+
+    EXPECT(!watchdog.run(slow, input(*tex), tex, { out.data(), out.size() }));
+    EXPECT(!watchdog.demoted());
+    EXPECT(!watchdog.run(slow, input(*tex), tex, { out.data(), out.size() }));
+    EXPECT(watchdog.demoted());
+    EXPECT(watchdog.timings().overruns == 2);
+
+    /* A demoted shader isn't run at all, and never touches the output...
+     */
+    slow_shader_released = true;
+    EXPECT(!watchdog.run(slow, input(*tex), tex, { out.data(), out.size() }));
+    EXPECT(out[0].blue == 0.f);
+
+    watchdog.reset();
+    EXPECT(!watchdog.demoted());
+    EXPECT(watchdog.run(
+        { red_shader, nullptr }, input(*tex), tex, { out.data(), out.size() }));
+    EXPECT(out[0].red == 1.f);
+}
+
+auto should_keep_last_good_frame() -> void
+{
+    slow_shader_released = false;
+
+    std::array<rgbctl::RgbFloat, 1> const data {};
+    auto slot = std::make_shared<rgbctl::ShaderSlot>(
+        rgbctl::UserShader { red_shader, nullptr });
+    rgbctl::effects::User effect { 0,
+                                   1000,
+                                   slot,
+                                   { data.data(), data.size() },
+                                   { .per_frame = 50ms, .max_overruns = 1 } };
+
+    std::array<rgbctl::RgbFloat, 4> result {};
+    EXPECT(effect.tick(0, { result.data(), result.size() }) == result.size());
+    EXPECT(is_rgb(result[0], 0xff, 0x00, 0x00));
+
+    slot->publish({ slow_shader, nullptr });
+    EXPECT(effect.tick(10, { result.data(), result.size() }) == result.size());
+    EXPECT(is_rgb(result[0], 0xff, 0x00, 0x00));
+    EXPECT(effect.watchdog().demoted());
+
+    /* Replacing the shader gives it another chance...
+     */
+    slow_shader_released = true;
+    slot->publish({ blue_shader, nullptr });
+    EXPECT(effect.tick(10, { result.data(), result.size() }) == result.size());
+    EXPECT(is_rgb(result[0], 0x00, 0x00, 0xff));
+    EXPECT(!effect.watchdog().demoted());
+}
+
+auto should_bound_abandoned_workers() -> void
+{
+    /* Workers abandoned by earlier tests exit once their shader does...
+     */
+    while (rgbctl::ShaderWatchdog::abandoned_workers())
+        std::this_thread::sleep_for(1ms);
+
+    slow_shader_released = false;
+
+    auto const tex = texture();
+    std::array<rgbctl_rgb_float_value, 4> out {};
+    rgbctl::UserShader const slow { slow_shader, nullptr };
+    rgbctl::ShaderBudget const budget { .per_frame = 10ms, .max_overruns = 1 };
+
+    for (std::uint32_t n = 0; n < rgbctl::kMaxAbandonedShaderWorkers; ++n) {
+        rgbctl::ShaderWatchdog watchdog { budget };
+        EXPECT(!watchdog.run(
+            slow, input(*tex), tex, { out.data(), out.size() }));
+        EXPECT(watchdog.demoted());
+    }
+
+    EXPECT(rgbctl::ShaderWatchdog::abandoned_workers()
+           == rgbctl::kMaxAbandonedShaderWorkers);
+
+    /* Too many are stuck to start another, even for a good shader...
+     */
+    rgbctl::ShaderWatchdog watchdog { budget };
+    rgbctl::UserShader const red { red_shader, nullptr };
+    EXPECT(!watchdog.run(red, input(*tex), tex, { out.data(), out.size() }));
+    EXPECT(watchdog.demoted());
+
+    slow_shader_released = true;
+    while (rgbctl::ShaderWatchdog::abandoned_workers())
+        std::this_thread::sleep_for(1ms);
+
+    watchdog.reset();
+    EXPECT(watchdog.run(red, input(*tex), tex, { out.data(), out.size() }));
+    EXPECT(out[0].red == 1.f);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_run_shader_within_budget),
+        TEST(should_run_shader_inline_without_budget),
+        TEST(should_demote_overrunning_shader),
+        TEST(should_keep_last_good_frame),
+        TEST(should_bound_abandoned_workers),
+    });
+}
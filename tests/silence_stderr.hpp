@@ -0,0 +1,33 @@
+#ifndef RGBCTL_TESTS_SILENCE_STDERR_HPP_INCLUDED
+#define RGBCTL_TESTS_SILENCE_STDERR_HPP_INCLUDED
+
+#include <iostream>
+
+/* The builtin drivers log their acquisition to stderr, and leave their
+ * formatting behind. This discards the output, and puts the formatting
+ * back, for as long as it's alive...
+ */
+struct SilenceStderr
+{
+    SilenceStderr()
+        : format_ { nullptr }
+    {
+        format_.copyfmt(std::cerr);
+        previous_ = std::cerr.rdbuf(nullptr);
+    }
+
+    ~SilenceStderr()
+    {
+        std::cerr.rdbuf(previous_);
+        std::cerr.copyfmt(format_);
+    }
+
+    SilenceStderr(SilenceStderr const&) = delete;
+    auto operator=(SilenceStderr const&) -> SilenceStderr& = delete;
+
+private:
+    std::ios format_;
+    std::streambuf* previous_;
+};
+
+#endif // RGBCTL_TESTS_SILENCE_STDERR_HPP_INCLUDED
@@ -0,0 +1,129 @@
+#include "../src/builtin_modules.hpp"
+#include "../src/builtins/builtins.hpp"
+#include "rgbctl/rgbctl.hpp"
+#include "silence_stderr.hpp"
+#include "testing.hpp"
+#include <array>
+#include <chrono>
+
+using namespace rgbctl::modules::builtin;
+using rgbctl::SimulatedDeviceStream;
+using rgbctl::SimulatedProtocol;
+
+using Context = rgbctl::DeviceContext<SimulatedDeviceStream>;
+
+auto acquire(Context& ctx, rgbctl_product_id id) -> rgbctl::Module
+{
+    rgbctl_module_registration registration {};
+    EXPECT(rgbctl::modules::init(&registration) == RGBCTL_SUCCESS);
+
+    SilenceStderr silence;
+    return rgbctl::acquire_module(ctx, id, registration.acquire_callback);
+}
+
+auto should_drive_simulated_corsair() -> void
+{
+    Context ctx { SimulatedDeviceStream {
+        SimulatedProtocol::CorsairH100iProXt } };
+    auto mod = acquire(ctx, corsair::CorsairH100iProXt::product_id);
+    auto const zones = mod.query_zones(ctx);
+
+    std::array<rgbctl_rgb_value, 12> ring {};
+    ring.fill({ 0x10, 0x20, 0x30 });
+    for (auto n = 0; n < 40; ++n)
+        mod.send_rgb_data(ctx, 1, ring.data(), ring.size());
+    mod.release(ctx);
+
+    auto const& stats = ctx.stream().stats();
+    EXPECT(stats.reports == 43);
+    EXPECT(stats.frames == 40);
+    EXPECT(stats.checksum_errors == 0);
+    EXPECT(stats.sequence_errors == 0);
+    EXPECT(stats.protocol_errors == 0);
+    EXPECT(stats.bytes_read == 43 * sizeof(corsair::Response));
+
+    /* The driver sends colours as they're given. Its zones ask for red
+     * and blue to be swapped before they get that far...
+     */
+    EXPECT(zones[1].channel_order == RGBCTL_CHANNEL_ORDER_BGR);
+    auto const led = ctx.stream().leds()[4];
+    EXPECT(led.red == 0x10 && led.green == 0x20 && led.blue == 0x30);
+}
+
+auto should_drive_simulated_asus() -> void
+{
+    Context ctx { SimulatedDeviceStream { SimulatedProtocol::AsusX570 } };
+    auto mod = acquire(ctx, asus::AsusX570::product_id);
+
+    std::array<rgbctl_rgb_value, 4> const mainboard {
+        { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 10, 11, 12 } }
+    };
+    mod.send_rgb_data(ctx, 0, mainboard.data(), mainboard.size());
+    mod.release(ctx);
+
+    auto const& stats = ctx.stream().stats();
+    EXPECT(stats.reports == 4);
+    EXPECT(stats.frames == 1);
+    EXPECT(stats.protocol_errors == 0);
+
+    auto const leds = ctx.stream().leds();
+    EXPECT(leds.size() == 4);
+    EXPECT(leds[3].red == 10 && leds[3].green == 11 && leds[3].blue == 12);
+}
+
+auto should_count_bad_reports() -> void
+{
+    SimulatedDeviceStream stream { SimulatedProtocol::CorsairH100iProXt };
+
+    std::array<unsigned char, 65> report {};
+    report[1] = 0x3f;
+    report[2] = (1 << 3) | 0x04;
+    report[64] = 0xaa;
+
+    EXPECT(stream.write(report.data(), 60) == 60);
+    EXPECT(stream.stats().reports == 0);
+    EXPECT(stream.write(report.data() + 60, 5) == 5);
+    EXPECT(stream.write(report.data(), report.size()) == 65);
+
+    EXPECT(stream.stats().reports == 2);
+    EXPECT(stream.stats().checksum_errors == 2);
+    EXPECT(stream.stats().sequence_errors == 1);
+
+    std::array<unsigned char, 64> response {};
+    EXPECT(stream.read(response.data(), 64) == 64);
+    EXPECT(response[1] == report[2]);
+    EXPECT(stream.read(response.data(), 64) == 64);
+    EXPECT(stream.read(response.data(), 64) == -RGBCTL_ERR_READ);
+}
+
+auto should_limit_bandwidth_and_delay_responses() -> void
+{
+    using namespace std::chrono_literals;
+
+    SimulatedDeviceStream stream { SimulatedProtocol::CorsairH100iProXt,
+                                   { .response_latency = 5ms,
+                                     .bytes_per_second = 64'000 } };
+
+    std::array<unsigned char, 65> report {};
+    auto const start = std::chrono::steady_clock::now();
+    for (auto n = 0; n < 10; ++n)
+        EXPECT(stream.write(report.data(), 64) == 64);
+
+    EXPECT(std::chrono::steady_clock::now() - start >= 10ms);
+    EXPECT(stream.write(report.data(), 10) == 10);
+
+    for (auto n = 0; n < 10; ++n)
+        EXPECT(stream.read(report.data(), 64) == 64);
+
+    EXPECT(std::chrono::steady_clock::now() - start >= 15ms);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_drive_simulated_corsair),
+        TEST(should_drive_simulated_asus),
+        TEST(should_count_bad_reports),
+        TEST(should_limit_bandwidth_and_delay_responses),
+    });
+}
@@ -15,6 +15,20 @@
                 "Expectation not met: " STRINGIFY(cond) "\n  in " __FILE__ ":" STRINGIFY(__LINE__));         \
     }                                                                          \
     while (0)
+#define EXPECT_THROWS(expr, type)                                              \
+    do {                                                                       \
+        auto threw_ = false;                                                   \
+        try {                                                                  \
+            static_cast<void>(expr);                                           \
+        }                                                                      \
+        catch (type const&) {                                                  \
+            threw_ = true;                                                     \
+        }                                                                      \
+        if (!threw_)                                                           \
+            throw ::rgbctl::testing::TestFailure(                              \
+                "Expected " STRINGIFY(type) " from: " STRINGIFY(expr) "\n  in " __FILE__ ":" STRINGIFY(__LINE__)); \
+    }                                                                          \
+    while (0)
 #define IGNORE(fn, reason)                                                     \
     std::make_pair(                                                            \
         STRINGIFY(fn), []() { throw ::rgbctl::testing::TestIgnored(reason); })
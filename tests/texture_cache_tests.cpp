@@ -0,0 +1,161 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using rgbctl::ColourSpace;
+using rgbctl::Mipmaps;
+using rgbctl::RgbFloat;
+using rgbctl::TextureCache;
+
+std::array<RgbFloat, 4> const kTexels { RgbFloat { 0.f, 0.f, 0.f },
+                                        RgbFloat { 1.f, 0.f, 0.f },
+                                        RgbFloat { 0.f, 1.f, 0.f },
+                                        RgbFloat { 0.f, 0.f, 1.f } };
+
+auto should_share_identical_textures() -> void
+{
+    TextureCache cache;
+
+    /* Equal content, from different storage...
+     */
+    std::vector<RgbFloat> const copy { kTexels.begin(), kTexels.end() };
+    auto const a = cache.get(kTexels);
+    auto const b = cache.get(copy);
+    auto const c = cache.get(kTexels, kTexels.size());
+
+    EXPECT(a == b);
+    EXPECT(a == c);
+    EXPECT(cache.size() == 1);
+}
+
+auto should_keep_different_textures_apart() -> void
+{
+    TextureCache cache;
+
+    auto changed = kTexels;
+    changed[3] = { 0.f, 0.f, .5f };
+
+    auto const texture = cache.get(kTexels);
+    EXPECT(cache.get(changed) != texture);
+    EXPECT(cache.get(kTexels, 2) != texture);
+    EXPECT(cache.get(kTexels, 4, ColourSpace::Oklab) != texture);
+    EXPECT(cache.get(kTexels, 4, ColourSpace::Srgb, Mipmaps::Box) != texture);
+
+    EXPECT(cache.get(kTexels, 2)->height() == 2);
+}
+
+auto should_free_unused_textures() -> void
+{
+    TextureCache cache;
+
+    std::weak_ptr<rgbctl::Texture const> weak = cache.get(kTexels);
+    EXPECT(weak.expired());
+    EXPECT(cache.size() == 0);
+
+    auto const texture = cache.get(kTexels);
+    EXPECT(texture);
+    EXPECT(cache.size() == 1);
+}
+
+auto should_reject_bad_dimensions() -> void
+{
+    TextureCache cache;
+
+    EXPECT_THROWS(cache.get(std::span<RgbFloat const> {}),
+                  std::invalid_argument);
+    EXPECT_THROWS(cache.get(kTexels, 0), std::invalid_argument);
+    EXPECT_THROWS(cache.get(kTexels, 3), std::invalid_argument);
+    EXPECT(cache.size() == 0);
+}
+
+auto should_share_between_effects() -> void
+{
+    TextureCache cache;
+
+    /* Effects keep the texture alive, not the caller...
+     */
+    rgbctl::effects::Rotate const first { 0, 5000, cache.get(kTexels) };
+    rgbctl::effects::Rotate const second { 1, 5000, cache.get(kTexels) };
+    rgbctl::effects::Linear const third { 2, 5000, cache.get(kTexels) };
+
+    EXPECT(first.rgb_count() == kTexels.size());
+    EXPECT(second.rgb_count() == kTexels.size());
+    EXPECT(third.rgb_count() == kTexels.size());
+    EXPECT(cache.size() == 1);
+}
+
+auto should_share_texture_files() -> void
+{
+    auto const path = fs::temp_directory_path()
+                      / ("rgbctl_texture_cache_tests."
+                         + std::to_string(getpid()));
+    rgbctl::write_texture_file(path, kTexels, kTexels.size());
+    auto const file = std::make_shared<rgbctl::TextureFile const>(path);
+    fs::remove(path);
+
+    TextureCache cache;
+    auto const texture = cache.get(file);
+    EXPECT(cache.get(file) == texture);
+    EXPECT(cache.get(kTexels) == texture);
+}
+
+auto should_release_texture_files() -> void
+{
+    auto const path = fs::temp_directory_path()
+                      / ("rgbctl_texture_cache_tests.release."
+                         + std::to_string(getpid()));
+    rgbctl::write_texture_file(path, kTexels, kTexels.size());
+    auto file = std::make_shared<rgbctl::TextureFile const>(path);
+    fs::remove(path);
+
+    /* Converted, so the texture itself doesn't need the file...
+     */
+    TextureCache cache;
+    std::weak_ptr<rgbctl::TextureFile const> const weak = file;
+    auto texture = cache.get(std::move(file), ColourSpace::Oklab);
+    EXPECT(!weak.expired());
+
+    texture.reset();
+    EXPECT(weak.expired());
+}
+
+auto should_share_across_threads() -> void
+{
+    TextureCache cache;
+
+    std::array<std::shared_ptr<rgbctl::Texture const>, 8> textures {};
+    std::vector<std::thread> threads;
+    for (auto& texture : textures)
+        threads.emplace_back([&] {
+            texture = cache.get(kTexels, 4, ColourSpace::Oklab, Mipmaps::Box);
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto const& texture : textures)
+        EXPECT(texture == textures[0]);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_share_identical_textures),
+        TEST(should_keep_different_textures_apart),
+        TEST(should_free_unused_textures),
+        TEST(should_reject_bad_dimensions),
+        TEST(should_share_between_effects),
+        TEST(should_share_texture_files),
+        TEST(should_release_texture_files),
+        TEST(should_share_across_threads),
+    });
+}
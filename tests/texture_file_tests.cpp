@@ -0,0 +1,150 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include "texture_testing.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace fs = std::filesystem;
+
+using rgbctl::RgbFloat;
+using rgbctl::TexelFormat;
+using rgbctl::Texture;
+using rgbctl::TextureFile;
+
+std::array<RgbFloat, 6> const kTexels { RgbFloat { 0.f, 0.f, 0.f },
+                                        RgbFloat { 1.f, 0.f, 0.f },
+                                        RgbFloat { 0.f, 1.f, 0.f },
+                                        RgbFloat { 0.f, 0.f, 1.f },
+                                        RgbFloat { .2f, .4f, .6f },
+                                        RgbFloat { 1.f, 1.f, 1.f } };
+
+/* The largest difference between sampling `a` and `b` across both
+ * rows...
+ */
+auto max_sample_difference(Texture const& a, Texture const& b) -> float
+{
+    auto difference = 0.f;
+    for (auto n = 0; n < 64; ++n) {
+        rgbctl::Vec<float, 2> const uv { static_cast<float>(n) / 48.f,
+                                         static_cast<float>(n % 4) / 4.f };
+        difference = std::max(
+            { difference,
+              max_difference(a.sample(uv, rgbctl::texture_filtering_nearest),
+                             b.sample(uv, rgbctl::texture_filtering_nearest)),
+              max_difference(a.sample(uv, rgbctl::texture_filtering_linear),
+                             b.sample(uv, rgbctl::texture_filtering_linear)) });
+    }
+
+    return difference;
+}
+
+auto load(std::string const& name, TexelFormat format)
+    -> std::shared_ptr<TextureFile const>
+{
+    auto const path = temporary_path("texture_file_tests", name);
+    rgbctl::write_texture_file(path, kTexels, 3, format);
+    auto file = std::make_shared<TextureFile const>(path);
+    fs::remove(path);
+
+    return file;
+}
+
+auto should_map_float_texels() -> void
+{
+    auto const file = load("float", TexelFormat::Float);
+    EXPECT(file->width() == 3);
+    EXPECT(file->height() == 2);
+    EXPECT(file->format() == TexelFormat::Float);
+    EXPECT(file->bytes().empty());
+    EXPECT(file->texels().size() == kTexels.size());
+
+    for (std::size_t n = 0; n < kTexels.size(); ++n)
+        EXPECT(max_difference(file->texels()[n], kTexels[n]) == 0.f);
+}
+
+auto should_round_byte_texels() -> void
+{
+    auto const file = load("bytes", TexelFormat::Uint8);
+    EXPECT(file->format() == TexelFormat::Uint8);
+    EXPECT(file->texels().empty());
+    EXPECT(file->bytes().size() == kTexels.size());
+
+    auto const& texel = file->bytes()[4];
+    EXPECT(texel[0] == 51);
+    EXPECT(texel[1] == 102);
+    EXPECT(texel[2] == 153);
+}
+
+auto should_sample_mapped_texels_in_place() -> void
+{
+    Texture const expected { kTexels, 3 };
+
+    Texture const floats { load("sample_float", TexelFormat::Float) };
+    EXPECT(floats.width() == 3);
+    EXPECT(floats.height() == 2);
+    EXPECT(max_sample_difference(floats, expected) == 0.f);
+
+    Texture const bytes { load("sample_bytes", TexelFormat::Uint8) };
+    EXPECT(max_sample_difference(bytes, expected) <= .5f / 255.f);
+}
+
+auto should_convert_mapped_texels() -> void
+{
+    Texture const expected { kTexels,
+                             3,
+                             rgbctl::ColourSpace::Oklab,
+                             rgbctl::Mipmaps::Box };
+    Texture const texture { load("convert", TexelFormat::Float),
+                            rgbctl::ColourSpace::Oklab,
+                            rgbctl::Mipmaps::Box };
+
+    EXPECT(texture.levels() == expected.levels());
+    EXPECT(max_sample_difference(texture, expected) == 0.f);
+}
+
+auto should_reject_bad_files() -> void
+{
+    auto const rejects = [](std::string const& name, auto&& write) {
+        auto const path = temporary_path("texture_file_tests", name);
+        {
+            std::ofstream file { path, std::ios::binary };
+            write(file);
+        }
+
+        EXPECT_THROWS(TextureFile { path }, std::runtime_error);
+        fs::remove(path);
+    };
+
+    rejects("magic", [](auto& file) {
+        file << "RGBCTLT\x01" << std::string(16, '\0');
+    });
+
+    rejects("truncated", [](auto& file) {
+        file.write(reinterpret_cast<char const*>(rgbctl::kTextureFileMagic),
+                   sizeof(rgbctl::kTextureFileMagic));
+        file.put(2).write("\0\0\0", 3).put(1).write("\0\0\0", 3);
+        file.put(static_cast<char>(TexelFormat::Uint8));
+        file << std::string(7 + 5, '\0');
+    });
+
+    EXPECT_THROWS(
+        TextureFile { temporary_path("texture_file_tests", "missing") },
+        std::system_error);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_map_float_texels),
+        TEST(should_round_byte_texels),
+        TEST(should_sample_mapped_texels_in_place),
+        TEST(should_convert_mapped_texels),
+        TEST(should_reject_bad_files),
+    });
+}
@@ -0,0 +1,202 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include "texture_testing.hpp"
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using rgbctl::RgbFloat;
+using rgbctl::TexelFormat;
+using rgbctl::TextureStream;
+
+std::size_t constexpr kFrames = 5;
+
+/* An animation of 2x1 frames, frame `n` all `n / 10` grey...
+ */
+auto write_animation(fs::path const& path,
+                     TexelFormat format = TexelFormat::Float) -> void
+{
+    std::vector<RgbFloat> texels;
+    for (std::size_t n = 0; n < kFrames; ++n) {
+        auto const v = static_cast<float>(n) / 10.f;
+        texels.insert(texels.end(), 2, RgbFloat { v, v, v });
+    }
+
+    rgbctl::write_texture_file(path, texels, 2, format, kFrames);
+}
+
+/* Which frame of the animation `texture` is...
+ */
+auto frame_of(rgbctl::Texture const& texture) -> std::size_t
+{
+    auto const texel
+        = texture.sample({ 0.f, 0.f }, rgbctl::texture_filtering_nearest);
+    return static_cast<std::size_t>(std::lround(texel[0] * 10.f));
+}
+
+/* Asks for `frame` until the reader has caught up with it...
+ */
+auto wait_for(TextureStream& stream, std::size_t frame) -> std::size_t
+{
+    using namespace std::chrono_literals;
+
+    auto const until = std::chrono::steady_clock::now() + 1s;
+    auto texture = stream.frame(frame);
+    while (frame_of(*texture) != frame % kFrames
+           && std::chrono::steady_clock::now() < until) {
+        std::this_thread::sleep_for(1ms);
+        texture = stream.frame(frame);
+    }
+
+    return frame_of(*texture);
+}
+
+/* Waits until the reader has `count` frames read ahead...
+ */
+auto wait_for_buffered(TextureStream const& stream, std::size_t count)
+    -> std::size_t
+{
+    using namespace std::chrono_literals;
+
+    auto const until = std::chrono::steady_clock::now() + 1s;
+    while (stream.buffered() != count
+           && std::chrono::steady_clock::now() < until)
+        std::this_thread::sleep_for(1ms);
+
+    return stream.buffered();
+}
+
+auto should_play_frames_in_order() -> void
+{
+    auto const path = temporary_path("texture_stream_tests", "play");
+    write_animation(path, TexelFormat::Uint8);
+    TextureStream stream { path };
+    fs::remove(path);
+
+    EXPECT(stream.width() == 2);
+    EXPECT(stream.height() == 1);
+    EXPECT(stream.frames() == kFrames);
+
+    /* ...looping back to the start...
+     */
+    for (std::size_t n = 0; n < kFrames * 2 + 1; ++n)
+        EXPECT(wait_for(stream, n) == n % kFrames);
+}
+
+auto should_bound_read_ahead() -> void
+{
+    auto const path = temporary_path("texture_stream_tests", "bound");
+    write_animation(path);
+    TextureStream stream { path, rgbctl::ColourSpace::Srgb,
+                           rgbctl::Mipmaps::None, 2 };
+    fs::remove(path);
+
+    EXPECT(frame_of(*stream.frame(0)) == 0);
+    EXPECT(wait_for_buffered(stream, 2) == 2);
+
+    EXPECT(frame_of(*stream.frame(2)) == 2);
+    EXPECT(wait_for_buffered(stream, 2) == 2);
+    EXPECT(stream.late() == 0);
+}
+
+auto should_skip_ahead_when_late() -> void
+{
+    auto const path = temporary_path("texture_stream_tests", "late");
+    write_animation(path);
+    TextureStream stream { path, rgbctl::ColourSpace::Srgb,
+                           rgbctl::Mipmaps::None, 2 };
+    fs::remove(path);
+
+    stream.frame(0);
+    EXPECT(wait_for_buffered(stream, 2) == 2);
+
+    /* Only frames 1 and 2 have been read ahead, so 2 is shown late...
+     */
+    EXPECT(frame_of(*stream.frame(1003)) == 2);
+    EXPECT(stream.late() == 1);
+
+    EXPECT(wait_for(stream, 1003) == 3);
+    EXPECT(wait_for(stream, 1004) == 4);
+}
+
+auto should_restart_when_seeking_back() -> void
+{
+    auto const path = temporary_path("texture_stream_tests", "seek");
+    write_animation(path);
+    TextureStream stream { path };
+    fs::remove(path);
+
+    EXPECT(wait_for(stream, 4) == 4);
+    EXPECT(frame_of(*stream.frame(1)) == 1);
+    EXPECT(wait_for(stream, 2) == 2);
+}
+
+auto should_play_across_a_zone() -> void
+{
+    auto const path = temporary_path("texture_stream_tests", "effect");
+    write_animation(path);
+    auto stream = std::make_shared<TextureStream>(path);
+    fs::remove(path);
+
+    rgbctl::effects::Animation animation { 0, stream, 10 };
+    EXPECT(animation.rgb_count() == 2);
+    EXPECT(animation.duration() == 50);
+
+    std::vector<RgbFloat> frame(3);
+    EXPECT(animation.tick(0, frame) == 3);
+    EXPECT(frame[0][0] == 0.f);
+
+    wait_for(*stream, 1);
+    EXPECT(animation.tick(10, frame) == 3);
+    EXPECT(std::abs(frame[0][0] - .1f) < 1e-6f);
+    EXPECT(std::abs(frame[2][0] - .1f) < 1e-6f);
+    EXPECT(animation.remaining() == 40);
+}
+
+auto should_reject_bad_files() -> void
+{
+    auto const rejects = [](fs::path const& path) {
+        EXPECT_THROWS(TextureStream { path }, std::runtime_error);
+        fs::remove(path);
+    };
+
+    auto const truncated = temporary_path("texture_stream_tests", "bad");
+    write_animation(truncated);
+    fs::resize_file(truncated, fs::file_size(truncated) - 1);
+    rejects(truncated);
+
+    /* 2^30 frames of 65536x65536 float texels, which is 3 * 2^64 bytes,
+     * or none at all if the length wraps...
+     */
+    auto const wrapped = temporary_path("texture_stream_tests", "wrapped");
+    {
+        std::ofstream file { wrapped, std::ios::binary };
+        file.write(reinterpret_cast<char const*>(rgbctl::kTextureFileMagic),
+                   sizeof(rgbctl::kTextureFileMagic));
+        file.write("\0\0\1\0\0\0\1\0", 8);
+        file.put(static_cast<char>(TexelFormat::Float)).write("\0\0\0", 3);
+        file.write("\0\0\0\x40", 4);
+    }
+    EXPECT(fs::file_size(wrapped) == rgbctl::kTextureFileHeaderSize);
+    rejects(wrapped);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_play_frames_in_order),
+        TEST(should_bound_read_ahead),
+        TEST(should_skip_ahead_when_late),
+        TEST(should_restart_when_seeking_back),
+        TEST(should_play_across_a_zone),
+        TEST(should_reject_bad_files),
+    });
+}
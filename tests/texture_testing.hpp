@@ -0,0 +1,31 @@
+#ifndef RGBCTL_TESTS_TEXTURE_TESTING_HPP_INCLUDED
+#define RGBCTL_TESTS_TEXTURE_TESTING_HPP_INCLUDED
+
+#include "rgbctl/rgb.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+
+/* The largest difference between any channel of `a` and `b`...
+ */
+inline auto max_difference(rgbctl::RgbFloat const& a,
+                           rgbctl::RgbFloat const& b) noexcept -> float
+{
+    return std::max({ std::abs(a[0] - b[0]),
+                      std::abs(a[1] - b[1]),
+                      std::abs(a[2] - b[2]) });
+}
+
+/* A path in the temporary directory for the file `name` of the test
+ * `test`, unique to this process...
+ */
+inline auto temporary_path(std::string const& test, std::string const& name)
+    -> std::filesystem::path
+{
+    return std::filesystem::temp_directory_path()
+           / ("rgbctl_" + test + "." + name + "." + std::to_string(getpid()));
+}
+
+#endif // RGBCTL_TESTS_TEXTURE_TESTING_HPP_INCLUDED
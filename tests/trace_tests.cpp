@@ -0,0 +1,77 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include <sstream>
+#include <string>
+#include <thread>
+
+auto occurrences(std::string const& text, std::string const& what)
+    -> std::size_t
+{
+    std::size_t count = 0;
+    for (auto pos = text.find(what); pos != std::string::npos;
+         pos = text.find(what, pos + what.size()))
+        ++count;
+
+    return count;
+}
+
+auto trace_json() -> std::string
+{
+    std::ostringstream json;
+    rgbctl::trace::write_json(json);
+    return json.str();
+}
+
+auto should_not_record_until_enabled() -> void
+{
+    {
+        RGBCTL_TRACE_SCOPE("disabled");
+    }
+
+    EXPECT(!rgbctl::trace::enabled());
+    EXPECT(trace_json().find("disabled") == std::string::npos);
+}
+
+auto should_record_scopes_per_thread() -> void
+{
+    rgbctl::trace::enable(8);
+    EXPECT(rgbctl::trace::enabled());
+
+    auto record = [] {
+        RGBCTL_TRACE_SCOPE("outer");
+        RGBCTL_TRACE_SCOPE("inner");
+    };
+
+    std::thread { record }.join();
+    std::thread { record }.join();
+
+    auto const json = trace_json();
+    EXPECT(json.starts_with("{\"traceEvents\":["));
+    EXPECT(occurrences(json, "\"name\":\"outer\",\"ph\":\"X\"") == 2);
+    EXPECT(occurrences(json, "\"name\":\"inner\"") == 2);
+    EXPECT(json.find("\"tid\":1}") != std::string::npos);
+    EXPECT(json.find("\"tid\":2}") != std::string::npos);
+}
+
+auto should_keep_latest_events() -> void
+{
+    rgbctl::trace::enable(8);
+
+    std::thread { [] {
+        for (auto n = 0; n < 20; ++n)
+            rgbctl::trace::record("ring", 0, 1000);
+    } }.join();
+
+    auto const json = trace_json();
+    EXPECT(occurrences(json, "\"name\":\"ring\"") == 8);
+    EXPECT(json.find("\"dur\":1.000") != std::string::npos);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_not_record_until_enabled),
+        TEST(should_record_scopes_per_thread),
+        TEST(should_keep_latest_events),
+    });
+}
@@ -0,0 +1,242 @@
+#include "../src/builtin_modules.hpp"
+#include "../src/builtins/builtins.hpp"
+#include "mock_read_write_stream.hpp"
+#include "rgbctl/rgbctl.hpp"
+#include "silence_stderr.hpp"
+#include "testing.hpp"
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using rgbctl::TrafficDirection;
+
+auto log_path(std::string const& name) -> fs::path
+{
+    return fs::temp_directory_path()
+           / ("rgbctl_traffic_log_tests." + name + "."
+              + std::to_string(getpid()));
+}
+
+struct FailingStream
+{
+    auto read(unsigned char*, std::uint32_t) noexcept -> rgbctl_errno
+    {
+        return -RGBCTL_ERR_READ;
+    }
+
+    auto write(unsigned char const*, std::uint32_t) noexcept -> rgbctl_errno
+    {
+        return -RGBCTL_ERR_WRITE;
+    }
+};
+
+/* Acquires the builtin Asus driver and sends it one frame, through
+ * whatever stream `ctx` has...
+ */
+template <typename ReadWriteStream>
+auto drive_asus(rgbctl::DeviceContext<ReadWriteStream>& ctx,
+                std::uint8_t red) -> void
+{
+    rgbctl_module_registration registration {};
+    EXPECT(rgbctl::modules::init(&registration) == RGBCTL_SUCCESS);
+
+    auto mod = [&] {
+        SilenceStderr silence;
+        return rgbctl::acquire_module(
+            ctx,
+            rgbctl::modules::builtin::asus::AsusX570::product_id,
+            registration.acquire_callback);
+    }();
+
+    std::array<rgbctl_rgb_value, 4> frame {};
+    frame.fill({ red, 0x20, 0x30 });
+    mod.send_rgb_data(ctx, 0, frame.data(), frame.size());
+    mod.release(ctx);
+}
+
+auto record_asus(fs::path const& path,
+                 rgbctl::SimulatedDeviceLimits limits = {}) -> void
+{
+    rgbctl::DeviceContext ctx { rgbctl::RecordingStream {
+        rgbctl::SimulatedDeviceStream { rgbctl::SimulatedProtocol::AsusX570,
+                                        limits },
+        path } };
+
+    drive_asus(ctx, 0x10);
+}
+
+auto should_record_transfers() -> void
+{
+    auto const path = log_path("record");
+
+    std::array<unsigned char, 4> const read_buffer { 1, 2, 3, 4 };
+    std::array<unsigned char, 8> write_buffer {};
+    {
+        rgbctl::RecordingStream stream { MockReadWriteStream {
+                                             read_buffer, write_buffer },
+                                         path };
+
+        std::array<unsigned char, 5> data { 9, 8, 7, 6, 5 };
+        EXPECT(stream.write(data.data(), 5) == 5);
+        EXPECT(stream.read(data.data(), 5) == 4);
+    }
+
+    auto const records = rgbctl::read_traffic_log(path);
+    fs::remove(path);
+
+    EXPECT(records.size() == 2);
+    EXPECT(records[0].direction == TrafficDirection::Write);
+    EXPECT(records[0].requested == 5);
+    EXPECT(records[0].result == 5);
+    EXPECT((records[0].data == std::vector<unsigned char> { 9, 8, 7, 6, 5 }));
+    EXPECT(records[1].direction == TrafficDirection::Read);
+    EXPECT(records[1].requested == 5);
+    EXPECT(records[1].result == 4);
+    EXPECT((records[1].data == std::vector<unsigned char> { 1, 2, 3, 4 }));
+    EXPECT(records[1].start_ns >= records[0].start_ns);
+}
+
+auto should_record_failures() -> void
+{
+    auto const path = log_path("failures");
+    {
+        rgbctl::RecordingStream stream { FailingStream {}, path };
+        std::array<unsigned char, 4> data {};
+        EXPECT(stream.write(data.data(), 4) == -RGBCTL_ERR_WRITE);
+    }
+
+    auto const records = rgbctl::read_traffic_log(path);
+    fs::remove(path);
+
+    EXPECT(records.size() == 1);
+    EXPECT(records[0].result == -RGBCTL_ERR_WRITE);
+    EXPECT(records[0].data.empty());
+}
+
+auto should_replay_driver_traffic() -> void
+{
+    auto const path = log_path("replay");
+    record_asus(path);
+
+    rgbctl::DeviceContext ctx { rgbctl::ReplayStream {
+        rgbctl::read_traffic_log(path) } };
+    fs::remove(path);
+
+    drive_asus(ctx, 0x10);
+    EXPECT(ctx.stream().divergences() == 0);
+    EXPECT(ctx.stream().remaining() == 0);
+}
+
+auto should_count_divergences() -> void
+{
+    auto const path = log_path("diverge");
+    record_asus(path);
+
+    rgbctl::DeviceContext ctx { rgbctl::ReplayStream {
+        rgbctl::read_traffic_log(path) } };
+    fs::remove(path);
+
+    drive_asus(ctx, 0x11);
+    EXPECT(ctx.stream().divergences() == 1);
+
+    std::array<unsigned char, 4> data {};
+    EXPECT(ctx.stream().read(data.data(), 4) == -RGBCTL_ERR_READ);
+    EXPECT(ctx.stream().divergences() == 2);
+}
+
+auto should_compare_whole_writes() -> void
+{
+    std::vector<rgbctl::TrafficRecord> records;
+    for (auto n = 0; n < 3; ++n)
+        records.push_back({ .direction = TrafficDirection::Write,
+                            .start_ns = 0,
+                            .duration_ns = 0,
+                            .requested = 4,
+                            .result = 4,
+                            .data = { 1, 2, 3, 4 } });
+
+    rgbctl::ReplayStream stream { std::move(records) };
+    std::array<unsigned char, 5> const data { 1, 2, 3, 4, 5 };
+
+    EXPECT(stream.write(data.data(), 4) == 4);
+    EXPECT(stream.divergences() == 0);
+
+    /* Extra bytes on the end, or too few...
+     */
+    EXPECT(stream.write(data.data(), 5) == 4);
+    EXPECT(stream.divergences() == 1);
+    EXPECT(stream.write(data.data(), 3) == 4);
+    EXPECT(stream.divergences() == 2);
+}
+
+auto should_replay_short_writes() -> void
+{
+    auto const path = log_path("short");
+
+    std::array<unsigned char, 5> const data { 9, 8, 7, 6, 5 };
+    std::array<unsigned char, 3> write_buffer {};
+    {
+        rgbctl::RecordingStream stream { MockReadWriteStream {
+                                             {}, write_buffer },
+                                         path };
+        EXPECT(stream.write(data.data(), 5) == 3);
+    }
+
+    rgbctl::ReplayStream stream { rgbctl::read_traffic_log(path) };
+    fs::remove(path);
+
+    EXPECT(stream.write(data.data(), 5) == 3);
+    EXPECT(stream.divergences() == 0);
+}
+
+auto should_replay_with_recorded_timing() -> void
+{
+    using namespace std::chrono_literals;
+
+    auto const path = log_path("timing");
+    record_asus(path, { .response_latency = 5ms });
+
+    rgbctl::DeviceContext ctx { rgbctl::ReplayStream {
+        rgbctl::read_traffic_log(path), rgbctl::ReplayTiming::Recorded } };
+    fs::remove(path);
+
+    auto const start = std::chrono::steady_clock::now();
+    drive_asus(ctx, 0x10);
+    EXPECT(std::chrono::steady_clock::now() - start >= 10ms);
+    EXPECT(ctx.stream().divergences() == 0);
+}
+
+auto should_reject_truncated_log() -> void
+{
+    auto const path = log_path("truncated");
+    {
+        std::ofstream log { path, std::ios::binary };
+        log.write(reinterpret_cast<char const*>(rgbctl::kTrafficLogMagic),
+                  sizeof(rgbctl::kTrafficLogMagic));
+        log.put(static_cast<char>(TrafficDirection::Write));
+        log.put(0x01).put(0x01).put(0x05).put(0x05).put(0x01);
+    }
+
+    EXPECT_THROWS(rgbctl::read_traffic_log(path), std::runtime_error);
+    fs::remove(path);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_record_transfers),
+        TEST(should_record_failures),
+        TEST(should_replay_driver_traffic),
+        TEST(should_count_divergences),
+        TEST(should_compare_whole_writes),
+        TEST(should_replay_short_writes),
+        TEST(should_replay_with_recorded_timing),
+        TEST(should_reject_truncated_log),
+    });
+}
@@ -0,0 +1,333 @@
+#include "rgbctl/rgbctl.hpp"
+#include "testing.hpp"
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+auto constexpr kSampleShader = R"(
+#include <rgbctl/shader.h>
+
+void shade(struct rgbctl_shader_input const* in,
+           struct rgbctl_rgb_float_value* out)
+{
+    rgb_sample_texture_n(
+        in->texture, in->u, in->v, in->count, RGBCTL_SAMPLE_NEAREST, out);
+}
+)";
+
+auto constexpr kConstantShader = R"(
+#include <rgbctl/shader.h>
+
+void shade(struct rgbctl_shader_input const* in,
+           struct rgbctl_rgb_float_value* out)
+{
+    for (uint32_t i = 0; i < in->count; ++i) {
+        out[i].red = 1.f;
+        out[i].green = 0.f;
+        out[i].blue = 0.f;
+    }
+}
+)";
+
+auto texture_data() -> std::array<rgbctl::RgbFloat, 4>
+{
+    return { rgbctl::hex_string_to_rgb_float("ff0000"),
+             rgbctl::hex_string_to_rgb_float("00ff00"),
+             rgbctl::hex_string_to_rgb_float("0000ff"),
+             rgbctl::hex_string_to_rgb_float("ffffff") };
+}
+
+auto is_rgb(rgbctl::RgbFloat const& colour,
+            std::uint8_t r,
+            std::uint8_t g,
+            std::uint8_t b) noexcept -> bool
+{
+    auto const val = rgbctl::to_rgb_uint8(colour);
+    return val.red == r && val.green == g && val.blue == b;
+}
+
+auto should_sample_texture_n_like_single_samples() -> void
+{
+    auto const data = texture_data();
+    rgbctl::Texture texture { { data.data(), data.size() } };
+
+    std::array<float, 8> const x = { 0.f,  .1f, .25f, .4f,
+                                     .55f, .7f, .85f, 1.3f };
+    std::array<float, 8> const y {};
+    std::array<rgbctl_rgb_float_value, 8> out {};
+
+    for (auto filtering : { RGBCTL_SAMPLE_NEAREST, RGBCTL_SAMPLE_LINEAR }) {
+        rgb_sample_texture_n(&texture,
+                             x.data(),
+                             y.data(),
+                             rgbctl::narrow_cast<std::uint32_t>(x.size()),
+                             filtering,
+                             out.data());
+
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            auto const expected
+                = rgb_sample_texture(&texture, x[i], y[i], filtering);
+            EXPECT(out[i].red == expected.red);
+            EXPECT(out[i].green == expected.green);
+            EXPECT(out[i].blue == expected.blue);
+        }
+    }
+}
+
+auto should_run_shader_once_per_zone() -> void
+{
+    auto const data = texture_data();
+    rgbctl::effects::User effect { 0,
+                                   1000,
+                                   rgbctl::compile_user_shader(kSampleShader),
+                                   { data.data(), data.size() } };
+
+    std::array<rgbctl::RgbFloat, 4> result {};
+    EXPECT(effect.tick(0, { result.data(), result.size() }) == result.size());
+
+    EXPECT(is_rgb(result[0], 0xff, 0x00, 0x00));
+    EXPECT(is_rgb(result[1], 0x00, 0xff, 0x00));
+    EXPECT(is_rgb(result[2], 0x00, 0x00, 0xff));
+}
+
+auto should_resize_with_zone() -> void
+{
+    auto const data = texture_data();
+    rgbctl::effects::User effect { 0,
+                                   1000,
+                                   rgbctl::compile_user_shader(kConstantShader),
+                                   { data.data(), data.size() } };
+
+    std::array<rgbctl::RgbFloat, 4> small {};
+    std::array<rgbctl::RgbFloat, 12> large {};
+
+    EXPECT(effect.tick(10, { small.data(), small.size() }) == small.size());
+    EXPECT(effect.tick(10, { large.data(), large.size() }) == large.size());
+
+    for (auto const& rgb : large)
+        EXPECT(is_rgb(rgb, 0xff, 0x00, 0x00));
+}
+
+auto should_reject_zero_duration() -> void
+{
+    auto const data = texture_data();
+    auto shader = rgbctl::compile_user_shader(kConstantShader);
+
+    EXPECT_THROWS((rgbctl::effects::User { 0,
+                                           0,
+                                           std::move(shader),
+                                           { data.data(), data.size() } }),
+                  std::invalid_argument);
+}
+
+auto should_fail_to_compile_invalid_shader() -> void
+{
+    EXPECT_THROWS(rgbctl::compile_user_shader("void shade("),
+                  rgbctl::ShaderCompileError);
+}
+
+auto should_fail_without_entry_point() -> void
+{
+    EXPECT_THROWS(rgbctl::compile_user_shader("int not_a_shader;"),
+                  rgbctl::ShaderCompileError);
+}
+
+auto temporary_cache_directory() -> std::filesystem::path
+{
+    return std::filesystem::temp_directory_path()
+           / ("rgbctl_shader_cache_tests." + std::to_string(getpid()));
+}
+
+auto should_cache_compiled_shader() -> void
+{
+    auto const dir = temporary_cache_directory();
+    rgbctl::ShaderCache cache { dir };
+
+    EXPECT(!std::filesystem::exists(cache.path(kSampleShader)));
+    EXPECT(cache.load(kSampleShader));
+    EXPECT(std::filesystem::exists(cache.path(kSampleShader)));
+
+    /* Should be loaded from the cache this time...
+     */
+    auto const data = texture_data();
+    rgbctl::effects::User effect { 0,
+                                   1000,
+                                   cache.load(kSampleShader),
+                                   { data.data(), data.size() } };
+
+    std::array<rgbctl::RgbFloat, 4> result {};
+    EXPECT(effect.tick(0, { result.data(), result.size() }) == result.size());
+    EXPECT(is_rgb(result[0], 0xff, 0x00, 0x00));
+
+    std::filesystem::remove_all(dir);
+}
+
+auto should_key_cache_on_source() -> void
+{
+    auto const dir = temporary_cache_directory();
+    rgbctl::ShaderCache cache { dir };
+
+    EXPECT(cache.key(kSampleShader) == cache.key(kSampleShader));
+    EXPECT(cache.key(kSampleShader) != cache.key(kConstantShader));
+    EXPECT(cache.path(kSampleShader).parent_path() == dir);
+
+    std::filesystem::remove_all(dir);
+}
+
+auto should_build_at_unique_temporary_paths() -> void
+{
+    auto const output = temporary_cache_directory() / "shader.so";
+    auto const first = rgbctl::user_shader_temporary_path(output);
+    auto const second = rgbctl::user_shader_temporary_path(output);
+
+    EXPECT(first != second);
+    EXPECT(first.parent_path() == output.parent_path());
+    EXPECT(first.string().starts_with(output.string()));
+}
+
+auto should_swap_in_native_shader() -> void
+{
+    auto const dir = temporary_cache_directory();
+    rgbctl::NativeShaderCompiler compiler { dir };
+
+    auto slot = std::make_shared<rgbctl::ShaderSlot>();
+    compiler.compile(kSampleShader, slot);
+    compiler.wait();
+
+    if (slot->generation() == 0) {
+        std::filesystem::remove_all(dir);
+        throw rgbctl::testing::TestIgnored { "no system C compiler" };
+    }
+
+    auto const data = texture_data();
+    rgbctl::effects::User effect {
+        0, 1000, slot, { data.data(), data.size() }
+    };
+
+    std::array<rgbctl::RgbFloat, 4> result {};
+    EXPECT(effect.tick(0, { result.data(), result.size() }) == result.size());
+    EXPECT(is_rgb(result[0], 0xff, 0x00, 0x00));
+    EXPECT(is_rgb(result[1], 0x00, 0xff, 0x00));
+
+    std::filesystem::remove_all(dir);
+}
+
+auto should_keep_shader_if_native_compile_fails() -> void
+{
+    auto const dir = temporary_cache_directory();
+    rgbctl::NativeShaderCompiler compiler { dir };
+
+    auto slot = std::make_shared<rgbctl::ShaderSlot>();
+    compiler.compile("this isn't C", slot);
+    compiler.wait();
+
+    EXPECT(slot->generation() == 0);
+    EXPECT(!slot->acquire());
+
+    std::filesystem::remove_all(dir);
+}
+
+auto should_ignore_replacement_of_old_revision() -> void
+{
+    rgbctl::ShaderSlot slot;
+
+    auto const revision = slot.revision();
+    EXPECT(slot.replace(rgbctl::UserShader {}, revision));
+    EXPECT(slot.revision() == revision);
+
+    slot.publish(rgbctl::UserShader {});
+    EXPECT(slot.revision() != revision);
+    EXPECT(!slot.replace(rgbctl::UserShader {}, revision));
+    EXPECT(slot.generation() == 2);
+}
+
+auto write_file(std::filesystem::path const& path, char const* contents)
+    -> void
+{
+    std::ofstream file { path };
+    file << contents;
+}
+
+auto wait_for_reload(rgbctl::ShaderWatcher const& watcher) -> void
+{
+    using namespace std::chrono_literals;
+
+    for (auto n = 0; n < 500 && !watcher.reload_count(); ++n)
+        std::this_thread::sleep_for(10ms);
+
+    EXPECT(watcher.reload_count());
+}
+
+auto should_reload_saved_shader() -> void
+{
+    auto const dir = temporary_cache_directory();
+    std::filesystem::create_directories(dir);
+    auto const source = dir / "shader.c";
+    write_file(source, kConstantShader);
+
+    auto slot = std::make_shared<rgbctl::ShaderSlot>(
+        rgbctl::compile_user_shader_file(source));
+
+    rgbctl::ShaderWatcher watcher;
+    watcher.watch(source, slot);
+    write_file(source, kSampleShader);
+    wait_for_reload(watcher);
+
+    EXPECT(slot->generation() == 1);
+
+    auto const data = texture_data();
+    rgbctl::effects::User effect {
+        0, 1000, slot, { data.data(), data.size() }
+    };
+
+    std::array<rgbctl::RgbFloat, 4> result {};
+    EXPECT(effect.tick(0, { result.data(), result.size() }) == result.size());
+    EXPECT(is_rgb(result[1], 0x00, 0xff, 0x00));
+
+    std::filesystem::remove_all(dir);
+}
+
+auto should_keep_shader_if_reload_fails() -> void
+{
+    auto const dir = temporary_cache_directory();
+    std::filesystem::create_directories(dir);
+    auto const source = dir / "shader.c";
+    write_file(source, "");
+
+    auto slot = std::make_shared<rgbctl::ShaderSlot>();
+
+    rgbctl::ShaderWatcher watcher;
+    watcher.watch(source, slot);
+    write_file(dir / "other.c", "");
+    write_file(source, "this isn't C");
+    wait_for_reload(watcher);
+
+    EXPECT(watcher.reload_count() == 1);
+    EXPECT(slot->generation() == 0);
+    EXPECT(!slot->acquire());
+
+    std::filesystem::remove_all(dir);
+}
+
+auto main() -> int
+{
+    return rgbctl::testing::run({
+        TEST(should_sample_texture_n_like_single_samples),
+        TEST(should_run_shader_once_per_zone),
+        TEST(should_resize_with_zone),
+        TEST(should_reject_zero_duration),
+        TEST(should_fail_to_compile_invalid_shader),
+        TEST(should_fail_without_entry_point),
+        TEST(should_cache_compiled_shader),
+        TEST(should_key_cache_on_source),
+        TEST(should_build_at_unique_temporary_paths),
+        TEST(should_swap_in_native_shader),
+        TEST(should_keep_shader_if_native_compile_fails),
+        TEST(should_ignore_replacement_of_old_revision),
+        TEST(should_reload_saved_shader),
+        TEST(should_keep_shader_if_reload_fails),
+    });
+}